@@ -0,0 +1,41 @@
+#!/bin/bash
+# Gera as chaves de um cenário para o trust schema padrão (config/trust-schema.conf):
+# a autoridade /autoridade, com o certificado em config/trust-anchor.cert, e uma
+# identidade por nó, com o nome do nó, certificada por ela. Cada identidade vai
+# para config/keys/<nome>.safebag, cifrada com a senha de config/keys/password;
+# o entrypoint.sh importa a do contêiner na partida.
+#
+# Uso: config/make-keys.sh <cenário.yaml>   (precisa de ndnsec, yq e jq)
+set -e
+
+if [ -z "$1" ]; then
+  echo "Uso: $0 <cenário.yaml>"
+  exit 1
+fi
+CONFIG_FILE=$1
+CONFIG_DIR=$(cd "$(dirname "$0")" && pwd)
+KEYS_DIR="$CONFIG_DIR/keys"
+
+# PIB e TPM descartáveis, para não mexer nas chaves do usuário.
+export HOME=$(mktemp -d)
+trap 'rm -rf "$HOME"' EXIT
+
+mkdir -p "$KEYS_DIR"
+if [ ! -f "$KEYS_DIR/password" ]; then
+  head -c 32 /dev/urandom | base64 > "$KEYS_DIR/password"
+  chmod 600 "$KEYS_DIR/password"
+fi
+PASSWORD=$(cat "$KEYS_DIR/password")
+
+ndnsec key-gen -n /autoridade > /dev/null
+ndnsec cert-dump -i /autoridade > "$CONFIG_DIR/trust-anchor.cert"
+echo "Autoridade /autoridade gravada em $CONFIG_DIR/trust-anchor.cert."
+
+# Os mesmos nomes que o entrypoint.sh dá a cada papel.
+yq -o=json . "$CONFIG_FILE" | jq -r '"/central", ((.regions // [])[].prefix + "/_orch"), ((.aggregators // [])[].region + "/_agg"), .["traffic-lights"][].name' | while read -r NODE; do
+  ndnsec key-gen -n "$NODE" > /dev/null
+  ndnsec sign-req "$NODE" | ndnsec cert-gen -s /autoridade -i autoridade - | ndnsec cert-install -
+  FILE="$KEYS_DIR/$(echo "${NODE#/}" | tr '/' '.').safebag"
+  ndnsec export -P "$PASSWORD" -o "$FILE" -i "$NODE"
+  echo "  $NODE -> $FILE"
+done
@@ -13,7 +13,7 @@ else
 fi
 
 if [ -z "$ROLE" ]; then
-  echo "ERRO: A variável de ambiente ROLE deve ser definida ('orchestrator' ou 'trafficlight')."
+  echo "ERRO: A variável de ambiente ROLE deve ser definida ('orchestrator', 'region', 'trafficlight' ou 'aggregator')."
   exit 1
 fi
 
@@ -26,11 +26,13 @@ sleep 3
 
 if [ "$ROLE" == "orchestrator" ]; then
   ORCH_NDN_NAME="/central"
+  NODE_NAME="/central"
   CONFIG_FILE=$2
   
   echo "[$HOSTNAME] Lendo a configuração de semáforos de $CONFIG_FILE..."
 
-  yq -o=json . "$CONFIG_FILE" | jq -r '.["traffic-lights"] | to_entries[] | "trafficlight-\(.key) \(.value.name)"' | while read -r TL_CONTAINER TL_NDN_NAME; do
+  # Semáforos de uma região com orquestrador próprio falam com ele, não com /central.
+  yq -o=json . "$CONFIG_FILE" | jq -r '[(.regions // [])[].prefix + "/"] as $regions | .["traffic-lights"] | to_entries[] | select(.value.name as $n | $regions | all(. as $p | $n | startswith($p) | not)) | "trafficlight-\(.key) \(.value.name)"' | while read -r TL_CONTAINER TL_NDN_NAME; do
     echo "[$HOSTNAME] Configurando rota para: $TL_CONTAINER"
 
     FACE_ID=$(nfdc face create "udp://$TL_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
@@ -39,18 +41,94 @@ if [ "$ROLE" == "orchestrator" ]; then
   done
   echo "[$HOSTNAME] Configuração de rotas para todos os semáforos finalizada."
 
+  yq -o=json . "$CONFIG_FILE" | jq -r '(.aggregators // []) | to_entries[] | "aggregator-\(.key) \(.value.region)/_agg"' | while read -r AGG_CONTAINER AGG_NDN_NAME; do
+    FACE_ID=$(nfdc face create "udp://$AGG_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
+    nfdc route add "$AGG_NDN_NAME" nexthop "$FACE_ID"
+    echo "[$HOSTNAME]   Rota para $AGG_NDN_NAME via FaceID $FACE_ID criada."
+  done
+
+  yq -o=json . "$CONFIG_FILE" | jq -r '(.regions // []) | to_entries[] | "orchestrator-\(.key) \(.value.prefix)/_orch"' | while read -r REGION_CONTAINER REGION_NDN_NAME; do
+    FACE_ID=$(nfdc face create "udp://$REGION_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
+    nfdc route add "$REGION_NDN_NAME" nexthop "$FACE_ID"
+    echo "[$HOSTNAME]   Rota para $REGION_NDN_NAME via FaceID $FACE_ID criada."
+  done
+
+elif [ "$ROLE" == "region" ]; then
+  # orchestrator <cenário.yaml> <log_level> <id_regiao>
+  CONFIG_FILE=$2
+  REGION_INDEX=$4
+  REGION=$(yq -o=json . "$CONFIG_FILE" | jq -r ".regions[$REGION_INDEX].prefix")
+  NODE_NAME="$REGION/_orch"
+
+  echo "[$HOSTNAME] Configurando rotas para os semáforos sob $REGION..."
+
+  yq -o=json . "$CONFIG_FILE" | jq -r --arg region "$REGION/" '.["traffic-lights"] | to_entries[] | select(.value.name | startswith($region)) | "trafficlight-\(.key) \(.value.name)"' | while read -r TL_CONTAINER TL_NDN_NAME; do
+    FACE_ID=$(nfdc face create "udp://$TL_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
+    nfdc route add "$TL_NDN_NAME" nexthop "$FACE_ID"
+    echo "[$HOSTNAME]   Rota para $TL_NDN_NAME via FaceID $FACE_ID criada."
+  done
+
+  yq -o=json . "$CONFIG_FILE" | jq -r --arg region "$REGION" '(.aggregators // []) | to_entries[] | select(.value.region == $region or (.value.region | startswith($region + "/"))) | "aggregator-\(.key) \(.value.region)/_agg"' | while read -r AGG_CONTAINER AGG_NDN_NAME; do
+    FACE_ID=$(nfdc face create "udp://$AGG_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
+    nfdc route add "$AGG_NDN_NAME" nexthop "$FACE_ID"
+    echo "[$HOSTNAME]   Rota para $AGG_NDN_NAME via FaceID $FACE_ID criada."
+  done
+
+  FACE_ID=$(nfdc face create "udp://orchestrator" | awk -F'id=' '{print $2}' | awk '{print $1}')
+  nfdc route add "/central" nexthop "$FACE_ID"
+  echo "[$HOSTNAME]   Rota para /central via FaceID $FACE_ID criada."
+
 elif [ "$ROLE" == "trafficlight" ]; then
+  # trafficLight <cenário.yaml> <id_semaforo> <log_level>
+  CONFIG_FILE=$2
+  TL_INDEX=$3
   ORCH_CONTAINER="orchestrator"
   ORCH_NDN_NAME="/central"
 
+  TL_NAME=$(yq -o=json . "$CONFIG_FILE" | jq -r ".[\"traffic-lights\"][$TL_INDEX].name")
+  NODE_NAME="$TL_NAME"
+  REGION_ENTRY=$(yq -o=json . "$CONFIG_FILE" | jq -r --arg name "$TL_NAME" '(.regions // []) | to_entries[] | select($name | startswith(.value.prefix + "/")) | "\(.key) \(.value.prefix)"' | head -n 1)
+  if [ -n "$REGION_ENTRY" ]; then
+    read -r REGION_INDEX REGION_PREFIX <<< "$REGION_ENTRY"
+    ORCH_CONTAINER="orchestrator-$REGION_INDEX"
+    ORCH_NDN_NAME="$REGION_PREFIX/_orch"
+  fi
+
   echo "[$HOSTNAME] Configurando rota para o orquestrador..."
   
   FACE_ID=$(nfdc face create "udp://$ORCH_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
   nfdc route add "$ORCH_NDN_NAME" nexthop "$FACE_ID"
   echo "[$HOSTNAME]   Rota para $ORCH_NDN_NAME via FaceID $FACE_ID criada."
+
+elif [ "$ROLE" == "aggregator" ]; then
+  CONFIG_FILE=$2
+  AGG_INDEX=$3
+  REGION=$(yq -o=json . "$CONFIG_FILE" | jq -r ".aggregators[$AGG_INDEX].region")
+  NODE_NAME="$REGION/_agg"
+
+  echo "[$HOSTNAME] Configurando rotas para os semáforos sob $REGION..."
+
+  yq -o=json . "$CONFIG_FILE" | jq -r --arg region "$REGION/" '.["traffic-lights"] | to_entries[] | select(.value.name | startswith($region)) | "trafficlight-\(.key) \(.value.name)"' | while read -r TL_CONTAINER TL_NDN_NAME; do
+    FACE_ID=$(nfdc face create "udp://$TL_CONTAINER" | awk -F'id=' '{print $2}' | awk '{print $1}')
+    nfdc route add "$TL_NDN_NAME" nexthop "$FACE_ID"
+    echo "[$HOSTNAME]   Rota para $TL_NDN_NAME via FaceID $FACE_ID criada."
+  done
 fi
 
 echo "[$HOSTNAME] Configuração de rede finalizada."
+
+# Identidade do nó gerada por config/make-keys.sh, exigida pelo trust schema
+# padrão. Sem ela o nó assina com /app, que só config/trust-schema-any.conf aceita.
+NODE_SAFEBAG="/app/config/keys/$(echo "${NODE_NAME#/}" | tr '/' '.').safebag"
+if [ -f "$NODE_SAFEBAG" ]; then
+  if ! ndnsec cert-dump -i "$NODE_NAME" > /dev/null 2>&1; then
+    ndnsec import -P "$(cat /app/config/keys/password)" "$NODE_SAFEBAG"
+  fi
+  ndnsec set-default "$NODE_NAME"
+  echo "[$HOSTNAME] Assinando com a identidade $NODE_NAME."
+else
+  echo "[$HOSTNAME] AVISO: $NODE_SAFEBAG não existe; assinando com /app (rode config/make-keys.sh)."
+fi
 echo "[$HOSTNAME] Iniciando aplicação principal: $@"
 
 exec "$@"
\ No newline at end of file
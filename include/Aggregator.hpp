@@ -0,0 +1,121 @@
+#ifndef AGGREGATOR_HPP
+#define AGGREGATOR_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+
+#include "ProConInterface.hpp"
+#include "Structs.hpp"
+#include "LogLevel.hpp"
+#include "StatusCodec.hpp"
+#include "LinkSigner.hpp"
+#include "PacketVerifier.hpp"
+#include "PendingTable.hpp"
+#include "PollWheel.hpp"
+#include "RttEstimator.hpp"
+
+// =================================================================================
+// Agregador regional
+//
+// Consulta os semáforos sob uma região (ex.: /ssa/r-rodoviarios) e publica o estado
+// de todos eles em /<região>/_agg/<versão>/<segmento>. O orquestrador faz um único
+// Interest por região (CanBePrefix) em vez de um por semáforo; cada versão é
+// assinada uma vez e servida a todos os Interests que chegarem enquanto válida.
+// =================================================================================
+class Aggregator : public ndn::ProConInterface {
+public:
+  Aggregator();
+  ~Aggregator() override;
+
+  void setup(const std::string& region) override;
+  void loadConfig(const std::vector<std::pair<std::string, TrafficLightState>>& trafficLights,
+                  const ProtocolOptions& protocol, LogLevel level);
+  void run() override;
+
+protected:
+  void runProducer(const std::string& suffix) override;
+  void runConsumer() override;
+
+  void onInterest(const ndn::Interest& interest) override;
+  void onData(const ndn::Interest& interest, const ndn::Data& data) override;
+  void onNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) override;
+  void onTimeout(const ndn::Interest& interest) override;
+  void onRegisterFailed(const ndn::Name& prefix, const std::string& reason) override;
+
+  ndn::Interest createInterest(const ndn::Name& name, bool mustBeFresh, bool canBePrefix, ndn::time::milliseconds lifetime) override;
+  void sendInterest(const ndn::Interest& interest) override;
+
+private:
+  void pollTick();
+  void visitMember(LightId index);
+  void pollMember(LightId index);
+  void expressStatus(LightId index, ndn::Interest interest, bool retransmission);
+  void onStatusData(LightId index, uint32_t nonce, const ndn::Data& data);
+  void onStatusNack(LightId index, uint32_t nonce, const ndn::Interest& interest, const ndn::lp::Nack& nack);
+  void onStatusTimeout(LightId index, uint32_t nonce, const ndn::Interest& interest);
+  void acceptStatus(size_t index, const ndn::Data& data, int oneWayDelayMs);
+  void publishVersion();
+  void serveSegment(const ndn::Interest& interest, uint64_t version, size_t segment);
+  void log(LogLevel level, const std::string& message);
+
+private:
+  struct Member {
+    std::string name;
+    std::string suffix;                 // nome relativo à região
+    LinkSigner::LinkId link = 0;
+    status::StatusReport report;
+    Ticks receivedAt = 0;
+    int oneWayDelayMs = 0;
+    uint8_t timeouts = 0;
+    uint16_t pollPhase = 0;             // slot do semáforo no período de poll
+    RttEstimator rtt;                   // o lifetime do poll é o RTO do enlace
+  };
+
+  struct Version {
+    uint64_t number = 0;
+    Ticks builtAt = 0;
+    std::vector<std::shared_ptr<ndn::Data>> segments;
+  };
+
+  boost::asio::io_context m_ioCtx;
+  ndn::Face m_face{m_ioCtx};
+  ndn::KeyChain m_keyChain;
+  LinkSigner m_signer{m_keyChain};
+  LinkSigner::LinkId m_centralLink = 0;
+  ndn::ValidatorConfig m_validator{m_face};
+  PacketVerifier m_verifier{m_validator, m_signer};
+  ndn::Scheduler m_scheduler{m_ioCtx};
+  ndn::ScopedRegisteredPrefixHandle m_certServeHandle;
+  ndn::Name m_certPrefix;                 // /<identidade>/KEY
+
+  std::string m_region;
+  ndn::Name m_aggPrefix;
+  std::vector<Member> m_members;
+  std::unordered_map<std::string, size_t> m_memberIndex;   // só para a interface ProConInterface
+
+  // Polls em voo por membro e nonce, e a roda que os espalha pelo período.
+  PendingTable m_pending;
+  uint32_t m_nextNonce = 0;
+  PollWheel m_pollWheel;
+  std::chrono::steady_clock::time_point m_pollTickDue;
+  ndn::scheduler::ScopedEventId m_pollTickEvent;
+
+  // Versão atual e a anterior, para não invalidar uma busca de segmentos em andamento.
+  Version m_current;
+  Version m_previous;
+
+  LogLevel m_logLevel = LogLevel::NONE;
+
+  static constexpr ndn::time::milliseconds AGGREGATE_FRESHNESS{500};
+  static constexpr int REBUILD_INTERVAL_MS = 500;
+  static constexpr uint8_t TIMEOUT_THRESHOLD = 2;
+  static constexpr int STATUS_IN_FLIGHT = 2;
+  static constexpr int POLL_SLOT_MS = 10;
+  static constexpr int POLL_PERIOD_MS = 1000;
+  static constexpr int POLL_RECONTACT_MS = 5000;   // semáforo que parou de responder
+};
+
+#endif // AGGREGATOR_HPP
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Instantes do plano de controle em milissegundos do steady_clock.
+using Ticks = int64_t;
+
+// Relógio virtual da simulação (include/Simulation.hpp): enquanto ligado, o
+// tempo do plano de controle só anda quando o simulador o avança, e o
+// steady_clock da ndn-cxx lê o mesmo valor. É por thread, pois cada simulação
+// roda inteira numa thread e várias podem rodar lado a lado. Fora da simulação
+// fica desligado e tudo lê o steady_clock do sistema. Medidas de custo de CPU
+// continuam no relógio real.
+namespace sim {
+
+inline thread_local int64_t virtualNowNs = -1;   // -1: desligado
+
+inline bool virtualTime() {
+    return virtualNowNs >= 0;
+}
+
+inline void setVirtualTime(std::chrono::nanoseconds now) {
+    virtualNowNs = now.count();
+}
+
+} // namespace sim
+
+inline std::chrono::steady_clock::time_point steadyNow() {
+    const int64_t virtualNs = sim::virtualNowNs;
+    if (virtualNs < 0) {
+        return std::chrono::steady_clock::now();
+    }
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(virtualNs)));
+}
+
+inline Ticks nowTicks() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(steadyNow().time_since_epoch()).count();
+}
@@ -0,0 +1,132 @@
+#ifndef CLOCKSYNC_HPP
+#define CLOCKSYNC_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "Clock.hpp"
+
+// Estimador do relógio de um par remoto, como o do NTP: cada troca dá quatro
+// instantes, t1 (envio, local), t2 (recepção, remoto), t3 (resposta, remoto) e
+// t4 (recepção da resposta, local), de onde saem
+//
+//   offset = ((t2 - t1) + (t3 - t4)) / 2      remoto - local
+//   delay  = (t4 - t1) - (t3 - t2)            ida e volta na rede
+//
+// O tempo que o remoto reteve a mensagem (t3 - t2) não entra no delay, então o
+// long-poll de comandos serve de amostra. Das últimas WINDOW amostras vale a de
+// menor delay, a menos afetada por fila; o erro do offset é no máximo metade
+// desse delay. O desvio de frequência (skew) é a inclinação dos offsets das
+// amostras de delay baixo ao longo do tempo, por mínimos quadrados, e extrapola o
+// offset entre as amostras. Não é thread-safe.
+class ClockSync {
+public:
+  static constexpr size_t WINDOW = 16;
+  static constexpr Ticks MIN_SKEW_SPAN_MS = 20000;   // base mínima para estimar o skew
+  static constexpr double MAX_SKEW_PPM = 500.0;      // além disso é ruído, não relógio
+  static constexpr int UNSYNCED = -1;
+
+  void addSample(Ticks t1, Ticks t2, Ticks t3, Ticks t4) {
+    const Ticks delay = (t4 - t1) - (t3 - t2);
+    if (delay < 0) {
+      return;   // instantes inconsistentes (resposta a outro Interest)
+    }
+    Sample& sample = m_samples[m_next];
+    sample.local = t1 + (t4 - t1) / 2;
+    sample.offset = ((t2 - t1) + (t3 - t4)) / 2.0;
+    sample.delay = delay;
+    m_next = (m_next + 1) % WINDOW;
+    m_count++;
+    update();
+  }
+
+  bool synchronized() const { return m_count > 0; }
+  uint64_t sampleCount() const { return m_count; }
+
+  // Offset (remoto - local) no instante local `now`.
+  double offsetAt(Ticks now) const {
+    return m_best.offset + m_skew * static_cast<double>(now - m_best.local);
+  }
+
+  Ticks toLocal(Ticks remote, Ticks now) const {
+    return remote - static_cast<Ticks>(std::llround(offsetAt(now)));
+  }
+
+  Ticks toRemote(Ticks local) const {
+    return local + static_cast<Ticks>(std::llround(offsetAt(local)));
+  }
+
+  // Limite do erro do offset em `now`: metade do menor delay, mais o que o skew
+  // pode ter errado desde aquela amostra. UNSYNCED sem amostras.
+  int errorBoundMs(Ticks now) const {
+    if (m_count == 0) {
+      return UNSYNCED;
+    }
+    const double drift = std::abs(m_skewError * static_cast<double>(now - m_best.local));
+    return static_cast<int>(std::ceil(m_best.delay / 2.0 + drift));
+  }
+
+  double skewPpm() const { return m_skew * 1e6; }
+  Ticks minDelayMs() const { return m_count ? m_best.delay : 0; }
+
+private:
+  struct Sample {
+    Ticks local = 0;       // meio da troca, no relógio local
+    double offset = 0.0;
+    Ticks delay = 0;
+  };
+
+  void update() {
+    const size_t stored = std::min<uint64_t>(m_count, WINDOW);
+    const Sample* best = &m_samples[0];
+    for (size_t i = 1; i < stored; ++i) {
+      if (m_samples[i].delay < best->delay) {
+        best = &m_samples[i];
+      }
+    }
+    m_best = *best;
+
+    // Skew pelas amostras com delay perto do mínimo; as demais carregam fila.
+    const Ticks cutoff = 2 * m_best.delay + 2;
+    double n = 0.0, sumX = 0.0, sumY = 0.0;
+    Ticks first = std::numeric_limits<Ticks>::max(), last = std::numeric_limits<Ticks>::min();
+    for (size_t i = 0; i < stored; ++i) {
+      if (m_samples[i].delay <= cutoff) {
+        n += 1.0;
+        sumX += static_cast<double>(m_samples[i].local - m_best.local);
+        sumY += m_samples[i].offset;
+        first = std::min(first, m_samples[i].local);
+        last = std::max(last, m_samples[i].local);
+      }
+    }
+    if (n < 4.0 || last - first < MIN_SKEW_SPAN_MS) {
+      return;   // mantém a estimativa anterior
+    }
+    const double meanX = sumX / n, meanY = sumY / n;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < stored; ++i) {
+      if (m_samples[i].delay <= cutoff) {
+        const double dx = static_cast<double>(m_samples[i].local - m_best.local) - meanX;
+        sxx += dx * dx;
+        sxy += dx * (m_samples[i].offset - meanY);
+      }
+    }
+    const double limit = MAX_SKEW_PPM * 1e-6;
+    m_skew = std::clamp(sxy / sxx, -limit, limit);
+    // Incerteza da inclinação: erro de offset de cada amostra sobre a base.
+    m_skewError = std::min(limit, (cutoff / 2.0) / static_cast<double>(last - first));
+  }
+
+  std::array<Sample, WINDOW> m_samples{};
+  size_t m_next = 0;
+  uint64_t m_count = 0;
+  Sample m_best;
+  double m_skew = 0.0;          // d(offset)/d(local)
+  double m_skewError = MAX_SKEW_PPM * 1e-6;   // antes de estimar o skew
+};
+
+#endif // CLOCKSYNC_HPP
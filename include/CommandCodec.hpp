@@ -0,0 +1,118 @@
+#ifndef COMMANDCODEC_HPP
+#define COMMANDCODEC_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "Clock.hpp"
+#include "Enums.hpp"
+#include "PhaseModel.hpp"
+
+// =================================================================================
+// Comandos do orquestrador para o semáforo (resposta a /central/command/<semáforo>)
+//
+// CommandList = COMMAND-LIST-TYPE TLV-LENGTH
+//               Sequence (8 B)             número de sequência do lote, big-endian
+//               [ReceiveTime (8 B)]        chegada do Interest ao orquestrador (t2)
+//               [TransmitTime (8 B)]       envio da resposta pelo orquestrador (t3)
+//               *Command (1 B op + 4 B)    opcode e operando com sinal, big-endian
+//               [PhasePlan]                as próximas fases (PhaseModel.hpp)
+//
+// PhasePlan   = PHASE-PLAN-TYPE TLV-LENGTH *PlanEntry
+// PlanEntry   = PLAN-ENTRY-TYPE 5 Color (1 B) End (4 B, com sinal, relativo a TransmitTime)
+//
+// Os instantes são ms do relógio do orquestrador; com o envio (t1) e a chegada
+// (t4) do Interest de comando, o semáforo estima o offset do seu relógio
+// (ClockSync.hpp). O operando de SET_PHASE_END e os fins de fase do plano vão
+// no fio relativos a TransmitTime e voltam a ser absolutos na decodificação.
+//
+// Um conteúdo vazio significa "nenhum comando"; o orquestrador responde com uma
+// lista sem comandos e sequência 0 para entregar só os instantes. O semáforo
+// descarta lotes com sequência menor ou igual à do último lote aplicado.
+// =================================================================================
+enum class CommandOp : uint8_t {
+  NONE = 0,
+  SET_STATE,                 // operando: Color
+  SET_TIME,                  // duração da cor atual (s)
+  SET_TIME_DEFAULT,          // duração padrão da cor atual
+  SET_DEFAULT_DURATION,      // restaura todas as durações padrão
+  SET_GREEN_DURATION,        // ms
+  SET_RED_DURATION,          // ms
+  INCREASE_GREEN_DURATION,   // ms
+  DECREASE_GREEN_DURATION,   // ms
+  INCREASE_RED_DURATION,     // ms
+  DECREASE_RED_DURATION,     // ms
+  SET_CURRENT_TIME,          // ms restantes na cor atual
+  INCREASE_TIME,             // ms
+  DECREASE_TIME,             // ms
+  SET_PHASE_END,             // fim da cor atual, instante absoluto no relógio do orquestrador (ms)
+  COUNT
+};
+
+struct Command {
+  CommandOp op = CommandOp::NONE;
+  int64_t value = 0;         // só SET_PHASE_END passa da faixa de 32 bits
+};
+
+// Lote de comandos de capacidade fixa, montado pelo orquestrador a cada ciclo.
+struct CommandBatch {
+  static constexpr size_t CAPACITY = 24;
+
+  uint64_t sequence = 0;
+  Ticks receivedAt = 0;      // t2; 0 = ausente
+  Ticks sentAt = 0;          // t3; 0 = ausente
+  std::array<Command, CAPACITY> items{};
+  uint8_t count = 0;
+  phase::Plan plan;          // vazio = o semáforo mantém o plano que tem
+
+  bool empty() const { return count == 0 && plan.empty(); }
+  void clear() {
+    count = 0;
+    plan.clear();
+  }
+  bool push(CommandOp op, int64_t value = 0) {
+    if (count == CAPACITY) return false;
+    items[count++] = {op, value};
+    return true;
+  }
+  bool push(CommandOp op, Color color) { return push(op, static_cast<int64_t>(color)); }
+
+  const Command* begin() const { return items.data(); }
+  const Command* end() const { return items.data() + count; }
+};
+
+namespace command {
+
+namespace tlv {
+  constexpr uint8_t CommandList = 210;
+  constexpr uint8_t Sequence = 211;
+  constexpr uint8_t Command = 212;
+  constexpr uint8_t ReceiveTime = 215;
+  constexpr uint8_t TransmitTime = 216;
+  constexpr uint8_t PhasePlan = 219;
+  constexpr uint8_t PlanEntry = 220;
+}
+
+constexpr size_t MAX_WIRE_SIZE = 2 + (2 + 8) + 2 * (2 + 8) + CommandBatch::CAPACITY * (2 + 5) +
+                                 2 + phase::Plan::CAPACITY * (2 + 5);
+static_assert(MAX_WIRE_SIZE - 2 < 253, "o TLV-LENGTH da lista ocupa um byte");
+using CommandBuffer = std::array<uint8_t, MAX_WIRE_SIZE>;
+
+// Codifica sem alocação; retorna o número de bytes escritos.
+size_t encode(const CommandBatch& batch, CommandBuffer& out);
+
+// Decodifica direto dos bytes do conteúdo; opcodes desconhecidos são ignorados,
+// assim como SET_PHASE_END e planos sem TransmitTime.
+std::optional<CommandBatch> decode(std::span<const uint8_t> wire);
+
+const char* opName(CommandOp op);
+
+// Representação legível (";set_state:RED;set_current_time:5000") para os logs.
+std::string toString(const CommandBatch& batch);
+
+} // namespace command
+
+#endif // COMMANDCODEC_HPP
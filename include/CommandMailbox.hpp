@@ -0,0 +1,52 @@
+#ifndef COMMANDMAILBOX_HPP
+#define COMMANDMAILBOX_HPP
+
+#include <atomic>
+#include <memory>
+
+#include "CommandCodec.hpp"
+
+// Comandos de um semáforo ainda não entregues, passados do motor de regras para a
+// thread de I/O sem locks. O lote pendente vive num ponteiro atômico: quem o
+// retira com exchange passa a ser seu único dono.
+//
+// Motor: publish(), discard(), pending().  I/O: take().
+class CommandMailbox {
+public:
+  CommandMailbox() = default;
+  CommandMailbox(const CommandMailbox&) = delete;
+  CommandMailbox& operator=(const CommandMailbox&) = delete;
+  ~CommandMailbox() { delete m_slot.load(std::memory_order_relaxed); }
+
+  // Acrescenta `batch` ao lote ainda não retirado. Enquanto o motor junta os dois,
+  // a caixa fica vazia e take() não retorna nada; o lote volta completo em seguida.
+  // Operações além de CommandBatch::CAPACITY são descartadas, como em push(), e
+  // um plano novo substitui o que estava na caixa.
+  void publish(const CommandBatch& batch) {
+    std::unique_ptr<CommandBatch> merged(m_slot.exchange(nullptr, std::memory_order_acq_rel));
+    if (!merged) {
+      merged = std::make_unique<CommandBatch>();
+    }
+    for (const Command& command : batch) {
+      merged->push(command.op, command.value);
+    }
+    if (!batch.plan.empty()) {
+      merged->plan = batch.plan;
+    }
+    m_slot.store(merged.release(), std::memory_order_release);
+  }
+
+  // Descarta o lote ainda não retirado.
+  void discard() { delete m_slot.exchange(nullptr, std::memory_order_acq_rel); }
+
+  bool pending() const { return m_slot.load(std::memory_order_acquire) != nullptr; }
+
+  std::unique_ptr<CommandBatch> take() {
+    return std::unique_ptr<CommandBatch>(m_slot.exchange(nullptr, std::memory_order_acq_rel));
+  }
+
+private:
+  std::atomic<CommandBatch*> m_slot{nullptr};
+};
+
+#endif // COMMANDMAILBOX_HPP
@@ -0,0 +1,48 @@
+#ifndef DEADLINEQUEUE_HPP
+#define DEADLINEQUEUE_HPP
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "Clock.hpp"
+
+// Prazos do motor por eventos, em min-heap por instante. Um prazo que mudou não é
+// removido: a entrada antiga continua na fila e quem a consome confere se ela
+// ainda vale (ex.: endTime do semáforo igual a `due`).
+class DeadlineQueue {
+public:
+  enum class Kind : uint8_t {
+    PHASE_END,          // target = LightId: fim previsto da fase atual
+    ALL_RED_TIMEOUT,    // target = GroupId do cruzamento todo em vermelho
+  };
+
+  struct Entry {
+    Ticks due;
+    Kind kind;
+    uint32_t target;
+  };
+
+  void push(Ticks due, Kind kind, uint32_t target) { m_heap.push({due, kind, target}); }
+
+  bool empty() const { return m_heap.empty(); }
+  size_t size() const { return m_heap.size(); }
+  Ticks nextDue() const { return m_heap.top().due; }
+
+  // Remove a entrada mais próxima; só pode ser chamada com a fila não vazia.
+  Entry pop() {
+    Entry entry = m_heap.top();
+    m_heap.pop();
+    return entry;
+  }
+
+  void clear() { m_heap = {}; }
+
+private:
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const { return a.due > b.due; }
+  };
+  std::priority_queue<Entry, std::vector<Entry>, Later> m_heap;
+};
+
+#endif // DEADLINEQUEUE_HPP
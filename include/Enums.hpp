@@ -1,11 +1,12 @@
 #ifndef ENUMS_HPP
 #define ENUMS_HPP
 
+#include <cstdint>
 #include <string>
 
 enum class Status { NONE = 1, LOW = 2, MEDIUM = 5, HIGH = 8 };
 
-enum class Color {
+enum class Color : uint8_t {
     GREEN,
     YELLOW,
     RED,
@@ -17,6 +18,7 @@ inline Color parseColor(const std::string& str) {
     if (str == "GREEN") return Color::GREEN;
     if (str == "YELLOW") return Color::YELLOW;
     if (str == "RED") return Color::RED;
+    if (str == "UNKNOWN") return Color::UNKNOWN;
     return Color::ALERT;  
 }
 
@@ -30,6 +32,23 @@ inline std::string ToString(Color color) {
     }
 }
 
+// POLL: o orquestrador pergunta o estado a cada semáforo todo segundo.
+// PUSH: o semáforo notifica mudanças de fase/prioridade e um heartbeat lento.
+// PREDICT: como PUSH, mas trocas de fase previstas pelo modelo de fases comum
+// (PhaseModel.hpp) não são notificadas; só desvios da previsão.
+enum class StatusMode : uint8_t { POLL, PUSH, PREDICT };
+
+// Assinatura dos pacotes de estado e de comando.
+// ASYMMETRIC: certificado da identidade padrão (comportamento original).
+// HMAC: HMAC-SHA256 com uma chave por enlace, derivada de um segredo compartilhado.
+// DIGEST: apenas DigestSha256, para enlaces locais confiáveis.
+enum class SigningMode : uint8_t { ASYMMETRIC, HMAC, DIGEST };
+
+// Motor de regras do orquestrador.
+// TICK: reavalia todos os grupos a cada segundo numa thread própria (comportamento original).
+// EVENT: reavalia só os grupos afetados, quando chega um estado novo ou vence um prazo.
+enum class EngineMode : uint8_t { TICK, EVENT };
+
 inline Status parseIntensity(const std::string& str) {
     if (str == "LOW") return Status::LOW;
     if (str == "MEDIUM") return Status::MEDIUM;
@@ -0,0 +1,81 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// Histograma de latências em microssegundos com baldes de potência de 2: o balde
+// b conta amostras com std::bit_width(us) == b, ou seja, [2^(b-1), 2^b) µs, e o
+// último acumula o resto. Não é thread-safe.
+class LatencyHistogram {
+public:
+  static constexpr size_t BUCKETS = 24;   // até ~8 s
+
+  void record(uint64_t us) {
+    m_buckets[std::min<size_t>(std::bit_width(us), BUCKETS - 1)]++;
+    m_count++;
+    m_max = std::max(m_max, us);
+  }
+
+  uint64_t count() const { return m_count; }
+  uint64_t max() const { return m_max; }
+
+  // Limite superior do balde que contém o quantil q (0 a 1), limitado ao máximo visto.
+  uint64_t percentile(double q) const {
+    if (m_count == 0) {
+      return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * m_count)));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+      seen += m_buckets[b];
+      if (seen >= rank) {
+        return std::min(m_max, (uint64_t{1} << b) - 1);
+      }
+    }
+    return m_max;
+  }
+
+  void reset() { *this = LatencyHistogram{}; }
+
+  uint64_t bucket(size_t b) const { return m_buckets[b]; }
+
+  // Acrescenta `count` amostras ao balde b, por exemplo de um histograma recebido
+  // pela rede; `max` é o maior valor entre elas.
+  void addBucket(size_t b, uint64_t count, uint64_t max) {
+    m_buckets[std::min(b, BUCKETS - 1)] += count;
+    m_count += count;
+    if (count > 0) {
+      m_max = std::max(m_max, max);
+    }
+  }
+
+private:
+  std::array<uint64_t, BUCKETS> m_buckets{};
+  uint64_t m_count = 0;
+  uint64_t m_max = 0;
+};
+
+// Registra no histograma o tempo entre a construção e a destruição.
+class ScopedLatency {
+public:
+  explicit ScopedLatency(LatencyHistogram& histogram)
+    : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() {
+    m_histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_start).count()));
+  }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+  LatencyHistogram& m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // LATENCYHISTOGRAM_HPP
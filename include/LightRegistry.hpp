@@ -0,0 +1,62 @@
+#ifndef LIGHTREGISTRY_HPP
+#define LIGHTREGISTRY_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Structs.hpp"
+
+// Identificadores densos: índices diretos nos vetores do orquestrador.
+using LightId = uint32_t;
+using GroupId = int32_t;
+
+constexpr LightId INVALID_LIGHT = std::numeric_limits<LightId>::max();
+constexpr GroupId NO_GROUP = -1;
+
+// Registro construído uma única vez em loadConfig(). Converte nomes NDN em IDs
+// e guarda as relações semáforo -> cruzamento/onda/grupo como arrays de inteiros,
+// para que o ciclo do orquestrador não faça nenhuma comparação de strings.
+class LightRegistry {
+public:
+  void build(const std::vector<std::string>& lightNames,
+             const std::vector<Intersection>& intersections,
+             const std::vector<GreenWaveGroup>& greenWaves,
+             const std::vector<SyncGroup>& syncGroups);
+
+  LightId find(const std::string& name) const;
+  const std::string& nameOf(LightId id) const { return names_[id]; }
+  size_t lightCount() const { return names_.size(); }
+  size_t intersectionCount() const { return intersectionMembers_.size(); }
+  size_t waveCount() const { return waveMembers_.size(); }
+  size_t syncGroupCount() const { return syncGroupMembers_.size(); }
+
+  GroupId intersectionOf(LightId id) const { return intersectionOf_[id]; }
+  GroupId waveOf(LightId id) const { return waveOf_[id]; }
+  GroupId syncGroupOf(LightId id) const { return syncGroupOf_[id]; }
+  LightId competitorOf(LightId id) const { return competitorOf_[id]; }
+
+  const std::vector<LightId>& intersectionMembers(GroupId group) const { return intersectionMembers_[group]; }
+  const std::vector<LightId>& waveMembers(GroupId group) const { return waveMembers_[group]; }
+  const std::vector<LightId>& syncGroupMembers(GroupId group) const { return syncGroupMembers_[group]; }
+
+private:
+  std::vector<LightId> resolve(const std::vector<std::string>& names) const;
+
+private:
+  std::unordered_map<std::string, LightId> ids_;
+  std::vector<std::string> names_;
+
+  std::vector<GroupId> intersectionOf_;
+  std::vector<GroupId> waveOf_;
+  std::vector<GroupId> syncGroupOf_;
+  std::vector<LightId> competitorOf_;
+
+  std::vector<std::vector<LightId>> intersectionMembers_;
+  std::vector<std::vector<LightId>> waveMembers_;
+  std::vector<std::vector<LightId>> syncGroupMembers_;
+};
+
+#endif // LIGHTREGISTRY_HPP
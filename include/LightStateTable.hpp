@@ -0,0 +1,64 @@
+#ifndef LIGHTSTATETABLE_HPP
+#define LIGHTSTATETABLE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <boost/dynamic_bitset.hpp>
+
+#include "Clock.hpp"
+#include "Enums.hpp"
+#include "LightRegistry.hpp"
+
+// Estado quente do orquestrador em layout struct-of-arrays, indexado por LightId.
+// Cada laço do ciclo percorre apenas os arrays de que precisa, em memória contígua.
+class LightStateTable {
+public:
+  void resize(size_t count);
+  size_t size() const { return color.size(); }
+
+  // Média das prioridades de todos os semáforos, a partir da soma corrente.
+  float averagePriority() const;
+  double prioritySum() const { return m_prioritySum; }
+
+  // Única forma de escrever em `priority`: mantém a soma usada pela média.
+  void setPriority(LightId id, float value) {
+    m_prioritySum += static_cast<double>(value) - priority[id];
+    priority[id] = value;
+  }
+
+  // trend[i] = +1 se a prioridade está acima da média, -1 se abaixo, 0 se igual.
+  void classifyPriorities(float average, std::vector<int8_t>& trend) const;
+
+  // active[g] = true se algum membro do cruzamento g está em VERDE ou AMARELO.
+  void detectActiveIntersections(const LightRegistry& registry, size_t intersectionCount,
+                                 boost::dynamic_bitset<uint64_t>& active) const;
+
+  bool isActive(LightId id) const { return color[id] == Color::GREEN || color[id] == Color::YELLOW; }
+  int remainingMs(LightId id, Ticks now) const { return static_cast<int>(endTime[id] - now); }
+
+public:
+  std::vector<Color> color;
+  std::vector<Ticks> endTime;
+  std::vector<float> priority;         // escrita via setPriority()
+  std::vector<uint16_t> queueLength;
+
+  // Mantidos pela thread de I/O do orquestrador; o motor de regras não os lê.
+  std::vector<uint8_t> timeoutCounter;
+  std::vector<uint64_t> statusSeq;
+  std::vector<Ticks> lastReport;       // instante do último estado recebido (poll ou push)
+
+  // Histerese de ajuste de prioridade: contador e direção (1 = ganhando tempo).
+  // Em bytes porque shards diferentes os escrevem em paralelo.
+  std::vector<int8_t> adjustCount;
+  std::vector<uint8_t> adjustGaining;
+
+  boost::dynamic_bitset<uint64_t> partOfIntersection;
+  boost::dynamic_bitset<uint64_t> partOfGreenWave;
+  boost::dynamic_bitset<uint64_t> partOfSyncGroup;
+
+private:
+  double m_prioritySum = 0.0;
+  mutable std::vector<uint8_t> activeScratch_;
+};
+
+#endif // LIGHTSTATETABLE_HPP
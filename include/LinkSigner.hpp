@@ -0,0 +1,90 @@
+#ifndef LINKSIGNER_HPP
+#define LINKSIGNER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-info.hpp>
+
+#include "Enums.hpp"
+
+// =================================================================================
+// Política de assinatura por enlace
+//
+// Cada par (orquestrador, semáforo) ou (orquestrador, região) é um enlace. No modo
+// HMAC a chave do enlace é SHA-256(segredo || 0x00 || nome do par), calculada na
+// partida pelos dois lados a partir do segredo em `protocol.hmac_secret_file`,
+// sem troca de mensagens. Nos outros modos todos os enlaces assinam igual.
+// =================================================================================
+class LinkSigner {
+public:
+  using LinkId = uint32_t;
+
+  explicit LinkSigner(ndn::KeyChain& keyChain);
+
+  // Lança std::runtime_error se o modo é HMAC e o segredo não pode ser lido.
+  void configure(SigningMode mode, const std::string& secretFile);
+
+  // Registra o enlace com `peer` (nome NDN) e retorna seu identificador,
+  // atribuído em ordem a partir de 0.
+  LinkId addLink(const std::string& peer);
+
+  void sign(ndn::Data& data, LinkId link);
+  void sign(ndn::Interest& interest, LinkId link);
+
+  // Verificação local dos modos HMAC e DIGEST; no modo ASYMMETRIC quem verifica é
+  // o Validator, e estas funções retornam false.
+  bool verify(const ndn::Data& data, LinkId link) const;
+  bool verify(const ndn::Interest& interest, LinkId link) const;
+
+  SigningMode mode() const { return m_mode; }
+  const ndn::security::SigningInfo& signingInfo(LinkId link) const;
+
+private:
+  ndn::KeyChain& m_keyChain;
+  ndn::KeyChain m_hmacKeyChain{"pib-memory:", "tpm-memory:"};   // chaves HMAC ficam fora do TPM do usuário
+  SigningMode m_mode = SigningMode::ASYMMETRIC;
+  std::string m_secret;
+  ndn::security::SigningInfo m_shared;                    // ASYMMETRIC e DIGEST
+  std::vector<ndn::security::SigningInfo> m_links;        // HMAC, indexado por LinkId
+};
+
+// Último Data assinado por nome, com a chave que o produtor deu ao conteúdo.
+// Enquanto a chave não muda e o Data ainda está dentro do período de frescor, o
+// mesmo pacote (com o wire encoding já calculado) é reenviado sem nova
+// assinatura. A chave pode deixar de fora campos que mudam a cada consulta, como
+// o tempo restante da fase, que então envelhecem até um período de frescor, como
+// no Content Store. Poucos nomes por produtor: busca linear.
+class SignedDataCache {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit SignedDataCache(size_t capacity = 8) : m_capacity(capacity) {}
+
+  std::shared_ptr<const ndn::Data> find(const ndn::Name& name, std::span<const uint8_t> key,
+                                        Clock::time_point now);
+  void insert(std::shared_ptr<const ndn::Data> data, std::span<const uint8_t> key, Clock::time_point now);
+
+  uint64_t hits() const { return m_hits; }
+  uint64_t misses() const { return m_misses; }
+
+private:
+  struct Entry {
+    std::shared_ptr<const ndn::Data> data;
+    std::vector<uint8_t> key;
+    Clock::time_point expiry;
+  };
+  std::vector<Entry> m_entries;
+  size_t m_capacity;
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+};
+
+#endif // LINKSIGNER_HPP
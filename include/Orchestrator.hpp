@@ -5,14 +5,34 @@
 // Arquivo de Configuração
 // =================================================================================
 namespace config {
-  constexpr int INCREASE_GREEN_MS = 5000;
-  constexpr int DECREASE_RED_MS = 3000;
   constexpr float MIN_PRIORITY = 20.0;
   constexpr int YELLOW_TIME_MS = 3000;
-  constexpr int GREEN_BASE_TIME_MS = 15000;
-  constexpr int RTT_WINDOW_SIZE = 10;
-  constexpr int RECOVERY_RED_TIME_MS = 5000; 
-  constexpr double LOW_PRIORITY_WAVE_FACTOR = 0.75; 
+  constexpr int COMMAND_HOLD_MARGIN_MS = 250;   // antecedência da resposta vazia a um Interest retido
+  constexpr double HEARTBEAT_MISS_FACTOR = 2.5; // heartbeats perdidos até o semáforo ser dado como inalcançável
+  constexpr int STATUS_TRAFFIC_WINDOW_CYCLES = 10;
+  constexpr int AGGREGATE_FAILURE_THRESHOLD = 2;     // falhas até voltar ao poll individual
+  constexpr int ALL_RED_TIMEOUT_MS = 5000;           // cruzamento todo em vermelho até forçar um ciclo
+  constexpr int PRIORITY_PASS_MS = 1000;             // período dos ajustes de prioridade no motor por eventos
+  constexpr int END_TIME_TOLERANCE_MS = 500;         // desvio de endTime que conta como estado novo
+  constexpr int SHARDS_PER_WORKER = 4;               // folga para o roubo de trabalho entre workers
+  constexpr int RELAY_INTEREST_LIFETIME_MS = 4000;   // Interest de comando repassado à cidade, como o do semáforo
+  constexpr int RELAY_RETRY_MS = 1000;               // espera após um Nack da cidade
+  constexpr int SUMMARY_FRESHNESS_MS = 500;
+  constexpr int STATUS_IN_FLIGHT = 2;                // Interests de estado em voo por semáforo
+  // Poll espaçado: cada semáforo tem uma fase fixa no período, numa roda de tempo.
+  constexpr int POLL_SLOT_MS = 10;
+  constexpr int POLL_PERIOD_MS = 1000;
+  constexpr int POLL_FAST_MS = 250;                  // fase perto do fim
+  constexpr int POLL_SLOW_MS = 2000;                 // meio de uma fase longa
+  constexpr int POLL_NEAR_END_MS = 2000;             // restante abaixo disto: poll rápido
+  constexpr int POLL_MID_PHASE_MS = 6000;            // restante acima disto: poll lento
+  constexpr int POLL_RECONTACT_MS = 5000;            // semáforo inalcançável
+  // Planos de fase: o semáforo recebe as próximas fases, não ajustes incrementais.
+  constexpr int PLAN_REFRESH_PHASES = 3;             // fases restantes abaixo disto: plano novo
+  constexpr int MIN_PLANNED_PHASE_MS = 5000;         // piso dos ajustes de verde e vermelho
+  constexpr int ALERT_RECOVERY_RED_MS = 15000;       // vermelho ao sair do ALERTA
+  constexpr int PHASE_TIMING_FETCH_MS = 60000;       // consulta do atraso das trocas de fase
+  constexpr int CERT_FETCH_LIFETIME_MS = 2000;       // busca do certificado de um semáforo na partida
 
 }
 
@@ -23,7 +43,6 @@ namespace config {
 #include <vector>
 #include <map>
 #include <unordered_map>
-#include <mutex>
 #include <thread> 
 #include <atomic> 
 #include <chrono> 
@@ -31,6 +50,7 @@ namespace config {
 #include <cstddef>
 #include <fstream>
 #include <numeric>
+#include <memory>
 
 // =================================================================================
 // Includes da Biblioteca NDN-CXX
@@ -50,10 +70,28 @@ namespace config {
 #include "ProConInterface.hpp" 
 #include "Structs.hpp"   
 #include "LogLevel.hpp"       
+#include "LightRegistry.hpp"
+#include "LightStateTable.hpp"
+#include "StatusCodec.hpp"
+#include "LinkSigner.hpp"
+#include "PacketVerifier.hpp"
+#include "DeadlineQueue.hpp"
+#include "SpscRing.hpp"
+#include "CommandMailbox.hpp"
+#include "LatencyHistogram.hpp"
+#include "RttEstimator.hpp"
+#include "PendingTable.hpp"
+#include "PollWheel.hpp"
+#include "PhaseModel.hpp"
+#include "ClockSync.hpp"
+#include "ShardPartition.hpp"
+#include "ShardPool.hpp"
 
 class Orchestrator : public ndn::ProConInterface {
 public:
   Orchestrator();
+  // Face e KeyChain do chamador, como os DummyClientFace do simulador.
+  Orchestrator(ndn::Face& face, ndn::KeyChain& keyChain);
   ~Orchestrator() override;
 
   Orchestrator(const Orchestrator&) = delete;
@@ -63,9 +101,20 @@ public:
                     const std::map<std::string, Intersection>& intersections,
                     const std::vector<GreenWaveGroup>& greenWaves,
                     const std::vector<SyncGroup>& syncGroups,
+                    const std::vector<AggregatorConfig>& aggregators,
+                    const ProtocolOptions& protocol,
+                    const OrchestratorOptions& options,
+                    const HierarchyRole& hierarchy,
                     LogLevel level);
 
+  // Simulação (main/simulate.cpp): nonces a partir de `seed`. Antes de loadConfig().
+  void enableSimulation(uint32_t seed);
+  // Diretório dos CSVs de métricas (padrão metrics/). Antes de start().
+  void setMetricsDirectory(const std::string& dir);
   void setup(const std::string& prefix) override;
+  // Inicializa as métricas, registra os prefixos e liga o motor sem rodar a Face;
+  // run() é start() seguido de processEvents().
+  void start();
   void run() override;
 
 protected:
@@ -82,56 +131,317 @@ protected:
   void sendInterest(const ndn::Interest& interest) override;
 
 private:
+  Orchestrator(ndn::Face* face, ndn::KeyChain* keyChain);
+
+  // Estado novo de um semáforo, da thread de I/O para o motor.
+  struct IngestEvent {
+    LightId id = INVALID_LIGHT;
+    bool reachable = true;                // false: semáforo dado como inalcançável
+    const char* reason = "";
+    status::StatusReport report;
+    int oneWayDelayMs = 0;                // da amostra que trouxe o estado
+    Ticks arrival = 0;
+  };
+
+  // Estado do motor de um shard. Durante a passagem só a thread que avalia o
+  // shard o toca; as regras de um shard nunca alcançam semáforos de outro.
+  struct ShardState {
+    std::vector<LightId> changedLights;
+    std::vector<LightId> evaluating;
+    std::vector<GroupId> pendingIntersections;
+    std::vector<GroupId> pendingWaves;
+    std::vector<GroupId> pendingSyncGroups;
+    std::vector<LightId> commandLights;       // lotes alterados na passagem atual
+    std::vector<LightId> ready;               // lotes publicados na passagem atual
+    DeadlineQueue deadlines;
+    size_t changedCount = 0;                  // da última passagem, para as estatísticas
+    size_t groupCount = 0;
+  };
+
+  // Orquestrador regional: estado dos semáforos de fronteira montado pelo motor
+  // e servido pela thread de I/O no resumo pedido pela cidade.
+  struct BoundaryState {
+    LightId id = INVALID_LIGHT;
+    Color phase = Color::UNKNOWN;
+    Ticks endTime = 0;
+    float priority = 0.0f;
+    uint16_t queueLength = 0;
+  };
+  struct RegionSnapshot {
+    status::RegionSummary summary;
+    std::vector<BoundaryState> lights;
+  };
+
+  // Lote da cidade para um semáforo de fronteira, da thread de I/O para o motor.
+  struct RelayedCommand {
+    LightId id = INVALID_LIGHT;
+    CommandBatch batch;
+  };
+
   void cycle();
-  void produce(const std::string& trafficLightName, const ndn::Interest& interest);
+  void startEventEngine();
+  void evaluate();
+  void evaluateDirty(Ticks now, bool priorityPass, std::vector<LightId>& ready);
+  void evaluateShard(uint32_t shardId, Ticks now, bool full, bool priorityPass, float averagePriority);
+  bool hasPendingChanges() const;
+  void requestEvaluation();
+  void noteChange(LightId id);
+  void scheduleDeadline(DeadlineQueue::Kind kind, uint32_t target, Ticks due);
+  void armWake(Ticks now);
+  void schedulePriorityPass();
+  void produce(LightId id, const ndn::Interest& interest);
+  CommandBatch takeCommand(LightId id);
+  void holdInterest(LightId id, const ndn::Interest& interest, Ticks receivedAt);
+  void flushHeldInterests(const std::vector<LightId>& ids);
+  CommandBatch& commandFor(LightId id);
+  bool hasPendingCommand(LightId id) const;
+  void clearCommand(LightId id);
+  void publishCommands(ShardState& shard);
+  void sendPlan(LightId id);
+  size_t plannedPhasesLeft(LightId id, Ticks now) const;
+  void answerCommand(LightId id, const ndn::Interest& interest, CommandBatch batch, Ticks receivedAt);
+  void ingestStatusReport(LightId id, const ndn::Interest& interest);
+  void acceptStatusReport(LightId id, const ndn::Interest& interest);
+  void acceptStatusData(LightId id, const ndn::Data& data, int oneWayDelayMs, Ticks arrival);
+  void ingestStatus(LightId id, const status::StatusReport& report, int oneWayDelayMs, Ticks arrival);
+  const RttEstimator& rttFor(LightId id) const;
+  bool enqueueIngest(const IngestEvent& event);
+  void drainIngest();
+  void applyStatus(LightId id, const IngestEvent& event);
+  void applyUnreachable(LightId id, const char* reason);
+  void publishSummary();
+  void serveSummary(const ndn::Interest& interest);
+  void relayCommands(LightId id);
+  void acceptRelayedCommands(LightId id, const ndn::Data& data, Ticks sentAt, Ticks arrival);
+  void reportStatusTraffic();
+  void reportValidation(double windowSeconds);
+  void reportEngine(double windowSeconds);
+  void reportCallbackLatency(double windowSeconds);
+  void reportRtt(double windowSeconds);
+  void reportPolling(double windowSeconds);
+  void reportPrediction(double windowSeconds);
+  void reportClockSync(double windowSeconds);
+  void fetchPhaseTiming(LightId id);
+  void onPhaseTiming(LightId id, const ndn::Data& data);
+  void prefetchCertificates();
+  void cacheCertificate(LightId id, const ndn::Data& data);
+  void pollTick();
+  void visitLight(LightId id, Ticks now);
+  int pollIntervalMs(LightId id, Ticks now) const;
+  void pollStatus(LightId id, bool retransmission);
+  void expressStatus(LightId id, ndn::Interest interest, bool retransmission);
+  void onStatusData(LightId id, uint32_t nonce, const ndn::Data& data);
+  void onStatusNack(LightId id, uint32_t nonce, const ndn::Interest& interest, const ndn::lp::Nack& nack);
+  void onStatusTimeout(LightId id, uint32_t nonce, const ndn::Interest& interest);
+  void fetchAggregate(GroupId regionId, const ndn::Name& name, bool canBePrefix);
+  void onAggregateData(GroupId regionId, const ndn::Data& data, int oneWayDelayMs);
+  void onAggregateFailure(GroupId regionId, const std::string& reason);
+  bool regionCovers(LightId id) const;
+  LinkSigner::LinkId regionLink(GroupId regionId) const {
+    return static_cast<LinkSigner::LinkId>(trafficLights_.size() + regionId);
+  }
   
-  void generateIntersectionCommand(const Intersection& intersection, const std::string& requesterName);
-  void forceCycleStart(const std::string& intersectionName);
-  void processGreenWaves();
-  void processSyncGroups();
-  void assignPriorityCommands();
-  void processIntersections(const int& allRedTimeoutCycles);
-
-  void updatePriorityList(const std::string& intersectionName);
+  void generateIntersectionCommand(GroupId intersectionId, LightId requesterId, Ticks now);
+  void forceCycleStart(GroupId intersectionId, Ticks now);
+  void processGreenWave(GroupId waveId, Ticks now);
+  void processSyncGroup(GroupId groupId, Ticks now);
+  void assignPriorityCommands(const Shard& shard, float averagePriority, Ticks now);
+  void processIntersection(GroupId interId, Ticks now);
+
+  void updatePriorityList(GroupId intersectionId);
   float calculateAveragePriority() const;
   void appendToMetricsFile(int rtt_ms);
   
-  int recordRTT(const std::string& interestName);
-  int getAverageRTT() const;
-  const Intersection* findIntersectionFor(const std::string& lightName) const;
-  TrafficLightState* findTrafficLight(const std::string& name);
+  int recordRTT(LightId id, const PendingTable::Entry& sent);
+  LightId lightIdFor(const ndn::Name& interestName) const;
+  void markUnreachable(LightId id, const char* reason);
 
+  bool logs(LogLevel level) const;
   void log(LogLevel level, const std::string& message);
 
 private:
   boost::asio::io_context m_ioCtx;
   long long m_cycleCount = 0;
-  ndn::Face m_face;
-  ndn::KeyChain m_keyChain;
+  std::unique_ptr<ndn::Face> m_ownFace;              // vazios com Face e KeyChain injetadas
+  std::unique_ptr<ndn::KeyChain> m_ownKeyChain;
+  ndn::Face& m_face;
+  ndn::KeyChain& m_keyChain;
+  LinkSigner m_signer{m_keyChain};                   // enlace i = LightId i
   ndn::ValidatorConfig m_validator;
+  PacketVerifier m_verifier{m_validator, m_signer};
   ndn::Scheduler m_scheduler;
   ndn::ScopedRegisteredPrefixHandle m_certServeHandle;
+  bool m_certServed = false;
   
   std::jthread m_cycleThread;
   std::atomic_bool m_stopFlag{false};
-  mutable std::mutex mutex_;
+
+  // Divisão entre threads no motor TICK (no motor EVENT as duas são a mesma):
+  // - I/O (io_context da Face): Interests, Data, RTT, alcançabilidade, contadores
+  //   de tráfego e m_hot.{lastReport, statusSeq, timeoutCounter};
+  // - motor: o restante de m_hot, os grupos e os lotes de comando em montagem.
+  // A I/O passa estados ao motor por m_ingest; o motor entrega comandos por
+  // m_mailboxes (ver IngestEvent acima). Nenhum dos dois caminhos usa lock.
+  SpscRing<IngestEvent> m_ingest;
+  std::vector<CommandMailbox> m_mailboxes;           // indexado por LightId
+  std::vector<uint8_t> m_commandMask;                // lote na lista do shard, por LightId
+  boost::dynamic_bitset<uint64_t> m_reachable;       // visão da thread de I/O
+  // Um estimador por enlace (semáforos, depois regiões, como em m_signer). Um poll
+  // retransmitido não gera amostra, pois não se sabe a qual envio o Data responde.
+  std::vector<RttEstimator> m_rtt;
+  PendingTable m_pending;                            // polls de estado em voo, por LightId e nonce
+  uint32_t m_nextNonce = 0;
+  bool m_simulated = false;
+
+  // Roda de poll: a cada POLL_SLOT_MS a thread de I/O visita os semáforos do slot.
+  // O intervalo de cada um depende do restante da fase, pelo último estado recebido.
+  PollWheel m_pollWheel;
+  std::vector<uint16_t> m_pollPhase;                 // slot do semáforo no período, por LightId
+  std::vector<Ticks> m_pollEnd;                      // fim da fase no último estado, por LightId
+  std::chrono::steady_clock::time_point m_pollTickDue;
+  ndn::scheduler::ScopedEventId m_pollTickEvent;
+  uint64_t m_pollSent = 0;
+  LatencyHistogram m_pollBurst;                      // Interests por visita à roda
+  LatencyHistogram m_pollLateness;                   // atraso da visita, em µs
+  std::vector<uint64_t> m_rttReported;               // amostras até a última janela, por enlace
+
+  // Sincronia de relógio informada por cada semáforo no estado (v2 do payload).
+  struct LightClock {
+    int64_t offsetMs = 0;
+    uint16_t errorMs = status::CLOCK_UNSYNCED;
+    bool fresh = false;                              // novo desde a última janela
+  };
+  std::vector<LightClock> m_lightClock;              // por LightId; só a thread de I/O
+  // Último histograma acumulado do atraso das trocas de fase de cada semáforo.
+  struct LightTiming {
+    status::TimingReport report;
+    std::chrono::steady_clock::time_point at = steadyNow();
+  };
+  std::vector<LightTiming> m_lightTiming;            // por LightId; só a thread de I/O
+  std::vector<Ticks> m_timingDue;                    // próxima consulta a /timing, por LightId
+  uint64_t m_ingestDrops = 0;
+  LatencyHistogram m_callbackLatency;                // callbacks da Face, em µs
 
   std::string prefix_;
-  std::vector<TrafficLightState> trafficLights_;
-  std::map<std::string, Intersection> intersections_;
+  LightRegistry m_registry;
+  std::vector<TrafficLightState> trafficLights_;     // dados frios, indexado por LightId
+  LightStateTable m_hot;                             // dados quentes, indexado por LightId
+  std::vector<Intersection> intersections_;          // indexado por GroupId
   std::vector<GreenWaveGroup> greenWaves_;
   std::vector<SyncGroup> syncGroups_;
-  std::map<std::string, std::vector<std::pair<std::string, int>>> sortedPriorityCache_;
-  std::map<std::string, std::chrono::steady_clock::time_point> m_lastPriorityCommandTime;
-  std::map<std::string, std::string> m_activeLightPerIntersection;
+
+  // Regiões servidas por um agregador; m_lightRegion é indexado por LightId.
+  // Na cidade, também as regiões com orquestrador próprio (`orchestrated`), cujo
+  // resumo traz os semáforos de fronteira e a prioridade média da região.
+  struct AggregateRegion {
+    std::string prefix;
+    uint8_t failures = 0;
+    bool orchestrated = false;
+    uint32_t lightCount = 0;            // semáforos da região, para a média da cidade
+    ndn::Name fetchName;
+  };
+  std::vector<AggregateRegion> m_regions;
+  std::vector<GroupId> m_lightRegion;
+  std::vector<std::pair<std::string_view, status::StatusReport>> m_aggregateScratch;
+  std::vector<std::vector<std::pair<LightId, float>>> sortedPriorityCache_;
+  std::vector<LightId> m_activeLightPerIntersection;
+  std::vector<Ticks> m_allRedSince;                  // 0 = há uma fase ativa no cruzamento
+  std::vector<uint64_t> m_commandSeq;
+
+  // Tabela de Interests de comando retidos (no máximo um por semáforo).
+  struct HeldInterest {
+    std::optional<ndn::Interest> interest;
+    Ticks receivedAt = 0;                            // t2 da sincronia de relógio do semáforo
+    ndn::scheduler::ScopedEventId expiry;
+  };
+  std::vector<HeldInterest> m_heldCommandInterests;
 
   
   std::string lastModified;
-  std::unordered_map<std::string, std::chrono::steady_clock::time_point> interestTimestamps_;
-  std::map<std::string, int> m_allRedCounter;
-  std::vector<int> rttHistory_;
   std::string m_metricsFilename; 
 
+  ProtocolOptions m_protocol;
+  OrchestratorOptions m_options;
+
+  // Hierarquia de orquestradores (seção `regions:` do cenário).
+  HierarchyRole m_hierarchy;
+  // Cidade: semáforos de fronteira, cujo estado chega no resumo de uma região e
+  // cujos comandos ela repassa. Fixos após loadConfig().
+  std::vector<uint8_t> m_relayed;                    // por LightId
+  std::vector<LightId> m_relayedLights;
+  std::vector<std::atomic<float>> m_regionPriority;  // por região de m_regions; NaN até o primeiro resumo
+  // Região: o resumo para a cidade e os lotes que ela manda.
+  std::vector<LightId> m_boundaryLights;
+  std::atomic<std::shared_ptr<const RegionSnapshot>> m_summary;
+  SpscRing<RelayedCommand> m_relayedCommands;
+  LinkSigner::LinkId m_upstreamLink = 0;
+  ndn::Name m_summaryPrefix;
+  uint64_t m_summaryVersion = 0;
+  uint64_t m_relaySeq = 0;
+  ClockSync m_upstreamClock;                         // relógio da cidade, pelas respostas ao repasse
+
+  // Conjuntos sujos: semáforos com estado novo desde a última avaliação e os
+  // grupos que os contêm, separados por shard. Nos dois motores só os grupos
+  // marcados são avaliados; no motor por eventos a fila de prazos também o acorda.
+  // As marcas são bytes, e não bits, para que shards avaliados em paralelo nunca
+  // escrevam na mesma palavra.
+  ShardPartition m_partition;
+  std::unique_ptr<ShardPool> m_pool;                 // só com orchestrator.workers > 1
+  std::vector<ShardState> m_shards;
+  std::vector<uint8_t> m_changedMask;                // por LightId
+  std::vector<uint8_t> m_pendingIntersections;       // por GroupId
+  std::vector<uint8_t> m_pendingWaves;
+  std::vector<uint8_t> m_pendingSyncGroups;
+  std::vector<Ticks> m_scheduledEnd;                 // endTime já posto na fila, por LightId
+  bool m_evaluationPending = false;
+  bool m_fullEvaluation = false;
+  ndn::scheduler::ScopedEventId m_wakeEvent;
+  ndn::scheduler::ScopedEventId m_priorityEvent;
+
+  // Escritos pelo motor e lidos pela thread de I/O a cada janela.
+  struct EngineStats {
+    std::atomic<uint64_t> evaluations{0};
+    std::atomic<uint64_t> changedLights{0};
+    std::atomic<uint64_t> groupsEvaluated{0};
+    std::atomic<uint64_t> maxGroups{0};        // maior número de grupos numa só avaliação
+  };
+  EngineStats m_engineStats;
+
+  // Modo predict: o motor avança a fase de cada semáforo pelo modelo comum
+  // quando vence o fim previsto, e mede o erro da previsão a cada notificação.
+  std::vector<phase::Durations> m_phaseDurations;    // por LightId
+  // Durações que o orquestrador planeja para cada semáforo (padrão mais os
+  // ajustes de prioridade e de onda verde) e o último plano enviado a ele.
+  std::vector<phase::Durations> m_plannedDurations;  // por LightId
+  std::vector<phase::Plan> m_plans;                  // por LightId
+  struct PredictionStats {
+    std::atomic<uint64_t> reports{0};
+    std::atomic<uint64_t> phaseMismatches{0};  // notificação com outra fase que a prevista
+    std::atomic<uint64_t> errorSumMs{0};       // |fim previsto - fim notificado|, mesma fase
+    std::atomic<uint64_t> errorMaxMs{0};
+  };
+  PredictionStats m_predictionStats;
+
+  // Pacotes de estado trocados na janela atual, para comparar push com poll.
+  struct StatusTraffic {
+    uint64_t pollInterests = 0;
+    uint64_t pollsDeferred = 0;       // janela de Interests em voo cheia
+    uint64_t pollData = 0;
+    uint64_t pushReports = 0;
+    uint64_t pushAcks = 0;
+    std::chrono::steady_clock::time_point windowStart = steadyNow();
+  };
+  StatusTraffic m_statusTraffic;
+  std::string m_trafficFilename;
+  std::string m_validationFilename;
+  std::string m_engineFilename;
+  std::string m_latencyFilename;
+  std::string m_rttFilename;
+  std::string m_pollingFilename;
+  std::string m_predictionFilename;
+  std::string m_clockSyncFilename;
+  std::string m_phaseTimingFilename;
+
   LogLevel m_logLevel = LogLevel::NONE;
 };
 
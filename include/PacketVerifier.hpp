@@ -0,0 +1,69 @@
+#ifndef PACKETVERIFIER_HPP
+#define PACKETVERIFIER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include "LinkSigner.hpp"
+
+// =================================================================================
+// Verificação de pacotes recebidos
+//
+// - ASYMMETRIC: delega ao Validator (trust schema em config/trust-schema.conf), que
+//   busca os certificados pela rede e guarda os já verificados.
+// - HMAC / DIGEST: verifica localmente com a chave do enlace (LinkSigner).
+//
+// Data idênticos (mesmo digest implícito: nome, conteúdo, chave e assinatura)
+// verificados há pouco são aceitos sem repetir a verificação, o que cobre os
+// reenvios de SignedDataCache e as retransmissões.
+// =================================================================================
+class PacketVerifier {
+public:
+  using Clock = std::chrono::steady_clock;
+  using SuccessCallback = std::function<void()>;
+  using FailureCallback = std::function<void(const std::string& reason)>;
+
+  // Latência medida do pedido de verificação até o callback.
+  struct Stats {
+    uint64_t verified = 0;
+    uint64_t memoHits = 0;
+    uint64_t failures = 0;
+    uint64_t totalLatencyUs = 0;
+    uint64_t maxLatencyUs = 0;
+  };
+
+  PacketVerifier(ndn::security::Validator& validator, const LinkSigner& signer);
+
+  void verify(const ndn::Data& data, LinkSigner::LinkId link,
+              const SuccessCallback& onSuccess, const FailureCallback& onFailure);
+  void verify(const ndn::Interest& interest, LinkSigner::LinkId link,
+              const SuccessCallback& onSuccess, const FailureCallback& onFailure);
+
+  // Retorna os contadores da janela atual e começa uma nova.
+  Stats takeStats();
+
+private:
+  void remember(const std::string& digest, Clock::time_point now);
+  void record(Clock::time_point start, bool ok, bool memoHit);
+
+private:
+  ndn::security::Validator& m_validator;
+  const LinkSigner& m_signer;
+
+  std::unordered_map<std::string, Clock::time_point> m_memo;   // digest -> validade
+  std::deque<std::string> m_memoOrder;                         // FIFO para limitar o tamanho
+  Stats m_stats;
+
+  static constexpr size_t MEMO_CAPACITY = 4096;
+  static constexpr std::chrono::seconds MEMO_TTL{30};
+};
+
+#endif // PACKETVERIFIER_HPP
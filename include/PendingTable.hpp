@@ -0,0 +1,75 @@
+#ifndef PENDINGTABLE_HPP
+#define PENDINGTABLE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "LightRegistry.hpp"
+
+// Interests de estado em voo, por semáforo e nonce. Cada semáforo tem uma janela
+// fixa de `perLight` entradas num único vetor: a memória não cresce com o tempo
+// de execução, e uma entrada só sai por Data, Nack ou timeout do próprio Interest.
+// Não é thread-safe (só a thread de I/O a usa).
+class PendingTable {
+public:
+  struct Entry {
+    uint32_t nonce = 0;
+    bool used = false;
+    bool retransmission = false;        // a resposta não gera amostra de RTT
+    std::chrono::steady_clock::time_point sentAt;
+  };
+
+  void resize(size_t lights, size_t perLight) {
+    m_perLight = std::max<size_t>(1, perLight);
+    m_entries.assign(lights * m_perLight, Entry{});
+    m_inFlight.assign(lights, 0);
+    m_total = 0;
+  }
+
+  // false com a janela do semáforo cheia; o Interest não deve ser enviado.
+  bool insert(LightId id, uint32_t nonce, std::chrono::steady_clock::time_point sentAt, bool retransmission) {
+    if (m_inFlight[id] == m_perLight) {
+      return false;
+    }
+    Entry* slot = begin(id);
+    while (slot->used) {
+      ++slot;
+    }
+    *slot = Entry{nonce, true, retransmission, sentAt};
+    m_inFlight[id]++;
+    m_total++;
+    return true;
+  }
+
+  // Retira a entrada do Interest (id, nonce), se ainda estiver em voo.
+  std::optional<Entry> take(LightId id, uint32_t nonce) {
+    Entry* slot = begin(id);
+    for (size_t i = 0; i < m_perLight; ++i, ++slot) {
+      if (slot->used && slot->nonce == nonce) {
+        Entry entry = *slot;
+        slot->used = false;
+        m_inFlight[id]--;
+        m_total--;
+        return entry;
+      }
+    }
+    return std::nullopt;
+  }
+
+  size_t inFlight(LightId id) const { return m_inFlight[id]; }
+  size_t total() const { return m_total; }
+  size_t capacity() const { return m_entries.size(); }
+
+private:
+  Entry* begin(LightId id) { return m_entries.data() + static_cast<size_t>(id) * m_perLight; }
+
+  std::vector<Entry> m_entries;
+  std::vector<uint8_t> m_inFlight;
+  size_t m_perLight = 1;
+  size_t m_total = 0;
+};
+
+#endif // PENDINGTABLE_HPP
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+
+#include "Clock.hpp"
+#include "Enums.hpp"
+
+// Modelo de fases compartilhado pelo semáforo e pelo orquestrador no modo
+// `predict`: a partir da última fase reportada e do seu fim, os dois lados
+// calculam a mesma sequência VERDE -> AMARELO -> VERMELHO com as durações padrão
+// do ciclo. O semáforo só notifica quando a realidade se afasta desse cálculo.
+namespace phase {
+
+constexpr int YELLOW_MS = 3000;
+
+// Durações padrão de cada fase do ciclo, em ms, indexadas por Color.
+struct Durations {
+  std::array<int, 3> ms{};
+
+  int of(Color color) const { return ms[static_cast<size_t>(color)]; }
+};
+
+// As mesmas que SmartTrafficLight usa ao carregar o cenário: metade do ciclo
+// em vermelho e a outra metade dividida entre verde e amarelo.
+inline Durations defaultDurations(int cycleSeconds) {
+  const int halfMs = (cycleSeconds / 2) * 1000;
+  return Durations{{halfMs - YELLOW_MS, YELLOW_MS, halfMs}};
+}
+
+// Plano de fases enviado pelo orquestrador: as próximas fases do semáforo, cada
+// uma com a cor e o instante absoluto em que termina. A primeira é a fase atual;
+// cada uma começa quando a anterior termina. Um plano novo substitui o anterior
+// por inteiro, então entregá-lo de novo não muda nada. Depois da última fase o
+// semáforo volta às durações padrão.
+struct PlanEntry {
+  Color color = Color::UNKNOWN;
+  Ticks end = 0;
+};
+
+struct Plan {
+  static constexpr size_t CAPACITY = 6;
+  // Diferença entre dois fins de fase que ainda conta como o mesmo instante,
+  // menor que qualquer fase (o amarelo tem 3 s).
+  static constexpr Ticks SLACK_MS = 1000;
+
+  std::array<PlanEntry, CAPACITY> entries{};
+  uint8_t count = 0;
+
+  bool empty() const { return count == 0; }
+  void clear() { count = 0; }
+  bool push(Color color, Ticks end) {
+    if (count == CAPACITY) return false;
+    entries[count++] = {color, end};
+    return true;
+  }
+  const PlanEntry* begin() const { return entries.data(); }
+  const PlanEntry* end() const { return entries.data() + count; }
+
+  // Fim da última fase planejada; 0 sem plano.
+  Ticks horizon() const { return count ? entries[count - 1].end : 0; }
+
+  // A fase que segue uma fase terminada em `phaseEnd`, ou nullptr se o plano
+  // não a cobre.
+  const PlanEntry* after(Ticks phaseEnd) const {
+    for (const PlanEntry& entry : *this) {
+      if (entry.end > phaseEnd + SLACK_MS) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+};
+
+inline bool cycles(Color color) {
+  return color == Color::GREEN || color == Color::YELLOW || color == Color::RED;
+}
+
+inline Color next(Color color) {
+  switch (color) {
+    case Color::GREEN:  return Color::YELLOW;
+    case Color::YELLOW: return Color::RED;
+    case Color::RED:    return Color::GREEN;
+    default:            return color;
+  }
+}
+
+// Avança (color, endTime) pelas fases do ciclo até a fase que contém `now`,
+// seguindo o plano enquanto ele cobre as fases. ALERTA e UNKNOWN não têm
+// previsão e ficam como estão.
+inline void advance(Color& color, Ticks& endTime, Ticks now, const Durations& durations,
+                    const Plan& plan = {}) {
+  if (!cycles(color)) {
+    return;
+  }
+  while (endTime <= now) {
+    if (const PlanEntry* planned = plan.after(endTime)) {
+      color = planned->color;
+      endTime = planned->end;
+      continue;
+    }
+    color = next(color);
+    const int duration = durations.of(color);
+    if (duration <= 0) {
+      return;
+    }
+    endTime += duration;
+  }
+}
+
+} // namespace phase
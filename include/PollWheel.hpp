@@ -0,0 +1,56 @@
+#ifndef POLLWHEEL_HPP
+#define POLLWHEEL_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "LightRegistry.hpp"
+
+// Roda de tempo de um nível para o poll dos semáforos: `slotCount` slots de
+// duração fixa, cada um com os semáforos a consultar nele. Um agendamento deve
+// cair menos de `slotCount` slots à frente do slot atual, então não há voltas a
+// contar. Agendar e avançar custam O(1) por semáforo. Não é thread-safe.
+class PollWheel {
+public:
+  void reset(size_t slotCount) {
+    m_slots.assign(slotCount, {});
+    m_current = 0;
+  }
+
+  uint64_t current() const { return m_current; }
+  size_t slotCount() const { return m_slots.size(); }
+
+  // `slot` é absoluto, em [current(), current() + slotCount()).
+  void schedule(LightId id, uint64_t slot) {
+    m_slots[slot % m_slots.size()].push_back(id);
+  }
+
+  // Entrega a `visit` os semáforos do slot atual e passa ao seguinte. `visit`
+  // pode reagendar os semáforos que recebe.
+  template <typename Visit>
+  void advance(Visit&& visit) {
+    auto& bucket = m_slots[m_current % m_slots.size()];
+    std::swap(bucket, m_due);
+    m_current++;
+    for (LightId id : m_due) {
+      visit(id);
+    }
+    m_due.clear();
+  }
+
+  // Primeiro slot a partir de current() com `slot % interval == phase % interval`:
+  // com intervalos que dividem o período, o semáforo mantém a sua fase nele.
+  // Dentro de advance(), current() já é o slot seguinte ao visitado.
+  uint64_t nextAligned(uint64_t interval, uint64_t phase) const {
+    const uint64_t first = m_current;
+    return first + (phase % interval + interval - first % interval) % interval;
+  }
+
+private:
+  std::vector<std::vector<LightId>> m_slots;
+  std::vector<LightId> m_due;           // slot em visita; a capacidade é reaproveitada
+  uint64_t m_current = 0;
+};
+
+#endif // POLLWHEEL_HPP
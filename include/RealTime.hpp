@@ -0,0 +1,32 @@
+#ifndef REALTIME_HPP
+#define REALTIME_HPP
+
+#include <string>
+
+#include "Clock.hpp"
+
+// Ajustes de tempo real para a thread que troca as fases do semáforo (Linux).
+// Cada função retorna false e preenche `error` quando o sistema recusa o ajuste,
+// em geral por falta de CAP_SYS_NICE ou CAP_IPC_LOCK; o chamador decide se segue.
+namespace rt {
+
+// Trava na RAM as páginas atuais e futuras do processo: a troca de fase não
+// espera por uma falta de página.
+bool lockMemory(std::string& error);
+
+// Prende a thread atual ao núcleo `cpu`.
+bool pinToCpu(int cpu, std::string& error);
+
+// Passa a thread atual para SCHED_FIFO com a prioridade dada (1 a 99).
+bool setFifoPriority(int priority, std::string& error);
+
+// Toca `bytes` da pilha da thread atual para que as páginas já existam.
+void prefaultStack(size_t bytes);
+
+// Dorme até o instante absoluto `deadline` do steady_clock com clock_nanosleep
+// sobre CLOCK_MONOTONIC, o mesmo relógio do steady_clock no Linux.
+void sleepUntil(Ticks deadline);
+
+} // namespace rt
+
+#endif // REALTIME_HPP
@@ -0,0 +1,36 @@
+#ifndef REGIONPLAN_HPP
+#define REGIONPLAN_HPP
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Structs.hpp"
+#include "YamlParser.hpp"
+
+// Recorte do cenário que cabe a um orquestrador da hierarquia.
+struct OrchestratorView {
+  std::vector<std::pair<std::string, TrafficLightState>> trafficLights;
+  std::map<std::string, Intersection> intersections;
+  std::vector<GreenWaveGroup> greenWaves;
+  std::vector<SyncGroup> syncGroups;
+  std::vector<AggregatorConfig> aggregators;
+  HierarchyRole role;
+};
+
+// Divide o cenário entre a cidade e as regiões de `regions:`.
+//
+// - Região r: seus semáforos, os grupos com todos os membros nela e os
+//   agregadores dentro dela.
+// - Cidade (regionIndex < 0): os semáforos fora de qualquer região, os grupos que
+//   não cabem numa só região e os agregadores fora das regiões. Os semáforos de
+//   região que participam desses grupos entram como "de fronteira": a cidade
+//   recebe o estado deles no resumo da região e entrega os comandos por ela.
+//   Os cruzamentos desses semáforos entram também, só para leitura, para que as
+//   ondas verdes da cidade respeitem o concorrente de cada um.
+//
+// Sem `regions:` a cidade recebe o cenário inteiro.
+OrchestratorView buildOrchestratorView(const YamlParser& parser, int regionIndex, const std::string& cityPrefix);
+
+#endif // REGIONPLAN_HPP
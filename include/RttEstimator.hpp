@@ -0,0 +1,76 @@
+#ifndef RTTESTIMATOR_HPP
+#define RTTESTIMATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Estimador de RTT de um enlace, como o do TCP (RFC 6298): média suavizada
+// (SRTT) e variação (RTTVAR) atualizadas a cada amostra, e o tempo limite de
+// retransmissão RTO = SRTT + 4·RTTVAR, dobrado a cada timeout até a próxima
+// amostra. As últimas WINDOW amostras ficam num buffer circular fixo para os
+// percentis exportados nas métricas. Não é thread-safe.
+class RttEstimator {
+public:
+  static constexpr size_t WINDOW = 32;
+  static constexpr int INITIAL_RTO_MS = 1000;   // antes da primeira amostra
+  static constexpr int MIN_RTO_MS = 200;
+  static constexpr int MAX_RTO_MS = 4000;       // o lifetime fixo de antes
+
+  void addSample(int rttMs) {
+    const double sample = std::max(rttMs, 0);
+    if (m_count == 0) {
+      m_srtt = sample;
+      m_rttvar = sample / 2.0;
+    } else {
+      m_rttvar = (1.0 - BETA) * m_rttvar + BETA * std::abs(m_srtt - sample);
+      m_srtt = (1.0 - ALPHA) * m_srtt + ALPHA * sample;
+    }
+    m_samples[m_next] = static_cast<int32_t>(sample);
+    m_next = (m_next + 1) % WINDOW;
+    m_count++;
+    m_rto = std::clamp(static_cast<int>(std::ceil(m_srtt + 4.0 * m_rttvar)), MIN_RTO_MS, MAX_RTO_MS);
+  }
+
+  // Timeout: o próximo Interest espera o dobro.
+  void backoff() { m_rto = std::min(m_rto * 2, MAX_RTO_MS); }
+
+  bool hasSamples() const { return m_count > 0; }
+  uint64_t sampleCount() const { return m_count; }
+  int srttMs() const { return static_cast<int>(std::lround(m_srtt)); }
+  int rttvarMs() const { return static_cast<int>(std::lround(m_rttvar)); }
+  int rtoMs() const { return m_rto; }
+  int oneWayMs() const { return static_cast<int>(std::lround(m_srtt / 2.0)); }
+
+  // Quantil q (0 a 1) das amostras guardadas; 0 sem amostras.
+  int percentile(double q) const {
+    const size_t stored = std::min<uint64_t>(m_count, WINDOW);
+    if (stored == 0) {
+      return 0;
+    }
+    std::array<int32_t, WINDOW> sorted = m_samples;
+    const size_t rank = std::min(stored - 1, static_cast<size_t>(std::ceil(q * stored)) - (q > 0.0 ? 1 : 0));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + stored);
+    return sorted[rank];
+  }
+
+  int max() const {
+    const size_t stored = std::min<uint64_t>(m_count, WINDOW);
+    return stored == 0 ? 0 : *std::max_element(m_samples.begin(), m_samples.begin() + stored);
+  }
+
+private:
+  static constexpr double ALPHA = 1.0 / 8.0;
+  static constexpr double BETA = 1.0 / 4.0;
+
+  std::array<int32_t, WINDOW> m_samples{};
+  size_t m_next = 0;
+  uint64_t m_count = 0;
+  double m_srtt = 0.0;
+  double m_rttvar = 0.0;
+  int m_rto = INITIAL_RTO_MS;
+};
+
+#endif // RTTESTIMATOR_HPP
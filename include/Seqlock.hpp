@@ -0,0 +1,75 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Valor publicado por um único escritor e lido sem locks por qualquer thread. O
+// escritor torna a sequência ímpar, copia o valor e a torna par de novo; o leitor
+// copia o valor entre duas leituras da sequência e repete se ela mudou ou estava
+// ímpar. O valor é guardado em palavras atômicas relaxadas, então a cópia
+// concorrente não é uma corrida de dados. Escrever nunca espera pelos leitores.
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable_v<T>, "o valor é copiado palavra a palavra");
+
+public:
+  Seqlock() { write(T{}); }
+
+  Seqlock(const Seqlock&) = delete;
+  Seqlock& operator=(const Seqlock&) = delete;
+
+  // Só o escritor.
+  void write(const T& value) {
+    Words words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    const uint64_t seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; ++i) {
+      m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  T read() const {
+    uint64_t retries = 0;
+    return read(retries);
+  }
+
+  // `retries` soma as cópias descartadas por uma escrita concorrente.
+  T read(uint64_t& retries) const {
+    Words words;
+    for (;;) {
+      const uint64_t before = m_seq.load(std::memory_order_acquire);
+      if ((before & 1) == 0) {
+        for (size_t i = 0; i < WORDS; ++i) {
+          words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) == before) {
+          break;
+        }
+      }
+      retries++;
+    }
+    T value;
+    std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+    return value;
+  }
+
+  // Número de valores publicados, contando o inicial.
+  uint64_t version() const { return m_seq.load(std::memory_order_acquire) / 2; }
+
+private:
+  static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  using Words = std::array<uint64_t, WORDS>;
+
+  alignas(64) std::atomic<uint64_t> m_seq{0};
+  std::array<std::atomic<uint64_t>, WORDS> m_words{};
+};
+
+#endif // SEQLOCK_HPP
@@ -0,0 +1,41 @@
+#ifndef SHARDPARTITION_HPP
+#define SHARDPARTITION_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "LightRegistry.hpp"
+
+// Grupos de semáforos sem nenhuma regra em comum com o resto do cenário. As
+// regras de um shard só leem e escrevem semáforos e grupos do próprio shard,
+// então shards diferentes podem ser avaliados em paralelo.
+struct Shard {
+  std::vector<LightId> lights;
+  std::vector<GroupId> intersections;
+  std::vector<GroupId> waves;
+  std::vector<GroupId> syncGroups;
+};
+
+// Partição construída uma única vez em loadConfig(). Os componentes conexos do
+// grafo semáforo-grupo (cruzamentos, ondas verdes e grupos de sincronia) são
+// distribuídos em até `maxShards` shards, do maior para o menor, sempre no shard
+// com menos semáforos. Um componente nunca é dividido.
+class ShardPartition {
+public:
+  void build(const LightRegistry& registry, size_t maxShards);
+
+  const std::vector<Shard>& shards() const { return shards_; }
+  size_t size() const { return shards_.size(); }
+  size_t componentCount() const { return componentCount_; }
+
+  uint32_t shardOfLight(LightId id) const { return lightShard_[id]; }
+  uint32_t shardOfIntersection(GroupId group) const { return intersectionShard_[group]; }
+
+private:
+  std::vector<Shard> shards_;
+  std::vector<uint32_t> lightShard_;
+  std::vector<uint32_t> intersectionShard_;
+  size_t componentCount_ = 0;
+};
+
+#endif // SHARDPARTITION_HPP
@@ -0,0 +1,53 @@
+#ifndef SHARDPOOL_HPP
+#define SHARDPOOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Threads fixas que executam uma passagem do motor sobre todos os shards. A
+// thread que chama run() é o worker 0. Cada worker recebe um intervalo contíguo
+// de shards e, quando o seu acaba, rouba os que restam nos intervalos dos outros;
+// assim um shard maior que os demais não deixa os outros workers parados.
+class ShardPool {
+public:
+  // `workers` inclui a thread que chama run(); com 1 nenhuma thread é criada.
+  explicit ShardPool(size_t workers);
+  ~ShardPool();
+
+  ShardPool(const ShardPool&) = delete;
+  ShardPool& operator=(const ShardPool&) = delete;
+
+  size_t workers() const { return m_queues.size(); }
+
+  // Executa task(s) para cada s em [0, count) e retorna quando todas terminarem.
+  // Só uma thread pode chamar run().
+  void run(size_t count, const std::function<void(size_t)>& task);
+
+  // Shards executados fora do intervalo do próprio worker desde a última chamada.
+  uint64_t takeSteals() { return m_steals.exchange(0, std::memory_order_relaxed); }
+
+private:
+  // Próximo shard do intervalo [next, end) de um worker; o dono e os ladrões
+  // disputam o mesmo contador.
+  struct alignas(64) Queue {
+    std::atomic<size_t> next{0};
+    size_t end = 0;
+  };
+
+  void workerLoop(size_t worker);
+  void drain(size_t worker);
+
+  std::vector<Queue> m_queues;
+  std::vector<std::jthread> m_threads;
+  const std::function<void(size_t)>* m_task = nullptr;
+  std::atomic<uint64_t> m_generation{0};    // uma por passagem; acorda os workers
+  std::atomic<size_t> m_running{0};         // workers ainda na passagem atual
+  std::atomic<uint64_t> m_steals{0};
+  std::atomic_bool m_stop{false};
+};
+
+#endif // SHARDPOOL_HPP
@@ -0,0 +1,56 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "LogLevel.hpp"
+#include "Structs.hpp"
+#include "YamlParser.hpp"
+
+// =================================================================================
+// Simulação determinística
+//
+// O orquestrador e todos os semáforos do cenário num processo só, ligados por
+// DummyClientFace num io_context comum, sem NFD. O relógio é virtual (Clock.hpp)
+// e só anda quando o laço o avança, um passo por vez; a cada passo o io_context
+// roda tudo o que venceu. Os semáforos não têm thread de ciclo (o motor de fases
+// roda em eventos do scheduler) e o tráfego de cada um sai de uma semente fixa,
+// então a mesma semente reproduz a mesma execução, em segundos de CPU por hora
+// simulada. Uma simulação ocupa só a thread que a chama, e várias podem rodar em
+// paralelo, cada uma na sua thread.
+//
+// O cenário inteiro fica com o orquestrador da cidade: `regions` e `aggregators`
+// são ignorados, o motor é `event` com um worker e a assinatura `asymmetric`
+// vira `digest`, pois as assinaturas ECDSA são aleatórias e o Validator buscaria
+// certificados pela rede.
+// =================================================================================
+namespace sim {
+
+struct RunOptions {
+  int64_t durationS = 3600;
+  uint32_t seed = 1;                    // semáforo i usa seed + 1 + i
+  int64_t stepMs = 10;
+  LogLevel logLevel = LogLevel::NONE;
+  std::string metricsDir = "metrics";
+};
+
+// Indicadores de tráfego do cenário inteiro, dos contadores dos semáforos.
+struct TrafficKpis {
+  size_t lights = 0;
+  uint64_t arrivals = 0;
+  uint64_t departures = 0;
+  double throughputVph = 0.0;           // veículos que passaram por hora, no cenário
+  double meanQueue = 0.0;               // veículos na fila por semáforo, média no tempo
+  int maxQueue = 0;
+  double meanDelayS = 0.0;              // espera por veículo que passou (lei de Little)
+  double wallSeconds = 0.0;
+};
+
+// Roda o cenário com as regras de controle `control` no lugar das do YAML.
+TrafficKpis run(const YamlParser& parser, const ControlParams& control, const RunOptions& options);
+
+} // namespace sim
+
+#endif // SIMULATION_HPP
@@ -5,23 +5,55 @@
 #include "Structs.hpp"
 #include "ProConInterface.hpp"
 #include "LogLevel.hpp" 
+#include "StatusCodec.hpp"
+#include "LinkSigner.hpp"
+#include "PacketVerifier.hpp"
+#include "PhaseModel.hpp"
+#include "ClockSync.hpp"
+#include "LatencyHistogram.hpp"
+#include "Seqlock.hpp"
+#include "SpscRing.hpp"
+#include "RealTime.hpp"
 
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <utility>
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
 
 using namespace std::chrono;
 
 class SmartTrafficLight : public ndn::ProConInterface {
 public:
+    // Tráfego acumulado desde a partida, somado a cada tick de tráfego (1 s).
+    struct TrafficStats {
+        uint64_t arrivals = 0;
+        uint64_t departures = 0;
+        uint64_t ticks = 0;
+        uint64_t queueSum = 0;      // veículos na fila somados a cada tick: veículo·s
+        int maxQueue = 0;
+    };
+
     SmartTrafficLight();
+    // Face e KeyChain do chamador, como os DummyClientFace do simulador.
+    SmartTrafficLight(ndn::Face& face, ndn::KeyChain& keyChain);
     ~SmartTrafficLight();
     void setup(const std::string& prefix) override;
-    void loadConfig(const TrafficLightState& config, LogLevel level);
+    void loadConfig(const TrafficLightState& config, const ProtocolOptions& protocol, LogLevel level);
+    void enableRealTime(int cpu);
+    void enableSimulation(uint32_t seed);
+    // Registra os prefixos e liga o motor de fases sem rodar a Face; run() é
+    // start() seguido de processEvents().
+    void start();
     void run() override;
+    // Da thread de ciclo: só pode ser lido com o motor parado, como ao fim de
+    // uma simulação.
+    const TrafficStats& trafficStats() const { return m_trafficStats; }
 
 protected:
   void runProducer(const std::string& suffix) override;
@@ -38,24 +70,57 @@ protected:
   void onRegisterFailed(const ndn::Name& prefix, const std::string& reason) override;
 
 private:
+    // Estado observável do semáforo: a thread de ciclo o publica a cada mudança e
+    // a thread de I/O o lê sem locks para responder e notificar o orquestrador.
+    struct LightSnapshot {
+        Color color = Color::UNKNOWN;
+        Ticks phaseEnd = 0;
+        int vehicles = 0;
+        int fullCycleVehicles = 0;
+        phase::Plan plan;
+    };
+
     void startCycle();
     void cycle();
+    void startPhaseEngine();
+    Ticks runPhaseEngine();
+    void schedulePhaseStep(Ticks wake);
+    void advancePhase();
+    void enterPhase(Color color, Ticks start);
+    void trafficTick();
+    void reportTransitionLateness();
+    void configureRealTime();
+    void publishState();
+    Ticks remainingMs(Ticks now) const;
 
     void generateTraffic();
     void passVehicles();
     int generateNumber(int min, int max);
 
-    float calculatePriority();
-
-    std::vector<Command> parseContent(const std::string& rawCommand);
+    float calculatePriority(const LightSnapshot& state) const;
+    status::StatusReport currentStatus(const LightSnapshot& state);
+    void reportStatusCache(std::chrono::steady_clock::time_point now);
+
+    // Modo push: verifica periodicamente se há algo a notificar ao orquestrador.
+    void scheduleStatusCheck();
+    void checkStatusReport();
+    bool deviatesFromPrediction(const LightSnapshot& state);
+    void sendStatusReport(const status::StatusReport& report);
+    void replyTiming(const ndn::Interest& interest);
+    void replyCertificate(const ndn::Interest& interest);
+
+    void acceptCommands(const ndn::Data& data, Ticks sentAt, Ticks arrival);
+    void enqueueCommands(const CommandBatch& batch);
+    void enterAlert();
+    void drainCommands();
     bool applyCommand(const Command& cmd);
+    void applyPlan(const phase::Plan& plan);
+    bool enterPlannedPhase(Ticks phaseEnd);
 
-    void updateColorVectorTime(Color color, int newTime);
-    int getDefaultColorTime(Color color) const;
-
-    void adjustTime(uint64_t correctedCentralTime);
-    uint64_t correctCentralTime(uint64_t centralTime);
+    void adjustTime(Ticks phaseEnd);
+    Ticks correctCentralTime(Ticks centralTime);
 
+    bool logs(LogLevel level) const;
     void log(LogLevel level, const std::string& message);
 
 
@@ -63,14 +128,23 @@ private:
     std::thread m_cycleThread;
     std::atomic_bool m_stopFlag{false};
     boost::asio::io_context m_ioCtx;
-    ndn::Face m_face{m_ioCtx};
-    ndn::KeyChain m_keyChain;
+    std::unique_ptr<ndn::Face> m_ownFace;          // vazios com Face e KeyChain injetadas
+    std::unique_ptr<ndn::KeyChain> m_ownKeyChain;
+    ndn::Face& m_face;
+    ndn::KeyChain& m_keyChain;
+    LinkSigner m_signer{m_keyChain};
+    LinkSigner::LinkId m_centralLink = 0;
+    SignedDataCache m_statusCache;
+    std::chrono::steady_clock::time_point m_nextCacheReport;    // thread de I/O
+    uint64_t m_reportedCacheHits = 0;
+    uint64_t m_reportedCacheMisses = 0;
     ndn::ScopedRegisteredPrefixHandle m_certServeHandle;
+    ndn::Name m_certPrefix;                     // /<identidade>/KEY
     ndn::ValidatorConfig m_validator;
-    ndn::Scheduler m_scheduler{m_ioCtx};
+    PacketVerifier m_verifier{m_validator, m_signer};
+    ndn::Scheduler m_scheduler{m_face.getIoContext()};
     std::mutex m_mutex;
-    std::string m_lastCommandContent;
-    std::chrono::steady_clock::time_point m_lastCommandTimestamp;
+    uint64_t m_lastCommandSeq = 0;
  
 
     std::string central;
@@ -87,20 +161,78 @@ private:
     Status intensity;
     int vehicles = 0;
     int full_cicle_vehicles_quantity = 0;
+    TrafficStats m_trafficStats;
     bool isBootStrap = true;
 
-    int time_left = 0;
     uint64_t stateChangeTimestamp = 0;
-
-    std::vector<std::pair<std::string, int>> colors_vector;
-    std::vector<std::pair<std::string, int>> default_colors_vector;
-
-    std::chrono::steady_clock::time_point lastInterestTimestamp_ = steady_clock::now();
+    uint64_t m_statusSeq = 0;
+
+    // Motor de fases: prazos absolutos do steady_clock em ms (Clock.hpp). A
+    // thread de ciclo dorme em m_phaseCv até o próximo prazo ou até chegarem
+    // comandos (em tempo real, com clock_nanosleep em fatias que consultam a
+    // fila); o estado do semáforo e tudo abaixo só são tocados por ela.
+    phase::Durations m_durations;               // durações em vigor, em ms
+    Ticks m_phaseEnd = 0;                       // fim da fase atual (sem efeito em ALERTA)
+    Ticks m_nextTrafficTick = 0;
+    int m_phaseTicks = 0;                       // ticks de tráfego desde o início da fase
+    std::condition_variable m_phaseCv;
+    bool m_commandsPending = false;             // protegido por m_mutex, só para m_phaseCv
+                                                // (fora do modo de tempo real)
+    // Lotes de comandos da thread de I/O para a de ciclo, com os instantes já
+    // convertidos para o relógio local.
+    SpscRing<CommandBatch> m_commandQueue{COMMAND_QUEUE_CAPACITY};
+    Seqlock<LightSnapshot> m_state;
+    // Atraso de cada troca de fase em relação ao prazo, em µs: a janela do log e o
+    // acumulado desde a partida, publicado para a resposta a /<semáforo>/timing.
+    LatencyHistogram m_transitionLateness;
+    LatencyHistogram m_totalLateness;
+    Seqlock<LatencyHistogram> m_publishedLateness;
+    Ticks m_nextLatenessReport = 0;
+    bool m_realTime = false;
+    int m_realTimeCpu = -1;                     // -1: sem afinidade
+    // Simulação: sem thread de ciclo, o motor roda em eventos do m_scheduler
+    // sobre o relógio virtual, e o tráfego sai de uma semente fixa.
+    bool m_simulated = false;
+    ndn::scheduler::ScopedEventId m_phaseStepEvent;
+    std::mt19937 m_rng{std::random_device{}()};     // enableSimulation() troca pela semente
+    static constexpr Ticks TRAFFIC_TICK_MS = 1000;
+    static constexpr Ticks LATENESS_REPORT_MS = 60000;
+    static constexpr int MIN_PHASE_DURATION_MS = 5000;
+    static constexpr size_t COMMAND_QUEUE_CAPACITY = 16;
+    static constexpr int RT_PRIORITY = 80;
+    static constexpr Ticks RT_COMMAND_POLL_MS = 5;
+    static constexpr size_t RT_STACK_PREFAULT_BYTES = 64 * 1024;
+
+    std::chrono::steady_clock::time_point lastInterestTimestamp_ = steadyNow();
 
     LogLevel m_logLevel = LogLevel::NONE;
 
     int m_timeoutCounter = 0;
     static constexpr int TIMEOUT_THRESHOLD = 3;
+    uint64_t m_commandInterestSeq = 0;
+    Ticks m_commandInterestSentAt = 0;          // t1 do Interest de comando pendente
+    // Relógio do orquestrador, estimado pelas respostas aos Interests de comando.
+    ClockSync m_centralClock;
+    Ticks m_lastCentralSentAt = 0;              // t3 e t4 da última resposta, para
+    Ticks m_lastCentralArrival = 0;             // quando ainda não há amostra válida
+    // Próximas fases enviadas pelo orquestrador, com os fins no relógio local.
+    // Da thread de ciclo; sem plano, o ciclo segue m_durations.
+    phase::Plan m_plan;
+    static constexpr ndn::time::milliseconds COMMAND_INTEREST_LIFETIME{4000};
+    static constexpr ndn::time::milliseconds NACK_RETRY_DELAY{1000};
+
+    ProtocolOptions m_protocol;
+    Color m_lastReportedColor = Color::UNKNOWN;
+    float m_lastReportedPriority = 0.0f;
+    std::chrono::steady_clock::time_point m_lastReportTime{};
+    bool m_reportPending = true;
+    // Modo predict: o que o orquestrador prevê a partir da última notificação.
+    phase::Durations m_defaultDurations;
+    Color m_predictedColor = Color::UNKNOWN;
+    Ticks m_predictedEnd = 0;
+    ndn::scheduler::ScopedEventId m_statusCheckEvent;
+    static constexpr ndn::time::milliseconds STATUS_CHECK_INTERVAL{250};
+    static constexpr ndn::time::milliseconds STATUS_REPORT_LIFETIME{2000};
 };
 
 #endif // SMART_TRAFFIC_LIGHT_HPP
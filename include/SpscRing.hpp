@@ -0,0 +1,60 @@
+#ifndef SPSCRING_HPP
+#define SPSCRING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+// Fila circular sem locks para exatamente um produtor e um consumidor (podem ser
+// a mesma thread). A capacidade é arredondada para potência de 2 e push() falha
+// com a fila cheia, sem bloquear.
+template <typename T>
+class SpscRing {
+public:
+  explicit SpscRing(size_t capacity = 2) { reset(capacity); }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // Descarta o conteúdo; só pode ser chamada antes de produtor e consumidor começarem.
+  void reset(size_t capacity) {
+    m_capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    m_items = std::make_unique<T[]>(m_capacity);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+  }
+
+  // Produtor.
+  bool push(const T& item) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == m_capacity) {
+      return false;
+    }
+    m_items[tail & (m_capacity - 1)] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumidor.
+  bool pop(T& out) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    out = m_items[head & (m_capacity - 1)];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return m_capacity; }
+
+private:
+  alignas(64) std::atomic<size_t> m_head{0};   // escrito só pelo consumidor
+  alignas(64) std::atomic<size_t> m_tail{0};   // escrito só pelo produtor
+  std::unique_ptr<T[]> m_items;
+  size_t m_capacity = 0;
+};
+
+#endif // SPSCRING_HPP
@@ -0,0 +1,192 @@
+#ifndef STATUSCODEC_HPP
+#define STATUSCODEC_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Enums.hpp"
+
+// =================================================================================
+// Payload de estado do semáforo (resposta a /<semáforo>)
+//
+// StatusPayload = STATUS-TYPE 46
+//                 Version     (1 B)  versão do layout, hoje STATUS_VERSION
+//                 Phase       (1 B)  Color
+//                 RemainingMs (4 B)  big-endian
+//                 Priority    (4 B)  float IEEE-754, big-endian
+//                 QueueLength (2 B)  veículos parados, big-endian
+//                 Sequence    (8 B)  contador de respostas do semáforo, big-endian
+//                 ClockOffset (8 B)  v2: relógio do orquestrador - relógio do semáforo, ms
+//                 ClockError  (2 B)  v2: limite do erro do offset, ms; 0xFFFF sem sincronia
+//                 PhaseEnd    (8 B)  v3: fim da fase no relógio do orquestrador, ms; 0 sem
+//                                    sincronia ou fora do ciclo
+//
+// Todos os tipos estão na faixa de aplicação do NDN-TLV (128-252) e cada campo tem
+// tamanho fixo, então a codificação cabe num buffer na pilha e a decodificação lê
+// direto do conteúdo do Data. Versões futuras só podem acrescentar campos ao final.
+// =================================================================================
+namespace status {
+
+namespace tlv {
+  constexpr uint8_t StatusPayload = 200;
+  constexpr uint8_t Version = 201;
+  constexpr uint8_t Phase = 202;
+  constexpr uint8_t RemainingMs = 203;
+  constexpr uint8_t Priority = 204;
+  constexpr uint8_t QueueLength = 205;
+  constexpr uint8_t Sequence = 206;
+  constexpr uint8_t AggregateEntry = 207;
+  constexpr uint8_t LightSuffix = 208;
+  constexpr uint8_t RegionSummary = 209;
+  constexpr uint8_t LightCount = 213;
+  constexpr uint8_t AveragePriority = 214;
+  constexpr uint8_t ClockOffset = 217;
+  constexpr uint8_t ClockError = 218;
+  constexpr uint8_t TimingPayload = 221;
+  constexpr uint8_t RealTime = 222;
+  constexpr uint8_t MaxLatenessUs = 223;
+  constexpr uint8_t LatenessBucket = 224;
+  constexpr uint8_t PhaseEnd = 225;
+}
+
+constexpr uint8_t STATUS_VERSION = 3;
+constexpr size_t STATUS_V1_VALUE_SIZE = (2 + 1) + (2 + 1) + (2 + 4) + (2 + 4) + (2 + 2) + (2 + 8);
+constexpr size_t STATUS_V2_VALUE_SIZE = STATUS_V1_VALUE_SIZE + (2 + 8) + (2 + 2);
+constexpr size_t STATUS_VALUE_SIZE = STATUS_V2_VALUE_SIZE + (2 + 8);
+constexpr size_t STATUS_WIRE_SIZE = 2 + STATUS_VALUE_SIZE;
+
+// Componente de nome que pede a resposta em texto ("STATE|remainingMs|priority"),
+// mantida apenas para depuração.
+constexpr std::string_view TEXT_COMPONENT = "txt";
+
+constexpr uint16_t CLOCK_UNSYNCED = 0xFFFF;
+
+// /<semáforo>/KEY: o certificado de assinatura do semáforo, no conteúdo de um Data.
+// Um nome fixo, sem o id da chave; e tem rota mesmo quando o semáforo assina com
+// /app, na falta da identidade gerada por config/make-keys.sh.
+constexpr std::string_view CERT_COMPONENT = "KEY";
+
+struct StatusReport {
+  Color phase = Color::UNKNOWN;
+  uint32_t remainingMs = 0;
+  float priority = 0.0f;
+  uint16_t queueLength = 0;
+  uint64_t sequence = 0;
+  int64_t clockOffsetMs = 0;
+  uint16_t clockErrorMs = CLOCK_UNSYNCED;   // v1 não traz sincronia
+  int64_t phaseEnd = 0;                      // v3: 0 se o tempo restante é o que vale
+};
+
+using StatusBuffer = std::array<uint8_t, STATUS_WIRE_SIZE>;
+
+// Codifica sem alocação; retorna o número de bytes escritos.
+size_t encode(const StatusReport& report, StatusBuffer& out);
+
+// Decodifica o payload binário direto dos bytes do conteúdo (sem cópia).
+std::optional<StatusReport> decode(std::span<const uint8_t> wire);
+
+bool isBinary(std::span<const uint8_t> wire);
+
+// Formato textual legado.
+std::string encodeText(const StatusReport& report);
+std::optional<StatusReport> decodeText(std::string_view text);
+
+// Chave da resposta de estado no SignedDataCache do semáforo: só os campos que
+// não mudam sozinhos dentro de uma fase (fase, fim dela no relógio local,
+// prioridade, fila e se há sincronia). O tempo restante e o erro da sincronia
+// mudam a cada consulta e ficam de fora, e o deslocamento do relógio entra
+// arredondado para REPLY_CLOCK_QUANTUM_MS. Uma resposta reaproveitada traz esses
+// campos de quando foi assinada, no máximo um período de frescor (1 s) antes; o
+// orquestrador usa o PhaseEnd, absoluto, e não o tempo restante, então o fim da
+// fase que ele calcula não envelhece com ela. Sem sincronia não há PhaseEnd, e o
+// semáforo não reaproveita a resposta.
+constexpr int64_t REPLY_CLOCK_QUANTUM_MS = 5;
+
+using ReplyKey = std::array<uint8_t, 1 + 8 + 4 + 2 + 1 + 8>;
+
+ReplyKey replyKey(const StatusReport& report, int64_t phaseEnd);
+
+// =================================================================================
+// Agregado regional (resposta a /<região>/_agg/<versão>/<segmento>)
+//
+// Cada segmento é uma sequência de entradas completas, decodificável sozinho:
+//
+// AggregateEntry = AGGREGATE-ENTRY-TYPE TLV-LENGTH
+//                  LightSuffix    nome do semáforo relativo à região ("/s-cabula/1")
+//                  StatusPayload  como acima
+// =================================================================================
+constexpr size_t AGGREGATE_SEGMENT_SIZE = 4096;
+constexpr size_t MAX_LIGHT_SUFFIX_SIZE = 252 - 2 - STATUS_WIRE_SIZE;
+static_assert(2 + MAX_LIGHT_SUFFIX_SIZE + STATUS_WIRE_SIZE < 253, "o TLV-LENGTH da entrada ocupa um byte");
+
+// Acrescenta uma entrada ao segmento; false se ela não cabe em maxSize bytes
+// ou se o sufixo é longo demais.
+bool appendAggregateEntry(std::vector<uint8_t>& segment, std::string_view suffix,
+                          const StatusReport& report, size_t maxSize = AGGREGATE_SEGMENT_SIZE);
+
+// Os sufixos apontam para dentro de wire, que precisa sobreviver às entradas.
+bool decodeAggregate(std::span<const uint8_t> wire,
+                     std::vector<std::pair<std::string_view, StatusReport>>& entries);
+
+// =================================================================================
+// Resumo de um orquestrador regional (resposta a /<região>/_orch/summary/<versão>/<segmento>)
+//
+// Um único segmento: o resumo da região seguido das entradas do agregado, uma por
+// semáforo de fronteira (os que a cidade coordena).
+//
+// RegionSummary = REGION-SUMMARY-TYPE 12
+//                 LightCount      (4 B)  semáforos da região, big-endian
+//                 AveragePriority (4 B)  float IEEE-754, big-endian
+// =================================================================================
+struct RegionSummary {
+  uint32_t lightCount = 0;
+  float averagePriority = 0.0f;
+};
+
+constexpr size_t REGION_SUMMARY_WIRE_SIZE = 2 + (2 + 4) + (2 + 4);
+constexpr size_t REGION_SUMMARY_MAX_SIZE = 8000;   // cabe num pacote NDN
+
+// Começa um segmento de resumo; as entradas vêm com appendAggregateEntry().
+void appendRegionSummary(std::vector<uint8_t>& segment, const RegionSummary& summary);
+
+bool decodeRegionSummary(std::span<const uint8_t> wire, RegionSummary& summary,
+                         std::vector<std::pair<std::string_view, StatusReport>>& entries);
+
+// =================================================================================
+// Atraso das trocas de fase do semáforo (resposta a /<semáforo>/timing)
+//
+// TimingPayload = TIMING-PAYLOAD-TYPE TLV-LENGTH
+//                 RealTime       (1 B)  1 se o ciclo roda no modo tempo real
+//                 MaxLatenessUs  (8 B)  maior atraso desde a partida, µs
+//                 LatenessBucket (4 B)  × TIMING_BUCKETS: trocas desde a partida com
+//                                       atraso em [2^(b-1), 2^b) µs, como LatencyHistogram
+//
+// As contagens são acumuladas: quem consulta tira a diferença entre duas respostas.
+// =================================================================================
+constexpr size_t TIMING_BUCKETS = 24;
+constexpr size_t TIMING_VALUE_SIZE = (2 + 1) + (2 + 8) + TIMING_BUCKETS * (2 + 4);
+constexpr size_t TIMING_WIRE_SIZE = 2 + TIMING_VALUE_SIZE;
+static_assert(TIMING_VALUE_SIZE < 253, "o TLV-LENGTH ocupa um byte");
+
+constexpr std::string_view TIMING_COMPONENT = "timing";
+
+struct TimingReport {
+  bool realTime = false;
+  uint64_t maxLatenessUs = 0;
+  std::array<uint32_t, TIMING_BUCKETS> buckets{};
+};
+
+using TimingBuffer = std::array<uint8_t, TIMING_WIRE_SIZE>;
+
+size_t encodeTiming(const TimingReport& report, TimingBuffer& out);
+std::optional<TimingReport> decodeTiming(std::span<const uint8_t> wire);
+
+} // namespace status
+
+#endif // STATUSCODEC_HPP
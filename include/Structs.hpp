@@ -5,31 +5,20 @@
 #include <chrono>
 #include <algorithm>
 #include "Enums.hpp"
+#include "Clock.hpp"
+#include "CommandCodec.hpp"
 
+// Dados frios de cada semáforo (configuração e comando pendente). O estado
+// consultado a cada ciclo do orquestrador fica em LightStateTable.
 struct TrafficLightState {
     std::string name;
-    std::string state = "RED";
+    Color state = Color::RED;
     int cycle;
-    std::chrono::steady_clock::time_point endTime;
-    float priority = 0;
-    std::string command;
-    int timeOutCounter = 0;
+    Ticks endTime = 0;
+    CommandBatch command;
     int columns = 0;
     int lines = 0;
     Status intensity = Status::NONE; 
-    std::pair<int, bool> adjustment_state{0, true}; 
-    bool partOfIntersection = false;
-    bool partOfGreenWave = false;
-    bool partOfSyncGroup = false;
-
-
-    bool isUnknown() const {
-        return state == "UNKNOWN";
-    }
-
-    bool isAlert() const {
-        return state == "ALERT";
-    }
 };
 
 struct Intersection {
@@ -43,11 +32,6 @@ struct Intersection {
     }
 };
 
-struct Command {
-    std::string type;
-    std::string value;
-};
-
 struct GreenWaveGroup {
     std::string name;
     std::vector<std::string> trafficLightNames;
@@ -58,4 +42,60 @@ struct GreenWaveGroup {
 struct SyncGroup {
     std::string name;
     std::vector<std::string> trafficLightNames;
-};
\ No newline at end of file
+};
+
+// Agregador regional: publica o estado de todos os semáforos sob `region`.
+struct AggregatorConfig {
+    std::string region;
+};
+
+// Região com orquestrador próprio (seção `regions:`): roda o motor de regras para
+// os semáforos sob `prefix` e responde ao orquestrador da cidade em /<prefix>/_orch.
+struct RegionConfig {
+    std::string prefix;
+
+    bool covers(const std::string& lightName) const {
+        return lightName.size() > prefix.size() && lightName.compare(0, prefix.size(), prefix) == 0 &&
+               lightName[prefix.size()] == '/';
+    }
+};
+
+// Papel do orquestrador na hierarquia; vazio quando há um único orquestrador.
+struct HierarchyRole {
+    // Orquestrador regional: prefixo da região, prefixo da cidade e os semáforos
+    // da região que a cidade coordena, reportados no resumo.
+    std::string region;
+    std::string upstream;
+    std::vector<std::string> boundaryLights;
+    // Orquestrador da cidade: regiões com orquestrador próprio e o total de
+    // semáforos de cada uma.
+    std::vector<std::pair<std::string, uint32_t>> subRegions;
+};
+
+// Opções de protocolo lidas da seção opcional `protocol:` do cenário.
+struct ProtocolOptions {
+    bool textStatus = false;    // pede o estado no formato texto legado (depuração)
+    StatusMode statusMode = StatusMode::POLL;
+    int heartbeatMs = 10000;            // intervalo máximo entre notificações no modo push
+    float priorityReportDelta = 1.0f;   // variação de prioridade que dispara uma notificação
+    int predictionToleranceMs = 1500;   // desvio do fim de fase previsto que dispara uma notificação
+    SigningMode signing = SigningMode::ASYMMETRIC;
+    std::string hmacSecretFile = "config/link-secret.key";
+    std::string trustSchema = "config/trust-schema.conf";   // regras do modo asymmetric
+};
+
+// Parâmetros das regras de controle, da seção opcional `orchestrator.control:`.
+struct ControlParams {
+    int greenBaseTimeMs = 15000;            // verde do líder ao forçar o início de um cruzamento
+    int recoveryRedTimeMs = 5000;           // vermelho de normalização de um cruzamento
+    double lowPriorityWaveFactor = 0.75;    // fração do verde da onda para o membro menos prioritário
+    int adjustmentMs = 5000;                // passo de cada ajuste de prioridade
+    int maxAdjustments = 3;                 // ajustes seguidos na mesma direção
+};
+
+// Opções do orquestrador lidas da seção opcional `orchestrator:` do cenário.
+struct OrchestratorOptions {
+    EngineMode engine = EngineMode::EVENT;
+    int workers = 1;                    // threads do motor de regras; 0 = uma por núcleo
+    ControlParams control;
+};
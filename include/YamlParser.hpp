@@ -16,8 +16,18 @@ public:
     const std::map<std::string, Intersection>& getIntersections() const;
     const std::vector<GreenWaveGroup>& getGreenWaves() const;
     const std::vector<SyncGroup>& getSyncGroups() const;
+    const std::vector<AggregatorConfig>& getAggregators() const;
+    const std::vector<RegionConfig>& getRegions() const;
+    // Índice da região com orquestrador próprio que contém o semáforo, ou -1.
+    int getRegionIndexOf(const std::string& lightName) const;
+    const ProtocolOptions& getProtocolOptions() const;
+    const OrchestratorOptions& getOrchestratorOptions() const;
     std::optional<TrafficLightState> getTrafficLightByIndex(int index) const;
 
+    // Lê e valida as chaves de `orchestrator.control` presentes em `node`; as
+    // ausentes ficam como estão em `params`. Também usado pela grade do sweep.
+    static void parseControl(const YAML::Node& node, ControlParams& params);
+
 private:
     void parse(const YAML::Node& config);
 
@@ -26,4 +36,8 @@ private:
     std::map<std::string, Intersection> intersections;
     std::vector<GreenWaveGroup> greenWaves;
     std::vector<SyncGroup> syncGroups;
+    std::vector<AggregatorConfig> aggregators;
+    std::vector<RegionConfig> regions;
+    ProtocolOptions protocol;
+    OrchestratorOptions orchestrator;
 };
\ No newline at end of file
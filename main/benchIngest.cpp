@@ -0,0 +1,140 @@
+#include "../include/LatencyHistogram.hpp"
+#include "../include/LightStateTable.hpp"
+#include "../include/SpscRing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Latência dos callbacks de I/O do orquestrador enquanto o motor de regras roda
+// passagens sobre 100k semáforos. Compara o modelo antigo, em que callback e
+// passagem dividem um mutex (espera pelo lock e duração do callback), com a fila
+// SPSC sem locks que a thread de I/O usa hoje para repassar estados ao motor.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t LIGHTS = 100'000;
+constexpr auto DURATION = std::chrono::seconds(2);
+constexpr auto CALLBACK_INTERVAL = std::chrono::microseconds(100);
+constexpr auto ENGINE_IDLE = std::chrono::milliseconds(1);
+
+struct Update {
+    LightId id = 0;
+    float priority = 0.0f;
+    Color color = Color::RED;
+};
+
+uint64_t usSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+// Varreduras do motor com o mesmo custo das do ciclo real.
+void enginePass(LightStateTable& table, std::vector<int8_t>& trend) {
+    for (int i = 0; i < 10; ++i) {
+        table.classifyPriorities(table.averagePriority(), trend);
+    }
+}
+
+void apply(LightStateTable& table, const Update& update) {
+    table.setPriority(update.id, update.priority);
+    table.color[update.id] = update.color;
+}
+
+// Chama `io` a cada CALLBACK_INTERVAL enquanto outra thread repete `engine`.
+template <typename Io, typename Engine>
+void runFor(Io&& io, Engine&& engine) {
+    std::atomic_bool stop{false};
+    std::thread engineThread([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            engine();
+            std::this_thread::sleep_for(ENGINE_IDLE);
+        }
+    });
+    const auto end = Clock::now() + DURATION;
+    for (uint32_t i = 0; Clock::now() < end; ++i) {
+        io(i);
+        std::this_thread::sleep_for(CALLBACK_INTERVAL);
+    }
+    stop = true;
+    engineThread.join();
+}
+
+void printRow(const char* variant, const LatencyHistogram& h) {
+    std::printf("%s,%llu,%llu,%llu,%llu,%llu\n", variant,
+                static_cast<unsigned long long>(h.count()),
+                static_cast<unsigned long long>(h.percentile(0.5)),
+                static_cast<unsigned long long>(h.percentile(0.9)),
+                static_cast<unsigned long long>(h.percentile(0.99)),
+                static_cast<unsigned long long>(h.max()));
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<LightId> light(0, LIGHTS - 1);
+    std::uniform_real_distribution<float> prio(0.0f, 20.0f);
+    std::uniform_int_distribution<int> color(0, 2);
+    std::vector<Update> updates(1 << 16);
+    for (auto& update : updates) {
+        update = {light(rng), prio(rng), static_cast<Color>(color(rng))};
+    }
+    const uint32_t mask = static_cast<uint32_t>(updates.size() - 1);
+
+    std::printf("variant,samples,p50_us,p90_us,p99_us,max_us\n");
+    {
+        LightStateTable table;
+        table.resize(LIGHTS);
+        std::vector<int8_t> trend;
+        std::mutex mutex;
+        LatencyHistogram wait;
+        LatencyHistogram callback;
+        runFor([&](uint32_t i) {
+                   const auto start = Clock::now();
+                   std::lock_guard<std::mutex> lock(mutex);
+                   wait.record(usSince(start));
+                   apply(table, updates[i & mask]);
+                   callback.record(usSince(start));
+               },
+               [&] {
+                   std::lock_guard<std::mutex> lock(mutex);
+                   enginePass(table, trend);
+               });
+        printRow("mutex_lock_wait", wait);
+        printRow("mutex_callback", callback);
+    }
+    {
+        LightStateTable table;
+        table.resize(LIGHTS);
+        std::vector<int8_t> trend;
+        SpscRing<Update> ring(4096);
+        LatencyHistogram callback;
+        uint64_t drops = 0;
+        runFor([&](uint32_t i) {
+                   const auto start = Clock::now();
+                   if (!ring.push(updates[i & mask])) {
+                       drops++;
+                   }
+                   callback.record(usSince(start));
+               },
+               [&] {
+                   Update update;
+                   while (ring.pop(update)) {
+                       apply(table, update);
+                   }
+                   enginePass(table, trend);
+               });
+        printRow("spsc_callback", callback);
+        if (drops > 0) {
+            std::fprintf(stderr, "%llu estados descartados com a fila cheia\n", static_cast<unsigned long long>(drops));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "../include/Clock.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include "../include/RealTime.hpp"
+#include "../include/SpscRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+// Como a thread de ciclo do semáforo em tempo real espera: compara a espera
+// antiga, na variável de condição até RT_FINAL_APPROACH_MS antes da troca e
+// clock_nanosleep no resto, com a atual, só clock_nanosleep em prazos absolutos
+// consultando a fila de comandos a cada fatia. Mede o atraso de cada troca em
+// relação ao prazo, o tempo entre um lote entrar na fila e a thread de ciclo o
+// tirar, e quantas vezes a thread acordou. Com `rt` ou `rt:<núcleo>` a thread de
+// ciclo roda como no semáforo em tempo real (SCHED_FIFO, mlockall, afinidade).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto DURATION = std::chrono::seconds(10);
+constexpr Ticks PHASE_MS = 50;
+constexpr Ticks FINAL_APPROACH_MS = 2;      // a aproximação final da espera antiga
+constexpr Ticks COMMAND_POLL_MS = 5;        // SmartTrafficLight::RT_COMMAND_POLL_MS
+constexpr int MIN_COMMAND_GAP_MS = 20;
+constexpr int MAX_COMMAND_GAP_MS = 200;
+
+struct Stats {
+    LatencyHistogram lateness;
+    LatencyHistogram pickup;
+    uint64_t wakeups = 0;
+};
+
+uint64_t usSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+Clock::time_point deadline(Ticks ticks) {
+    return Clock::time_point(std::chrono::milliseconds(ticks));
+}
+
+// Estado compartilhado entre a thread de "I/O", que enfileira lotes com o
+// instante de entrada, e a de ciclo.
+struct Channel {
+    SpscRing<Clock::time_point> queue{16};
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool pending = false;
+    std::atomic_bool stop{false};
+};
+
+// Uma volta do motor de fases: esvazia a fila e troca a fase se o prazo passou.
+// Devolve o próximo prazo.
+Ticks engineTurn(Channel& channel, Stats& stats, Ticks& phaseEnd) {
+    Clock::time_point enqueued;
+    while (channel.queue.pop(enqueued)) {
+        stats.pickup.record(usSince(enqueued));
+    }
+    const auto now = Clock::now();
+    if (deadline(phaseEnd) <= now) {
+        stats.lateness.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - deadline(phaseEnd)).count()));
+        phaseEnd += PHASE_MS;
+    }
+    return phaseEnd;
+}
+
+void condvarLoop(Channel& channel, Stats& stats) {
+    Ticks phaseEnd = nowTicks() + PHASE_MS;
+    while (!channel.stop) {
+        Ticks wake = engineTurn(channel, stats, phaseEnd);
+        ++stats.wakeups;
+        if (wake - nowTicks() <= FINAL_APPROACH_MS) {
+            rt::sleepUntil(wake);
+            continue;
+        }
+        wake -= FINAL_APPROACH_MS;
+        std::unique_lock<std::mutex> lock(channel.mutex);
+        channel.cv.wait_until(lock, deadline(wake), [&] { return channel.pending || channel.stop.load(); });
+        channel.pending = false;
+    }
+}
+
+void pollLoop(Channel& channel, Stats& stats) {
+    Ticks phaseEnd = nowTicks() + PHASE_MS;
+    while (!channel.stop) {
+        const Ticks wake = engineTurn(channel, stats, phaseEnd);
+        ++stats.wakeups;
+        rt::sleepUntil(std::min(wake, nowTicks() + COMMAND_POLL_MS));
+    }
+}
+
+template <typename Loop>
+Stats run(Loop&& loop, bool notify, bool realTime, int cpu) {
+    Channel channel;
+    Stats stats;
+    std::thread cycleThread([&] {
+        std::string error;
+        if (realTime) {
+            if (cpu >= 0 && !rt::pinToCpu(cpu, error)) std::fprintf(stderr, "%s\n", error.c_str());
+            if (!rt::lockMemory(error)) std::fprintf(stderr, "%s\n", error.c_str());
+            if (!rt::setFifoPriority(80, error)) std::fprintf(stderr, "%s\n", error.c_str());
+        }
+        loop(channel, stats);
+    });
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> gap(MIN_COMMAND_GAP_MS, MAX_COMMAND_GAP_MS);
+    const auto end = Clock::now() + DURATION;
+    while (Clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(gap(rng)));
+        channel.queue.push(Clock::now());
+        if (notify) {
+            {
+                std::lock_guard<std::mutex> lock(channel.mutex);
+                channel.pending = true;
+            }
+            channel.cv.notify_one();
+        }
+    }
+    channel.stop = true;
+    channel.cv.notify_all();
+    cycleThread.join();
+    return stats;
+}
+
+void printRow(const char* variant, const char* metric, const LatencyHistogram& h, uint64_t wakeups) {
+    std::printf("%s,%s,%llu,%llu,%llu,%llu,%llu\n", variant, metric,
+                static_cast<unsigned long long>(h.count()),
+                static_cast<unsigned long long>(h.percentile(0.5)),
+                static_cast<unsigned long long>(h.percentile(0.99)),
+                static_cast<unsigned long long>(h.max()),
+                static_cast<unsigned long long>(wakeups));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool realTime = false;
+    int cpu = -1;
+    if (argc >= 2 && std::strncmp(argv[1], "rt", 2) == 0) {
+        realTime = true;
+        if (argv[1][2] == ':') {
+            cpu = std::stoi(argv[1] + 3);
+        }
+    }
+
+    std::printf("variant,metric,samples,p50_us,p99_us,max_us,wakeups\n");
+    const Stats condvar = run(condvarLoop, true, realTime, cpu);
+    printRow("condvar", "lateness", condvar.lateness, condvar.wakeups);
+    printRow("condvar", "pickup", condvar.pickup, condvar.wakeups);
+    const Stats poll = run(pollLoop, false, realTime, cpu);
+    printRow("nanosleep_poll", "lateness", poll.lateness, poll.wakeups);
+    printRow("nanosleep_poll", "pickup", poll.pickup, poll.wakeups);
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "../include/LightRegistry.hpp"
+#include "../include/LightStateTable.hpp"
+#include "../include/ShardPartition.hpp"
+#include "../include/ShardPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Escala do motor de regras com o número de workers num cenário sintético de
+// 50k semáforos: componentes de 2 a 64 semáforos formados por cruzamentos de
+// dois semáforos, uma onda verde ligando os cruzamentos do componente e grupos
+// de sincronia entre cruzamentos vizinhos. Cada passagem avalia todos os grupos
+// de todos os shards com o trabalho típico das regras (lista de prioridades do
+// cruzamento, fase ativa, diferença de tempo restante, histerese de prioridade).
+
+namespace {
+
+constexpr size_t LIGHTS = 50'000;
+constexpr size_t SHARDS_PER_WORKER = 4;   // como config::SHARDS_PER_WORKER
+constexpr int PASSES = 50;
+
+struct Topology {
+    std::vector<std::string> names;
+    std::vector<Intersection> intersections;
+    std::vector<GreenWaveGroup> waves;
+    std::vector<SyncGroup> syncGroups;
+};
+
+Topology makeTopology(std::mt19937& rng) {
+    Topology topo;
+    std::uniform_int_distribution<size_t> pairs(1, 32);
+    size_t component = 0;
+    while (topo.names.size() < LIGHTS) {
+        const size_t count = std::min(pairs(rng), (LIGHTS - topo.names.size()) / 2);
+        if (count == 0) break;
+        GreenWaveGroup wave;
+        wave.name = "onda-" + std::to_string(component);
+        wave.travelTimeMs = 4000;
+        for (size_t p = 0; p < count; ++p) {
+            const std::string base = "/ssa/bench/c-" + std::to_string(component) + "/x-" + std::to_string(p);
+            topo.names.push_back(base + "/0");
+            topo.names.push_back(base + "/1");
+            Intersection cross;
+            cross.name = base;
+            cross.trafficLightNames = {base + "/0", base + "/1"};
+            topo.intersections.push_back(cross);
+            wave.trafficLightNames.push_back(base + "/0");
+            if (p % 4 == 3) {
+                SyncGroup sync;
+                sync.name = base + "/sync";
+                sync.trafficLightNames = {base + "/1", topo.names[topo.names.size() - 3]};
+                topo.syncGroups.push_back(sync);
+            }
+        }
+        if (wave.trafficLightNames.size() > 1) {
+            topo.waves.push_back(wave);
+        }
+        component++;
+    }
+    return topo;
+}
+
+struct Engine {
+    const LightRegistry& registry;
+    LightStateTable& table;
+    std::vector<std::vector<std::pair<LightId, float>>> sorted;
+    std::vector<LightId> active;
+    std::vector<int> adjust;
+
+    Engine(const LightRegistry& r, LightStateTable& t)
+        : registry(r), table(t), sorted(r.intersectionCount()), active(r.intersectionCount()),
+          adjust(t.size()) {}
+
+    void intersection(GroupId g, Ticks now) {
+        auto& list = sorted[g];
+        list.clear();
+        active[g] = INVALID_LIGHT;
+        for (LightId id : registry.intersectionMembers(g)) {
+            list.emplace_back(id, table.priority[id]);
+            if (table.isActive(id)) active[g] = id;
+        }
+        std::sort(list.begin(), list.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (active[g] == INVALID_LIGHT) return;
+        for (LightId id : registry.intersectionMembers(g)) {
+            if (id != active[g] && std::abs(table.remainingMs(id, now) - table.remainingMs(active[g], now)) > 2000) {
+                table.endTime[id] = table.endTime[active[g]];
+            }
+        }
+    }
+
+    void wave(GroupId g, Ticks now) {
+        const auto& members = registry.waveMembers(g);
+        const int leaderRemaining = table.remainingMs(members.front(), now);
+        for (size_t i = 1; i < members.size(); ++i) {
+            const LightId competitor = registry.competitorOf(members[i]);
+            const bool low = competitor != INVALID_LIGHT && table.priority[members[i]] < table.priority[competitor];
+            adjust[members[i]] = static_cast<int>(leaderRemaining * (low ? 0.75 : 1.0)) + static_cast<int>(i) * 4000;
+        }
+    }
+
+    void sync(GroupId g, Ticks now) {
+        const auto& members = registry.syncGroupMembers(g);
+        for (size_t i = 1; i < members.size(); ++i) {
+            if (table.color[members[i]] != table.color[members.front()] &&
+                std::abs(table.remainingMs(members[i], now) - table.remainingMs(members.front(), now)) > 1000) {
+                table.endTime[members[i]] = table.endTime[members.front()];
+            }
+        }
+    }
+
+    void priorities(const Shard& shard, float average) {
+        for (LightId id : shard.lights) {
+            const float p = table.priority[id];
+            const int trend = (p > average) - (p < average);
+            auto& count = table.adjustCount[id];
+            if (trend != 0 && count < 3) count++;
+            table.adjustGaining[id] = trend > 0;
+        }
+    }
+
+    void pass(const Shard& shard, float average, Ticks now) {
+        for (GroupId g : shard.syncGroups) sync(g, now);
+        priorities(shard, average);
+        for (GroupId g : shard.intersections) intersection(g, now);
+        for (GroupId g : shard.waves) wave(g, now);
+    }
+};
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    const Topology topo = makeTopology(rng);
+    LightRegistry registry;
+    registry.build(topo.names, topo.intersections, topo.waves, topo.syncGroups);
+
+    LightStateTable table;
+    table.resize(topo.names.size());
+    std::uniform_real_distribution<float> prio(0.0f, 20.0f);
+    std::uniform_int_distribution<int> color(0, 2);
+    std::uniform_int_distribution<int> remaining(0, 30000);
+    for (LightId id = 0; id < table.size(); ++id) {
+        table.setPriority(id, prio(rng));
+        table.color[id] = static_cast<Color>(color(rng));
+        table.endTime[id] = remaining(rng);
+    }
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> workerCounts;
+    for (size_t w = 1; w < cores; w *= 2) workerCounts.push_back(w);
+    workerCounts.push_back(cores);
+
+    std::printf("workers,shards,components,us_per_pass,speedup\n");
+    double baseline = 0.0;
+    for (size_t workers : workerCounts) {
+        ShardPartition partition;
+        partition.build(registry, workers > 1 ? workers * SHARDS_PER_WORKER : 1);
+        ShardPool pool(workers);
+        Engine engine(registry, table);
+        const float average = table.averagePriority();
+        const auto task = [&](size_t s) { engine.pass(partition.shards()[s], average, 0); };
+
+        pool.run(partition.size(), task);   // aquecimento
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < PASSES; ++i) {
+            pool.run(partition.size(), task);
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / PASSES;
+        if (workers == 1) baseline = us;
+        std::printf("%zu,%zu,%zu,%.0f,%.2f\n", workers, partition.size(), partition.componentCount(), us, baseline / us);
+    }
+    return 0;
+}
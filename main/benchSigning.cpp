@@ -0,0 +1,92 @@
+#include "../include/LinkSigner.hpp"
+#include "../include/StatusCodec.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Vazão de assinatura de um Data de estado (34 B) em cada modo de LinkSigner, e o
+// custo de reenviar um Data já assinado a partir do SignedDataCache. Usa um
+// KeyChain em memória, sem tocar no PIB/TPM do usuário. A fração das consultas
+// que o cache atende é verificada em tests/testReplyCache.cpp.
+
+namespace {
+
+template <typename F>
+double nsPerOp(int iterations, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+std::shared_ptr<ndn::Data> makeStatusData(int i) {
+    status::StatusReport report;
+    report.phase = static_cast<Color>(i % 3);
+    report.remainingMs = static_cast<uint32_t>(1000 * (i % 60));
+    report.priority = 0.5f * static_cast<float>(i % 40);
+    report.sequence = static_cast<uint64_t>(i);
+
+    status::StatusBuffer buffer;
+    size_t length = status::encode(report, buffer);
+    auto data = std::make_shared<ndn::Data>(ndn::Name("/ssa/r-bench/s-bench/1").appendSequenceNumber(i));
+    data->setContent(ndn::make_span(buffer.data(), length));
+    data->setFreshnessPeriod(ndn::time::seconds(1));
+    return data;
+}
+
+} // namespace
+
+int main() {
+    ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+    keyChain.setDefaultIdentity(keyChain.createIdentity("/bench"));
+
+    const std::string secretFile = "/tmp/benchSigning.secret";
+    std::ofstream(secretFile) << "bench-secret-0123456789abcdef";
+
+    struct Mode { const char* name; SigningMode mode; int iterations; };
+    const Mode modes[] = {
+        {"asymmetric", SigningMode::ASYMMETRIC, 2'000},
+        {"hmac", SigningMode::HMAC, 50'000},
+        {"digest", SigningMode::DIGEST, 50'000},
+    };
+
+    volatile size_t sink = 0;
+    std::printf("mode,ns_per_data,data_per_s\n");
+    for (const auto& mode : modes) {
+        LinkSigner signer(keyChain);
+        signer.configure(mode.mode, secretFile);
+        auto link = signer.addLink("/ssa/r-bench/s-bench/1");
+
+        double ns = nsPerOp(mode.iterations, [&](int i) {
+            auto data = makeStatusData(i);
+            signer.sign(*data, link);
+            sink = sink + data->wireEncode().size();
+        });
+        std::printf("%s,%.1f,%.0f\n", mode.name, ns, 1e9 / ns);
+    }
+
+    // Mesmo nome e mesmo conteúdo dentro do frescor: nenhuma assinatura nova.
+    SignedDataCache cache;
+    LinkSigner signer(keyChain);
+    signer.configure(SigningMode::ASYMMETRIC, secretFile);
+    auto link = signer.addLink("/ssa/r-bench/s-bench/1");
+    auto data = makeStatusData(0);
+    signer.sign(*data, link);
+    const auto& content = data->getContent();
+    const std::span<const uint8_t> bytes(content.value(), content.value_size());
+    cache.insert(data, bytes, SignedDataCache::Clock::now());
+
+    double cachedNs = nsPerOp(1'000'000, [&](int) {
+        auto hit = cache.find(data->getName(), bytes, SignedDataCache::Clock::now());
+        sink = sink + hit->wireEncode().size();
+    });
+    std::printf("cache_hit,%.1f,%.0f\n", cachedNs, 1e9 / cachedNs);
+
+    std::filesystem::remove(secretFile);
+    return 0;
+}
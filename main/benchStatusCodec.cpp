@@ -0,0 +1,86 @@
+#include "../include/StatusCodec.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compara o custo por mensagem do payload de estado: o caminho textual antigo
+// (ostringstream no semáforo; cópia para std::string, getline e stoi/stof no
+// orquestrador) contra o TLV binário de layout fixo.
+
+namespace {
+
+template <typename F>
+double nsPerOp(int iterations, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+status::StatusReport sample(int i) {
+    status::StatusReport report;
+    report.phase = static_cast<Color>(i % 3);
+    report.remainingMs = static_cast<uint32_t>(1000 * (i % 60));
+    report.priority = 0.5f * static_cast<float>(i % 40);
+    report.queueLength = static_cast<uint16_t>(i % 12);
+    report.sequence = static_cast<uint64_t>(i);
+    return report;
+}
+
+} // namespace
+
+int main() {
+    constexpr int ITERATIONS = 1'000'000;
+    volatile uint64_t sink = 0;
+
+    double legacyEncode = nsPerOp(ITERATIONS, [&](int i) {
+        auto report = sample(i);
+        std::ostringstream oss;
+        oss << ToString(report.phase) << "|" << report.remainingMs << "|" << report.priority;
+        std::string content = oss.str();
+        sink = sink + content.size();
+    });
+
+    std::vector<std::string> texts;
+    for (int i = 0; i < 1024; ++i) {
+        texts.push_back(status::encodeText(sample(i)));
+    }
+    double legacyDecode = nsPerOp(ITERATIONS, [&](int i) {
+        const std::string& wire = texts[i & 1023];
+        std::string content(wire.data(), wire.size());
+        std::istringstream iss(content);
+        std::string token;
+        std::vector<std::string> tokens;
+        while (std::getline(iss, token, '|')) {
+            tokens.push_back(token);
+        }
+        Color phase = parseColor(tokens[0]);
+        int remainingMs = std::stoi(tokens[1]);
+        float priority = std::stof(tokens[2]);
+        sink = sink + static_cast<uint64_t>(phase) + remainingMs + static_cast<uint64_t>(priority);
+    });
+
+    double binaryEncode = nsPerOp(ITERATIONS, [&](int i) {
+        status::StatusBuffer buffer;
+        sink = sink + status::encode(sample(i), buffer) + buffer[4];
+    });
+
+    std::vector<status::StatusBuffer> buffers(1024);
+    for (int i = 0; i < 1024; ++i) {
+        status::encode(sample(i), buffers[i]);
+    }
+    double binaryDecode = nsPerOp(ITERATIONS, [&](int i) {
+        auto report = status::decode(buffers[i & 1023]);
+        sink = sink + report->sequence + report->remainingMs;
+    });
+
+    std::printf("format,encode_ns,decode_ns,wire_bytes\n");
+    std::printf("text,%.1f,%.1f,%zu\n", legacyEncode, legacyDecode, texts[1023].size());
+    std::printf("tlv,%.1f,%.1f,%zu\n", binaryEncode, binaryDecode, status::STATUS_WIRE_SIZE);
+    return 0;
+}
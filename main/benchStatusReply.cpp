@@ -0,0 +1,145 @@
+#include "../include/LatencyHistogram.hpp"
+#include "../include/PhaseModel.hpp"
+#include "../include/Seqlock.hpp"
+#include "../include/StatusCodec.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+// Latência de montar a resposta de estado do semáforo (ler o estado e codificá-lo
+// em TLV) enquanto a thread de ciclo muda o estado sem parar. Compara a leitura
+// sob o mutex que a thread de ciclo segura durante cada volta com a leitura sem
+// locks do snapshot publicado num seqlock, como o semáforo faz hoje. O código
+// antigo lia os campos sem sincronização nenhuma; o mutex é a versão correta dele.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto DURATION = std::chrono::seconds(2);
+constexpr auto REPLY_INTERVAL = std::chrono::microseconds(100);
+constexpr auto CYCLE_IDLE = std::chrono::microseconds(20);
+constexpr int WORK_PER_TURN = 400;  // tráfego e linhas de log de uma volta do ciclo
+
+// Mesmo layout do estado publicado por SmartTrafficLight.
+struct Snapshot {
+    Color color = Color::UNKNOWN;
+    Ticks phaseEnd = 0;
+    int vehicles = 0;
+    int fullCycleVehicles = 0;
+    phase::Plan plan;
+};
+
+uint64_t nsSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// Uma volta da thread de ciclo: sorteia o tráfego, formata o log e avança a fase.
+void cycleTurn(Snapshot& state, std::mt19937& rng, std::string& logLine) {
+    std::uniform_int_distribution<int> dist(1, 10);
+    for (int i = 0; i < WORK_PER_TURN; ++i) {
+        if (dist(rng) < 5) {
+            state.vehicles++;
+            state.fullCycleVehicles++;
+        }
+        logLine = "Veículos no semáforo: " + std::to_string(state.vehicles);
+    }
+    state.vehicles = std::max(0, state.vehicles - dist(rng));
+    state.color = phase::next(state.color);
+    state.phaseEnd += 1000;
+}
+
+size_t reply(const Snapshot& state, status::StatusBuffer& buffer) {
+    status::StatusReport report;
+    report.phase = state.color;
+    report.remainingMs = static_cast<uint32_t>(std::max<Ticks>(state.phaseEnd - nowTicks(), 0));
+    report.priority = state.fullCycleVehicles * 0.5f + state.vehicles / 10.0f;
+    report.queueLength = static_cast<uint16_t>(state.vehicles);
+    return status::encode(report, buffer);
+}
+
+// Chama `replyOnce` a cada REPLY_INTERVAL enquanto outra thread repete `turn`.
+template <typename Reply, typename Turn>
+void runFor(Reply&& replyOnce, Turn&& turn) {
+    std::atomic_bool stop{false};
+    std::thread cycleThread([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            turn();
+            std::this_thread::sleep_for(CYCLE_IDLE);
+        }
+    });
+    const auto end = Clock::now() + DURATION;
+    while (Clock::now() < end) {
+        replyOnce();
+        std::this_thread::sleep_for(REPLY_INTERVAL);
+    }
+    stop = true;
+    cycleThread.join();
+}
+
+void printRow(const char* variant, const LatencyHistogram& h, uint64_t retries) {
+    std::printf("%s,%llu,%llu,%llu,%llu,%llu,%llu\n", variant,
+                static_cast<unsigned long long>(h.count()),
+                static_cast<unsigned long long>(h.percentile(0.5)),
+                static_cast<unsigned long long>(h.percentile(0.9)),
+                static_cast<unsigned long long>(h.percentile(0.99)),
+                static_cast<unsigned long long>(h.max()),
+                static_cast<unsigned long long>(retries));
+}
+
+} // namespace
+
+int main() {
+    std::printf("variant,samples,p50_ns,p90_ns,p99_ns,max_ns,read_retries\n");
+    volatile size_t sink = 0;
+    {
+        Snapshot state{Color::GREEN, nowTicks(), 0, 0, {}};
+        std::mutex mutex;
+        std::mt19937 rng(42);
+        std::string logLine;
+        LatencyHistogram latency;
+        status::StatusBuffer buffer;
+        runFor([&] {
+                   const auto start = Clock::now();
+                   Snapshot copy;
+                   {
+                       std::lock_guard<std::mutex> lock(mutex);
+                       copy = state;
+                   }
+                   sink = sink + reply(copy, buffer);
+                   latency.record(nsSince(start));
+               },
+               [&] {
+                   std::lock_guard<std::mutex> lock(mutex);
+                   cycleTurn(state, rng, logLine);
+               });
+        printRow("mutex_reply", latency, 0);
+    }
+    {
+        Snapshot state{Color::GREEN, nowTicks(), 0, 0, {}};
+        Seqlock<Snapshot> published;
+        published.write(state);
+        std::mt19937 rng(42);
+        std::string logLine;
+        LatencyHistogram latency;
+        status::StatusBuffer buffer;
+        uint64_t retries = 0;
+        runFor([&] {
+                   const auto start = Clock::now();
+                   sink = sink + reply(published.read(retries), buffer);
+                   latency.record(nsSince(start));
+               },
+               [&] {
+                   cycleTurn(state, rng, logLine);
+                   published.write(state);
+               });
+        printRow("seqlock_reply", latency, retries);
+    }
+    return 0;
+}
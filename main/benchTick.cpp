@@ -0,0 +1,143 @@
+#include "../include/LightRegistry.hpp"
+#include "../include/LightStateTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Micro-benchmark do ciclo do orquestrador: mede o custo das etapas de varredura
+// (média de prioridade, classificação de tendência e detecção de cruzamentos
+// todos-vermelhos) de 10 a 100k semáforos, comparando com o layout antigo
+// (vetor de structs com estado em string e busca linear por nome).
+
+namespace {
+
+struct LegacyLight {
+    std::string name;
+    std::string state;
+    float priority = 0;
+};
+
+struct Topology {
+    std::vector<std::string> names;
+    std::vector<Intersection> intersections;
+};
+
+Topology makeTopology(size_t count) {
+    Topology topo;
+    topo.names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        topo.names.push_back("/ssa/bench/s-" + std::to_string(i / 2) + "/" + std::to_string(i % 2));
+    }
+    for (size_t i = 0; i + 1 < count; i += 2) {
+        Intersection cross;
+        cross.name = "cruzamento-" + std::to_string(i / 2);
+        cross.trafficLightNames = {topo.names[i], topo.names[i + 1]};
+        topo.intersections.push_back(cross);
+    }
+    return topo;
+}
+
+template <typename F>
+double nsPerRun(int iterations, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        body();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+double benchSoA(const Topology& topo, std::mt19937& rng, int iterations) {
+    LightRegistry registry;
+    registry.build(topo.names, topo.intersections, {}, {});
+
+    LightStateTable table;
+    table.resize(topo.names.size());
+    std::uniform_real_distribution<float> prio(0.0f, 20.0f);
+    std::uniform_int_distribution<int> color(0, 2);
+    for (size_t i = 0; i < table.size(); ++i) {
+        table.setPriority(static_cast<LightId>(i), prio(rng));
+        table.color[i] = static_cast<Color>(color(rng));
+    }
+
+    std::vector<int8_t> trend;
+    boost::dynamic_bitset<uint64_t> active;
+    volatile size_t sink = 0;
+
+    return nsPerRun(iterations, [&] {
+        float avg = table.averagePriority();
+        table.classifyPriorities(avg, trend);
+        table.detectActiveIntersections(registry, topo.intersections.size(), active);
+        sink = sink + active.count() + static_cast<size_t>(trend[0]);
+    });
+}
+
+double benchLegacy(const Topology& topo, std::mt19937& rng, int iterations) {
+    static const char* COLORS[] = {"GREEN", "YELLOW", "RED"};
+    std::vector<LegacyLight> lights;
+    std::uniform_real_distribution<float> prio(0.0f, 20.0f);
+    std::uniform_int_distribution<int> color(0, 2);
+    for (const auto& name : topo.names) {
+        lights.push_back({name, COLORS[color(rng)], prio(rng)});
+    }
+
+    auto find = [&](const std::string& name) -> const LegacyLight* {
+        auto it = std::find_if(lights.begin(), lights.end(),
+                               [&](const LegacyLight& tl) { return tl.name == name; });
+        return it != lights.end() ? &*it : nullptr;
+    };
+
+    volatile size_t sink = 0;
+    return nsPerRun(iterations, [&] {
+        double sum = 0.0;
+        for (const auto& tl : lights) {
+            sum += tl.priority;
+        }
+        float avg = static_cast<float>(sum / lights.size());
+        size_t above = 0;
+        for (const auto& tl : lights) {
+            above += tl.priority > avg;
+        }
+        size_t activeCount = 0;
+        for (const auto& cross : topo.intersections) {
+            for (const auto& name : cross.trafficLightNames) {
+                const auto* tl = find(name);
+                if (tl && (tl->state == "GREEN" || tl->state == "YELLOW")) {
+                    activeCount++;
+                    break;
+                }
+            }
+        }
+        sink = sink + above + activeCount;
+    });
+}
+
+} // namespace
+
+int main() {
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000};
+    constexpr size_t LEGACY_LIMIT = 10000;
+    std::mt19937 rng(42);
+
+    std::printf("lights,soa_ns_per_tick,soa_ns_per_light,legacy_ns_per_tick,legacy_ns_per_light\n");
+    for (size_t count : sizes) {
+        Topology topo = makeTopology(count);
+        int iterations = static_cast<int>(std::max<size_t>(10, 2'000'000 / count));
+
+        double soa = benchSoA(topo, rng, iterations);
+        std::printf("%zu,%.0f,%.2f,", count, soa, soa / count);
+
+        if (count <= LEGACY_LIMIT) {
+            int legacyIterations = std::max(3, static_cast<int>(20'000'000 / (count * count)));
+            double legacy = benchLegacy(topo, rng, legacyIterations);
+            std::printf("%.0f,%.2f\n", legacy, legacy / count);
+        } else {
+            std::printf(",\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "../include/YamlParser.hpp"
+#include "../include/Aggregator.hpp"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <id_agregador> <log_level>" << std::endl;
+        std::cerr << "Níveis de log disponíveis: NONE, ERROR, INFO, DEBUG" << std::endl;
+        return 1;
+    }
+
+    int aggregatorId = -1;
+    try {
+        aggregatorId = std::stoi(argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: ID do agregador inválido." << std::endl;
+        return 1;
+    }
+    LogLevel logLevel = parseLogLevel(argv[3]);
+
+    try {
+        YamlParser parser(argv[1]);
+        const auto& aggregators = parser.getAggregators();
+        if (aggregatorId < 0 || aggregatorId >= static_cast<int>(aggregators.size())) {
+            std::cerr << "Erro: Agregador com ID " << aggregatorId << " não encontrado no arquivo." << std::endl;
+            return 1;
+        }
+
+        Aggregator aggregator;
+        aggregator.setup(aggregators[aggregatorId].region);
+        aggregator.loadConfig(parser.getTrafficLights(), parser.getProtocolOptions(), logLevel);
+        aggregator.run();
+
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Erro na inicialização: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
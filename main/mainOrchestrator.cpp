@@ -1,26 +1,43 @@
 #include "../include/YamlParser.hpp"
+#include "../include/RegionPlan.hpp"
 #include "../include/Orchestrator.hpp"
 #include <iostream> 
 
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <log_level>" << std::endl;
+        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <log_level> [id_regiao]" << std::endl;
         std::cerr << "Níveis de log disponíveis: NONE, ERROR, INFO, DEBUG" << std::endl;
+        std::cerr << "Sem id_regiao, roda o orquestrador da cidade (/central)." << std::endl;
         return 1;
     }
 
     YamlParser parser(argv[1]);
     LogLevel logLevel = parseLogLevel(argv[2]);
 
-    auto trafficLights = parser.getTrafficLights();
-    auto intersections = parser.getIntersections();
-    auto greenWaves = parser.getGreenWaves();
-    auto syncGroups = parser.getSyncGroups();
+    int regionIndex = -1;
+    if (argc >= 4) {
+        try {
+            regionIndex = std::stoi(argv[3]);
+        } catch (const std::exception& e) {
+            std::cerr << "Erro: ID da região inválido." << std::endl;
+            return 1;
+        }
+        if (regionIndex < 0 || regionIndex >= static_cast<int>(parser.getRegions().size())) {
+            std::cerr << "Erro: Região com ID " << regionIndex << " não encontrada no arquivo." << std::endl;
+            return 1;
+        }
+    }
+
+    const std::string cityPrefix = "/central";
+    auto view = buildOrchestratorView(parser, regionIndex, cityPrefix);
+    auto protocol = parser.getProtocolOptions();
+    auto options = parser.getOrchestratorOptions();
 
     Orchestrator orch = Orchestrator();
-    orch.setup("/central");
-    orch.loadConfig(trafficLights, intersections, greenWaves, syncGroups, logLevel);
+    orch.setup(regionIndex < 0 ? cityPrefix : view.role.region + "/_orch");
+    orch.loadConfig(view.trafficLights, view.intersections, view.greenWaves, view.syncGroups, view.aggregators,
+                    protocol, options, view.role, logLevel);
     orch.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -5,8 +5,9 @@
 
 int main(int argc, char* argv[]) {
     if (argc < 4) {
-        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <id_semaforo> <log_level>" << std::endl;
+        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <id_semaforo> <log_level> [rt[:<núcleo>]]" << std::endl;
         std::cerr << "Níveis de log disponíveis: NONE, ERROR, INFO, DEBUG" << std::endl;
+        std::cerr << "rt: thread de ciclo em tempo real, opcionalmente presa a um núcleo" << std::endl;
         return 1;
     }
 
@@ -20,6 +21,25 @@ int main(int argc, char* argv[]) {
     }
     LogLevel logLevel = parseLogLevel(argv[3]);
 
+    bool realTime = false;
+    int realTimeCpu = -1;
+    if (argc >= 5) {
+        const std::string mode = argv[4];
+        if (mode.rfind("rt", 0) != 0 || (mode.size() > 2 && mode[2] != ':')) {
+            std::cerr << "Erro: modo desconhecido '" << mode << "' (use rt ou rt:<núcleo>)." << std::endl;
+            return 1;
+        }
+        realTime = true;
+        if (mode.size() > 3) {
+            try {
+                realTimeCpu = std::stoi(mode.substr(3));
+            } catch (const std::exception& e) {
+                std::cerr << "Erro: núcleo inválido em '" << mode << "'." << std::endl;
+                return 1;
+            }
+        }
+    }
+
     try {
         YamlParser parser(yaml_path);
         auto maybeLight = parser.getTrafficLightByIndex(traffic_light_id);
@@ -31,8 +51,13 @@ int main(int argc, char* argv[]) {
 
         SmartTrafficLight light;
 
-        light.setup("/central"); 
-        light.loadConfig(maybeLight.value(), logLevel); 
+        // Semáforos de uma região com orquestrador próprio falam com ele.
+        const int regionIndex = parser.getRegionIndexOf(maybeLight->name);
+        light.setup(regionIndex < 0 ? "/central" : parser.getRegions()[regionIndex].prefix + "/_orch");
+        light.loadConfig(maybeLight.value(), parser.getProtocolOptions(), logLevel); 
+        if (realTime) {
+            light.enableRealTime(realTimeCpu);
+        }
         
         light.run();
 
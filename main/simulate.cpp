@@ -0,0 +1,49 @@
+#include "../include/YamlParser.hpp"
+#include "../include/Simulation.hpp"
+
+#include <iostream>
+
+// Roda um cenário uma vez em tempo virtual (include/Simulation.hpp). As métricas
+// vão para metrics/, como no deploy real, e os indicadores de tráfego para a
+// saída padrão.
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <duracao_s> [semente] [passo_ms] [log_level]" << std::endl;
+        std::cerr << "Padrões: semente 1, passo de 10 ms, log NONE." << std::endl;
+        std::cerr << "Níveis de log disponíveis: NONE, ERROR, INFO, DEBUG" << std::endl;
+        return 1;
+    }
+
+    sim::RunOptions options;
+    try {
+        options.durationS = std::stoll(argv[2]);
+        if (argc >= 4) options.seed = static_cast<uint32_t>(std::stoul(argv[3]));
+        if (argc >= 5) options.stepMs = std::stoll(argv[4]);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: duração, semente ou passo inválido." << std::endl;
+        return 1;
+    }
+    if (options.durationS <= 0 || options.stepMs <= 0) {
+        std::cerr << "Erro: duração e passo devem ser positivos." << std::endl;
+        return 1;
+    }
+    if (argc >= 6) {
+        options.logLevel = parseLogLevel(argv[5]);
+    }
+
+    try {
+        YamlParser parser(argv[1]);
+        const sim::TrafficKpis kpis = sim::run(parser, parser.getOrchestratorOptions().control, options);
+        std::cout << "Simulados " << options.durationS << " s com " << kpis.lights << " semáforos em "
+                  << kpis.wallSeconds << " s (semente " << options.seed << ", passo de " << options.stepMs
+                  << " ms)." << std::endl;
+        std::cout << "Chegadas " << kpis.arrivals << ", passagens " << kpis.departures << " ("
+                  << kpis.throughputVph << " veículos/h), fila média " << kpis.meanQueue << " (máx "
+                  << kpis.maxQueue << "), espera média " << kpis.meanDelayS << " s." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Erro na simulação: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
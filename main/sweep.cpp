@@ -0,0 +1,175 @@
+#include "../include/YamlParser.hpp"
+#include "../include/Simulation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Varredura de parâmetros de controle: roda o cenário em tempo virtual
+// (include/Simulation.hpp) para cada combinação da grade, em paralelo, uma
+// simulação por thread, e imprime os indicadores de tráfego de cada uma em CSV.
+// A grade é um YAML com uma lista de valores por chave de `orchestrator.control`
+// e, opcionalmente, `seeds`; as chaves ausentes ficam com o valor do cenário.
+//
+//   green_base_ms: [10000, 15000, 20000]
+//   adjustment_ms: [3000, 5000]
+//   seeds: [1, 2, 3]
+//
+// As métricas do orquestrador de cada execução vão para metrics/sweep/<execução>/.
+
+namespace {
+
+constexpr std::array<const char*, 5> CONTROL_KEYS = {
+    "green_base_ms", "recovery_red_ms", "low_priority_wave_factor", "adjustment_ms", "max_adjustments"};
+
+struct Run {
+    ControlParams control;
+    uint32_t seed = 1;
+    std::optional<sim::TrafficKpis> kpis;
+};
+
+std::vector<YAML::Node> valuesOf(const YAML::Node& node) {
+    std::vector<YAML::Node> values;
+    if (node.IsSequence()) {
+        for (const auto& value : node) {
+            values.push_back(value);
+        }
+    } else {
+        values.push_back(node);
+    }
+    if (values.empty()) {
+        throw std::runtime_error("lista de valores vazia na grade.");
+    }
+    return values;
+}
+
+// Produto cartesiano da grade sobre os parâmetros do cenário.
+std::vector<Run> expandGrid(const YAML::Node& grid, const ControlParams& base) {
+    std::vector<std::pair<std::string, std::vector<YAML::Node>>> axes;
+    std::vector<uint32_t> seeds = {1};
+    for (const auto& entry : grid) {
+        const std::string key = entry.first.as<std::string>();
+        if (key == "seeds") {
+            seeds.clear();
+            for (const auto& seed : valuesOf(entry.second)) {
+                seeds.push_back(seed.as<uint32_t>());
+            }
+        } else if (std::find(CONTROL_KEYS.begin(), CONTROL_KEYS.end(), key) != CONTROL_KEYS.end()) {
+            axes.emplace_back(key, valuesOf(entry.second));
+        } else {
+            throw std::runtime_error("chave desconhecida na grade: '" + key + "'.");
+        }
+    }
+
+    size_t combinations = 1;
+    for (const auto& [key, values] : axes) {
+        combinations *= values.size();
+    }
+    std::vector<Run> runs;
+    runs.reserve(combinations * seeds.size());
+    for (size_t c = 0; c < combinations; ++c) {
+        YAML::Node node;
+        size_t rest = c;
+        for (const auto& [key, values] : axes) {
+            node[key] = values[rest % values.size()];
+            rest /= values.size();
+        }
+        ControlParams control = base;
+        YamlParser::parseControl(node, control);
+        for (uint32_t seed : seeds) {
+            runs.push_back(Run{control, seed, std::nullopt});
+        }
+    }
+    return runs;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " <caminho_yaml> <grade_yaml> <duracao_s> [threads] [passo_ms]" << std::endl;
+        std::cerr << "Padrões: uma thread por núcleo, passo de 10 ms." << std::endl;
+        return 1;
+    }
+
+    sim::RunOptions options;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    try {
+        options.durationS = std::stoll(argv[3]);
+        if (argc >= 5) threads = std::stoul(argv[4]);
+        if (argc >= 6) options.stepMs = std::stoll(argv[5]);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: duração, threads ou passo inválido." << std::endl;
+        return 1;
+    }
+    if (options.durationS <= 0 || options.stepMs <= 0 || threads == 0) {
+        std::cerr << "Erro: duração, threads e passo devem ser positivos." << std::endl;
+        return 1;
+    }
+
+    std::optional<YamlParser> parser;
+    std::vector<Run> runs;
+    try {
+        parser.emplace(argv[1]);
+        runs = expandGrid(YAML::LoadFile(argv[2]), parser->getOrchestratorOptions().control);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro na grade: " << e.what() << std::endl;
+        return 1;
+    }
+    threads = std::min(threads, runs.size());
+    std::cerr << runs.size() << " execuções de " << options.durationS << " s em " << threads << " threads." << std::endl;
+
+    // Cada thread pega a próxima execução livre; o parser é só lido.
+    std::atomic<size_t> next{0};
+    std::mutex progressMutex;
+    size_t done = 0;
+    {
+        std::vector<std::jthread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                for (size_t i = next++; i < runs.size(); i = next++) {
+                    sim::RunOptions runOptions = options;
+                    runOptions.seed = runs[i].seed;
+                    runOptions.metricsDir = "metrics/sweep/" + std::to_string(i);
+                    std::string error;
+                    try {
+                        runs[i].kpis = sim::run(*parser, runs[i].control, runOptions);
+                    } catch (const std::exception& e) {
+                        error = e.what();
+                    }
+                    std::lock_guard<std::mutex> lock(progressMutex);
+                    ++done;
+                    if (!error.empty()) {
+                        std::cerr << "Execução " << i << " falhou: " << error << std::endl;
+                    } else {
+                        std::cerr << "[" << done << "/" << runs.size() << "] execução " << i << " em "
+                                  << runs[i].kpis->wallSeconds << " s" << std::endl;
+                    }
+                }
+            });
+        }
+    }
+
+    std::printf("run,green_base_ms,recovery_red_ms,low_priority_wave_factor,adjustment_ms,max_adjustments,seed,"
+                "lights,arrivals,departures,throughput_vph,mean_queue,max_queue,mean_delay_s,wall_s\n");
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!runs[i].kpis) {
+            continue;
+        }
+        const ControlParams& c = runs[i].control;
+        const sim::TrafficKpis& k = *runs[i].kpis;
+        std::printf("%zu,%d,%d,%.3f,%d,%d,%u,%zu,%llu,%llu,%.1f,%.3f,%d,%.2f,%.2f\n", i,
+                    c.greenBaseTimeMs, c.recoveryRedTimeMs, c.lowPriorityWaveFactor, c.adjustmentMs, c.maxAdjustments,
+                    runs[i].seed, k.lights, static_cast<unsigned long long>(k.arrivals),
+                    static_cast<unsigned long long>(k.departures), k.throughputVph, k.meanQueue, k.maxQueue,
+                    k.meanDelayS, k.wallSeconds);
+    }
+    return 0;
+}
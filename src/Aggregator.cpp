@@ -0,0 +1,340 @@
+#include "../include/Aggregator.hpp"
+
+#include <sstream>
+#include <algorithm>
+#include <random>
+
+Aggregator::Aggregator() = default;
+
+Aggregator::~Aggregator() {
+  m_face.shutdown();
+}
+
+void Aggregator::setup(const std::string& region) {
+  m_region = region;
+  m_aggPrefix = ndn::Name(region).append("_agg");
+}
+
+void Aggregator::loadConfig(const std::vector<std::pair<std::string, TrafficLightState>>& trafficLights,
+                            const ProtocolOptions& protocol, LogLevel level) {
+  m_logLevel = level;
+  m_signer.configure(protocol.signing, protocol.hmacSecretFile);
+  if (protocol.signing == SigningMode::ASYMMETRIC) {
+    m_validator.load(protocol.trustSchema);
+  }
+  m_centralLink = m_signer.addLink(m_region);
+  const std::string prefix = m_region + "/";
+  for (const auto& [name, state] : trafficLights) {
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    Member member;
+    member.name = name;
+    member.suffix = name.substr(m_region.size());
+    if (member.suffix.size() > status::MAX_LIGHT_SUFFIX_SIZE) {
+      log(LogLevel::ERROR, "Nome longo demais para o agregado, ignorado: " + name);
+      continue;
+    }
+    member.link = m_signer.addLink(name);
+    m_memberIndex[name] = m_members.size();
+    m_members.push_back(std::move(member));
+  }
+  log(LogLevel::INFO, "Agregando " + std::to_string(m_members.size()) + " semáforos sob " + m_region);
+
+  // Fases espalhadas por igual no período, como no orquestrador: os polls saem
+  // um slot por vez, e não todos no mesmo instante.
+  m_pending.resize(m_members.size(), STATUS_IN_FLIGHT);
+  m_nextNonce = std::random_device{}();
+  const uint64_t periodSlots = POLL_PERIOD_MS / POLL_SLOT_MS;
+  m_pollWheel.reset(POLL_RECONTACT_MS / POLL_SLOT_MS + 1);
+  for (LightId index = 0; index < m_members.size(); ++index) {
+    m_members[index].pollPhase = static_cast<uint16_t>(index * periodSlots / m_members.size());
+    m_pollWheel.schedule(index, m_pollWheel.nextAligned(periodSlots, m_members[index].pollPhase));
+  }
+}
+
+void Aggregator::log(LogLevel level, const std::string& message) {
+  if (level <= m_logLevel) {
+    std::string levelStr;
+    switch (level) {
+      case LogLevel::ERROR: levelStr = "[ERROR]"; break;
+      case LogLevel::INFO:  levelStr = "[INFO] "; break;
+      case LogLevel::DEBUG: levelStr = "[DEBUG]"; break;
+      default: return;
+    }
+
+    auto& stream = (level == LogLevel::ERROR) ? std::cerr : std::cout;
+    stream << levelStr << " [" << m_aggPrefix.toUri() << "] " << message << std::endl;
+  }
+}
+
+void Aggregator::run() {
+  runProducer("_agg");
+  runConsumer();
+  m_face.processEvents();
+}
+
+void Aggregator::runProducer(const std::string& suffix) {
+  ndn::Name nameSuffix = ndn::Name(m_region).append(suffix);
+  log(LogLevel::INFO, "Registrando produtor para o prefixo: " + nameSuffix.toUri());
+  m_face.setInterestFilter(nameSuffix,
+      [this](const ndn::InterestFilter&, const ndn::Interest& interest) {
+        this->onInterest(interest);
+      },
+      [this](const ndn::Name& name, const std::string& reason) {
+        this->onRegisterFailed(name, reason);
+      });
+  // Com a identidade /<região>/_agg, o filtro acima também recebe as buscas do
+  // certificado; onInterest() as deixa para este.
+  auto cert = m_keyChain.getPib().getDefaultIdentity().getDefaultKey().getDefaultCertificate();
+  m_certPrefix = security::extractIdentityFromCertName(cert.getName()).append(status::CERT_COMPONENT);
+  m_certServeHandle = m_face.setInterestFilter(m_certPrefix,
+                                                [this, cert] (const ndn::InterestFilter&, const ndn::Interest& interest) {
+                                                  if (interest.matchesData(cert)) {
+                                                    m_face.put(cert);
+                                                  }
+                                                },
+                                                std::bind(&Aggregator::onRegisterFailed, this, _1, _2));
+}
+
+void Aggregator::runConsumer() {
+  m_pollTickDue = steadyNow() + std::chrono::seconds(1);
+  m_pollTickEvent = m_scheduler.schedule(ndn::time::seconds(1), [this] { pollTick(); });
+}
+
+// Visita os slots vencidos da roda de poll; com a thread atrasada, os atrasados
+// são visitados de uma vez para a roda acompanhar o relógio.
+void Aggregator::pollTick() {
+  const auto start = steadyNow();
+  do {
+    m_pollWheel.advance([this](LightId index) { visitMember(index); });
+    m_pollTickDue += std::chrono::milliseconds(POLL_SLOT_MS);
+  } while (m_pollTickDue <= start);
+
+  const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(m_pollTickDue - steadyNow());
+  m_pollTickEvent = m_scheduler.schedule(ndn::time::microseconds(std::max<int64_t>(0, delay.count())),
+                                         [this] { pollTick(); });
+}
+
+// Um membro na sua vez: a cada período, ou a cada POLL_RECONTACT_MS se parou de
+// responder, sempre no mesmo slot do período.
+void Aggregator::visitMember(LightId index) {
+  pollMember(index);
+  const int intervalMs = m_members[index].timeouts < TIMEOUT_THRESHOLD ? POLL_PERIOD_MS : POLL_RECONTACT_MS;
+  m_pollWheel.schedule(index, m_pollWheel.nextAligned(intervalMs / POLL_SLOT_MS, m_members[index].pollPhase));
+}
+
+// Depois de um timeout, o poll sai com o RTO dobrado e conta como retransmissão:
+// o Data pode responder ao Interest anterior, então não dá amostra de RTT.
+void Aggregator::pollMember(LightId index) {
+  const auto& member = m_members[index];
+  expressStatus(index, createInterest(ndn::Name(member.name), true, false, ndn::time::milliseconds(member.rtt.rtoMs())),
+                member.timeouts > 0);
+}
+
+// Cada envio ocupa uma entrada de m_pending com um nonce próprio; os callbacks já
+// sabem o índice do membro e o nonce, sem montar nem procurar nomes.
+void Aggregator::expressStatus(LightId index, ndn::Interest interest, bool retransmission) {
+  const uint32_t nonce = m_nextNonce++;
+  if (!m_pending.insert(index, nonce, steadyNow(), retransmission)) {
+    return;
+  }
+  interest.setNonce(nonce);
+  m_face.expressInterest(interest,
+      [this, index, nonce](const ndn::Interest&, const ndn::Data& data) { onStatusData(index, nonce, data); },
+      [this, index, nonce](const ndn::Interest& sent, const ndn::lp::Nack& nack) { onStatusNack(index, nonce, sent, nack); },
+      [this, index, nonce](const ndn::Interest& sent) { onStatusTimeout(index, nonce, sent); });
+}
+
+void Aggregator::onInterest(const ndn::Interest& interest) {
+  const auto& name = interest.getName();
+  log(LogLevel::DEBUG, "Recebeu Interest para: " + name.toUri());
+  if (m_certPrefix.isPrefixOf(name)) {
+    return;
+  }
+
+  // /<região>/_agg: o consumidor quer a versão mais recente (CanBePrefix).
+  if (name.size() == m_aggPrefix.size()) {
+    if (m_current.segments.empty() || nowTicks() - m_current.builtAt >= REBUILD_INTERVAL_MS) {
+      publishVersion();
+    }
+    return serveSegment(interest, m_current.number, 0);
+  }
+
+  // /<região>/_agg/<versão>/<segmento>
+  if (name.size() == m_aggPrefix.size() + 2 && name.get(-2).isVersion() && name.get(-1).isSegment()) {
+    return serveSegment(interest, name.get(-2).toVersion(), static_cast<size_t>(name.get(-1).toSegment()));
+  }
+  log(LogLevel::ERROR, "Interest com sufixo inválido recebido: " + name.toUri());
+}
+
+void Aggregator::publishVersion() {
+  const Ticks now = nowTicks();
+  Version version;
+  version.number = static_cast<uint64_t>(ndn::time::toUnixTimestamp(ndn::time::system_clock::now()).count());
+  if (version.number <= m_current.number) {
+    version.number = m_current.number + 1;
+  }
+  version.builtAt = now;
+
+  std::vector<std::vector<uint8_t>> payloads(1);
+  payloads.back().reserve(status::AGGREGATE_SEGMENT_SIZE);
+  for (const auto& member : m_members) {
+    status::StatusReport report = member.report;
+    if (member.timeouts >= TIMEOUT_THRESHOLD) {
+      report.phase = Color::UNKNOWN;
+      report.remainingMs = 0;
+      report.phaseEnd = 0;
+    } else if (member.receivedAt == 0) {
+      continue;   // ainda sem resposta: não afirma nada sobre o semáforo
+    } else {
+      // Envelhece o tempo restante até o instante da publicação.
+      int64_t remaining = static_cast<int64_t>(report.remainingMs) - member.oneWayDelayMs - (now - member.receivedAt);
+      report.remainingMs = static_cast<uint32_t>(std::max<int64_t>(remaining, 0));
+    }
+
+    if (!status::appendAggregateEntry(payloads.back(), member.suffix, report)) {
+      payloads.emplace_back();
+      payloads.back().reserve(status::AGGREGATE_SEGMENT_SIZE);
+      status::appendAggregateEntry(payloads.back(), member.suffix, report);
+    }
+  }
+
+  const auto finalBlock = ndn::name::Component::fromSegment(payloads.size() - 1);
+  for (size_t segment = 0; segment < payloads.size(); ++segment) {
+    auto data = std::make_shared<ndn::Data>(ndn::Name(m_aggPrefix).appendVersion(version.number).appendSegment(segment));
+    data->setContent(ndn::make_span(payloads[segment].data(), payloads[segment].size()));
+    data->setFreshnessPeriod(AGGREGATE_FRESHNESS);
+    data->setFinalBlock(finalBlock);
+    m_signer.sign(*data, m_centralLink);
+    version.segments.push_back(std::move(data));
+  }
+
+  log(LogLevel::DEBUG, "Versão " + std::to_string(version.number) + " publicada com " +
+      std::to_string(version.segments.size()) + " segmento(s).");
+  m_previous = std::move(m_current);
+  m_current = std::move(version);
+}
+
+void Aggregator::serveSegment(const ndn::Interest& interest, uint64_t version, size_t segment) {
+  const Version* source = nullptr;
+  if (version == m_current.number) {
+    source = &m_current;
+  } else if (version == m_previous.number) {
+    source = &m_previous;
+  }
+  if (source == nullptr || segment >= source->segments.size()) {
+    log(LogLevel::ERROR, "Segmento inexistente pedido: " + interest.getName().toUri());
+    return;
+  }
+  m_face.put(*source->segments[segment]);
+}
+
+ndn::Interest Aggregator::createInterest(const ndn::Name& name, bool mustBeFresh, bool canBePrefix, ndn::time::milliseconds lifetime) {
+  ndn::Interest interest(name);
+  interest.setMustBeFresh(mustBeFresh);
+  interest.setCanBePrefix(canBePrefix);
+  interest.setInterestLifetime(lifetime);
+  return interest;
+}
+
+// Interface ProConInterface: Interests de estado de nome arbitrário. O caminho
+// normal é pollMember(), que já conhece o índice.
+void Aggregator::sendInterest(const ndn::Interest& interest) {
+  auto it = m_memberIndex.find(interest.getName().toUri());
+  if (it != m_memberIndex.end()) {
+    expressStatus(static_cast<LightId>(it->second), interest, false);
+  }
+}
+
+namespace {
+
+// O nonce como foi posto em expressStatus(), remontado em big-endian como em
+// Orchestrator.cpp.
+uint32_t nonceOf(const ndn::Interest& interest) {
+  const ndn::Interest::Nonce nonce = interest.getNonce();
+  return (uint32_t{nonce[0]} << 24) | (uint32_t{nonce[1]} << 16) | (uint32_t{nonce[2]} << 8) | uint32_t{nonce[3]};
+}
+
+} // namespace
+
+void Aggregator::onData(const ndn::Interest& interest, const ndn::Data& data) {
+  auto it = m_memberIndex.find(interest.getName().toUri());
+  if (it != m_memberIndex.end()) {
+    onStatusData(static_cast<LightId>(it->second), nonceOf(interest), data);
+  }
+}
+
+void Aggregator::onStatusData(LightId index, uint32_t nonce, const ndn::Data& data) {
+  const auto sent = m_pending.take(index, nonce);
+  if (!sent) {
+    log(LogLevel::ERROR, "Data sem Interest pendente: " + data.getName().toUri());
+    return;
+  }
+  const auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(steadyNow() - sent->sentAt);
+  // Algoritmo de Karn: a resposta a um Interest retransmitido não entra no estimador.
+  if (!sent->retransmission) {
+    m_members[index].rtt.addSample(static_cast<int>(rtt.count()));
+  }
+  const int oneWayDelayMs = static_cast<int>(rtt.count() / 2);
+  m_verifier.verify(data, m_members[index].link,
+      [this, index, data, oneWayDelayMs] { acceptStatus(index, data, oneWayDelayMs); },
+      [this, name = data.getName()](const std::string& reason) {
+        log(LogLevel::ERROR, "Data rejeitado (" + reason + "): " + name.toUri());
+      });
+}
+
+void Aggregator::acceptStatus(size_t index, const ndn::Data& data, int oneWayDelayMs) {
+  auto& member = m_members[index];
+  const auto& content = data.getContent();
+  auto report = status::decode(std::span<const uint8_t>(content.value(), content.value_size()));
+  if (!report) {
+    log(LogLevel::ERROR, "Estado malformado de " + member.name);
+    return;
+  }
+
+  if (member.timeouts >= TIMEOUT_THRESHOLD) {
+    log(LogLevel::INFO, "Semáforo " + member.name + " voltou a comunicar.");
+  }
+  member.report = *report;
+  member.receivedAt = nowTicks();
+  member.oneWayDelayMs = oneWayDelayMs;
+  member.timeouts = 0;
+}
+
+void Aggregator::onNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+  auto it = m_memberIndex.find(interest.getName().toUri());
+  if (it != m_memberIndex.end()) {
+    onStatusNack(static_cast<LightId>(it->second), nonceOf(interest), interest, nack);
+  }
+}
+
+void Aggregator::onStatusNack(LightId index, uint32_t nonce, const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+  m_pending.take(index, nonce);
+  std::stringstream ss;
+  ss << "Nack recebido para " << interest.getName().toUri() << ". Motivo: " << nack.getReason();
+  log(LogLevel::ERROR, ss.str());
+  m_members[index].timeouts = TIMEOUT_THRESHOLD;
+}
+
+void Aggregator::onTimeout(const ndn::Interest& interest) {
+  auto it = m_memberIndex.find(interest.getName().toUri());
+  if (it != m_memberIndex.end()) {
+    onStatusTimeout(static_cast<LightId>(it->second), nonceOf(interest), interest);
+  }
+}
+
+void Aggregator::onStatusTimeout(LightId index, uint32_t nonce, const ndn::Interest& interest) {
+  m_pending.take(index, nonce);
+  log(LogLevel::ERROR, "Timeout no Interest para: " + interest.getName().toUri());
+  auto& member = m_members[index];
+  member.rtt.backoff();
+  if (member.timeouts < UINT8_MAX) {
+    member.timeouts++;
+  }
+}
+
+void Aggregator::onRegisterFailed(const ndn::Name& prefix, const std::string& reason) {
+  log(LogLevel::ERROR, "Falha CRÍTICA ao registrar prefixo: " + prefix.toUri() + ". Motivo: " + reason);
+  m_face.shutdown();
+}
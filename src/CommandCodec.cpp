@@ -0,0 +1,170 @@
+#include "../include/CommandCodec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace command {
+
+namespace {
+
+constexpr const char* OP_NAMES[] = {
+  "none",
+  "set_state",
+  "set_time",
+  "set_time_default",
+  "set_default_duration",
+  "set_green_duration",
+  "set_red_duration",
+  "increase_green_duration",
+  "decrease_green_duration",
+  "increase_red_duration",
+  "decrease_red_duration",
+  "set_current_time",
+  "increase_time",
+  "decrease_time",
+  "set_phase_end",
+};
+static_assert(std::size(OP_NAMES) == static_cast<size_t>(CommandOp::COUNT));
+
+uint8_t* writeBigEndian(uint8_t* pos, uint64_t value, size_t bytes) {
+  for (size_t i = bytes; i > 0; --i) {
+    *pos++ = static_cast<uint8_t>(value >> (8 * (i - 1)));
+  }
+  return pos;
+}
+
+uint64_t readBigEndian(const uint8_t* pos, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value = (value << 8) | pos[i];
+  }
+  return value;
+}
+
+} // namespace
+
+size_t encode(const CommandBatch& batch, CommandBuffer& out) {
+  uint8_t* pos = out.data();
+  *pos++ = tlv::CommandList;
+  uint8_t* length = pos++;
+
+  *pos++ = tlv::Sequence;
+  *pos++ = 8;
+  pos = writeBigEndian(pos, batch.sequence, 8);
+  if (batch.receivedAt != 0 && batch.sentAt != 0) {
+    *pos++ = tlv::ReceiveTime;
+    *pos++ = 8;
+    pos = writeBigEndian(pos, static_cast<uint64_t>(batch.receivedAt), 8);
+    *pos++ = tlv::TransmitTime;
+    *pos++ = 8;
+    pos = writeBigEndian(pos, static_cast<uint64_t>(batch.sentAt), 8);
+  }
+
+  for (const auto& cmd : batch) {
+    int64_t value = cmd.value;
+    if (cmd.op == CommandOp::SET_PHASE_END) {
+      if (batch.sentAt == 0) {
+        continue;
+      }
+      value = std::clamp<int64_t>(value - batch.sentAt, INT32_MIN, INT32_MAX);
+    }
+    *pos++ = tlv::Command;
+    *pos++ = 5;
+    *pos++ = static_cast<uint8_t>(cmd.op);
+    pos = writeBigEndian(pos, static_cast<uint32_t>(static_cast<int32_t>(value)), 4);
+  }
+  if (!batch.plan.empty() && batch.sentAt != 0) {
+    *pos++ = tlv::PhasePlan;
+    *pos++ = static_cast<uint8_t>(batch.plan.count * (2 + 5));
+    for (const auto& entry : batch.plan) {
+      *pos++ = tlv::PlanEntry;
+      *pos++ = 5;
+      *pos++ = static_cast<uint8_t>(entry.color);
+      const int64_t end = std::clamp<int64_t>(entry.end - batch.sentAt, INT32_MIN, INT32_MAX);
+      pos = writeBigEndian(pos, static_cast<uint32_t>(static_cast<int32_t>(end)), 4);
+    }
+  }
+  *length = static_cast<uint8_t>(pos - length - 1);
+  return static_cast<size_t>(pos - out.data());
+}
+
+std::optional<CommandBatch> decode(std::span<const uint8_t> wire) {
+  if (wire.size() < 2 + 10 || wire[0] != tlv::CommandList || wire.size() < size_t(2) + wire[1]) {
+    return std::nullopt;
+  }
+  const uint8_t* pos = wire.data() + 2;
+  const uint8_t* end = pos + wire[1];
+
+  if (pos[0] != tlv::Sequence || pos[1] != 8) {
+    return std::nullopt;
+  }
+  CommandBatch batch;
+  batch.sequence = readBigEndian(pos + 2, 8);
+  pos += 10;
+  if (end - pos >= 20 && pos[0] == tlv::ReceiveTime && pos[1] == 8 &&
+      pos[10] == tlv::TransmitTime && pos[11] == 8) {
+    batch.receivedAt = static_cast<Ticks>(readBigEndian(pos + 2, 8));
+    batch.sentAt = static_cast<Ticks>(readBigEndian(pos + 12, 8));
+    pos += 20;
+  }
+
+  while (end - pos >= 2) {
+    const uint8_t type = pos[0];
+    const uint8_t length = pos[1];
+    if (end - pos < 2 + length) {
+      return std::nullopt;
+    }
+    if (type == tlv::Command && length == 5 && pos[2] < static_cast<uint8_t>(CommandOp::COUNT)) {
+      auto op = static_cast<CommandOp>(pos[2]);
+      int64_t value = static_cast<int32_t>(static_cast<uint32_t>(readBigEndian(pos + 3, 4)));
+      if (op == CommandOp::SET_PHASE_END) {
+        if (batch.sentAt == 0) {
+          pos += 2 + length;
+          continue;
+        }
+        value += batch.sentAt;
+      }
+      if (op != CommandOp::NONE && !batch.push(op, value)) {
+        break;
+      }
+    } else if (type == tlv::PhasePlan && batch.sentAt != 0) {
+      for (const uint8_t* entry = pos + 2; entry + 7 <= pos + 2 + length; entry += 7) {
+        if (entry[0] != tlv::PlanEntry || entry[1] != 5 || entry[2] > static_cast<uint8_t>(Color::UNKNOWN)) {
+          return std::nullopt;
+        }
+        const int64_t end = static_cast<int32_t>(static_cast<uint32_t>(readBigEndian(entry + 3, 4)));
+        batch.plan.push(static_cast<Color>(entry[2]), batch.sentAt + end);
+      }
+    }
+    pos += 2 + length;
+  }
+  return batch;
+}
+
+const char* opName(CommandOp op) {
+  auto index = static_cast<size_t>(op);
+  return index < std::size(OP_NAMES) ? OP_NAMES[index] : "unknown";
+}
+
+std::string toString(const CommandBatch& batch) {
+  std::string out;
+  for (const auto& cmd : batch) {
+    out += ';';
+    out += opName(cmd.op);
+    if (cmd.op == CommandOp::SET_STATE) {
+      out += ':' + ToString(static_cast<Color>(cmd.value));
+    } else if (cmd.op != CommandOp::SET_DEFAULT_DURATION && cmd.op != CommandOp::SET_TIME_DEFAULT) {
+      out += ':' + std::to_string(cmd.value);
+    }
+  }
+  if (!batch.plan.empty()) {
+    out += ";plan:";
+    for (const auto& entry : batch.plan) {
+      if (&entry != batch.plan.begin()) out += ',';
+      out += ToString(entry.color) + '@' + std::to_string(entry.end);
+    }
+  }
+  return out;
+}
+
+} // namespace command
@@ -0,0 +1,74 @@
+#include "../include/LightRegistry.hpp"
+
+void LightRegistry::build(const std::vector<std::string>& lightNames,
+                          const std::vector<Intersection>& intersections,
+                          const std::vector<GreenWaveGroup>& greenWaves,
+                          const std::vector<SyncGroup>& syncGroups)
+{
+  ids_.clear();
+  names_ = lightNames;
+  ids_.reserve(names_.size());
+  for (LightId id = 0; id < names_.size(); ++id) {
+    ids_.emplace(names_[id], id);
+  }
+
+  const size_t count = names_.size();
+  intersectionOf_.assign(count, NO_GROUP);
+  waveOf_.assign(count, NO_GROUP);
+  syncGroupOf_.assign(count, NO_GROUP);
+  competitorOf_.assign(count, INVALID_LIGHT);
+
+  intersectionMembers_.clear();
+  waveMembers_.clear();
+  syncGroupMembers_.clear();
+
+  // Membros desconhecidos permanecem como INVALID_LIGHT para preservar a posição
+  // de cada semáforo dentro do grupo (o offset da onda verde depende dela).
+  for (GroupId g = 0; g < static_cast<GroupId>(intersections.size()); ++g) {
+    auto members = resolve(intersections[g].trafficLightNames);
+    for (LightId id : members) {
+      if (id != INVALID_LIGHT && intersectionOf_[id] == NO_GROUP) {
+        intersectionOf_[id] = g;
+      }
+    }
+    if (members.size() == 2 && members[0] != INVALID_LIGHT && members[1] != INVALID_LIGHT) {
+      competitorOf_[members[0]] = members[1];
+      competitorOf_[members[1]] = members[0];
+    }
+    intersectionMembers_.push_back(std::move(members));
+  }
+
+  for (GroupId g = 0; g < static_cast<GroupId>(greenWaves.size()); ++g) {
+    auto members = resolve(greenWaves[g].trafficLightNames);
+    for (LightId id : members) {
+      if (id != INVALID_LIGHT && waveOf_[id] == NO_GROUP) {
+        waveOf_[id] = g;
+      }
+    }
+    waveMembers_.push_back(std::move(members));
+  }
+
+  for (GroupId g = 0; g < static_cast<GroupId>(syncGroups.size()); ++g) {
+    auto members = resolve(syncGroups[g].trafficLightNames);
+    for (LightId id : members) {
+      if (id != INVALID_LIGHT && syncGroupOf_[id] == NO_GROUP) {
+        syncGroupOf_[id] = g;
+      }
+    }
+    syncGroupMembers_.push_back(std::move(members));
+  }
+}
+
+LightId LightRegistry::find(const std::string& name) const {
+  auto it = ids_.find(name);
+  return (it != ids_.end()) ? it->second : INVALID_LIGHT;
+}
+
+std::vector<LightId> LightRegistry::resolve(const std::vector<std::string>& names) const {
+  std::vector<LightId> ids;
+  ids.reserve(names.size());
+  for (const auto& name : names) {
+    ids.push_back(find(name));
+  }
+  return ids;
+}
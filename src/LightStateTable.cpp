@@ -0,0 +1,63 @@
+#include "../include/LightStateTable.hpp"
+
+static_assert(static_cast<uint8_t>(Color::GREEN) == 0 && static_cast<uint8_t>(Color::YELLOW) == 1,
+              "detectActiveIntersections assume VERDE e AMARELO como as duas primeiras cores");
+
+void LightStateTable::resize(size_t count) {
+  color.assign(count, Color::RED);
+  endTime.assign(count, 0);
+  priority.assign(count, 0.0f);
+  m_prioritySum = 0.0;
+  timeoutCounter.assign(count, 0);
+  queueLength.assign(count, 0);
+  statusSeq.assign(count, 0);
+  lastReport.assign(count, 0);
+  adjustCount.assign(count, 0);
+  adjustGaining.assign(count, 1);
+  partOfIntersection.resize(count);
+  partOfGreenWave.resize(count);
+  partOfSyncGroup.resize(count);
+  partOfIntersection.reset();
+  partOfGreenWave.reset();
+  partOfSyncGroup.reset();
+}
+
+float LightStateTable::averagePriority() const {
+  if (priority.empty()) {
+    return 15.0f;
+  }
+  return static_cast<float>(m_prioritySum / priority.size());
+}
+
+void LightStateTable::classifyPriorities(float average, std::vector<int8_t>& trend) const {
+  const size_t count = priority.size();
+  trend.resize(count);
+  const float* p = priority.data();
+  int8_t* out = trend.data();
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<int8_t>((p[i] > average) - (p[i] < average));
+  }
+}
+
+void LightStateTable::detectActiveIntersections(const LightRegistry& registry, size_t intersectionCount,
+                                                boost::dynamic_bitset<uint64_t>& active) const {
+  // Primeiro um laço sem desvios sobre as cores; depois um OR por cruzamento.
+  const size_t count = color.size();
+  activeScratch_.resize(count);
+  const Color* c = color.data();
+  uint8_t* a = activeScratch_.data();
+  for (size_t i = 0; i < count; ++i) {
+    a[i] = static_cast<uint8_t>(static_cast<uint8_t>(c[i]) <= static_cast<uint8_t>(Color::YELLOW));
+  }
+
+  active.resize(intersectionCount);
+  active.reset();
+  for (GroupId g = 0; g < static_cast<GroupId>(intersectionCount); ++g) {
+    for (LightId id : registry.intersectionMembers(g)) {
+      if (id != INVALID_LIGHT && a[id]) {
+        active.set(g);
+        break;
+      }
+    }
+  }
+}
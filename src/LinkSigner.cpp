@@ -0,0 +1,148 @@
+#include "../include/LinkSigner.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/transform/base64-encode.hpp>
+#include <ndn-cxx/security/transform/buffer-source.hpp>
+#include <ndn-cxx/security/transform/stream-sink.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+LinkSigner::LinkSigner(ndn::KeyChain& keyChain)
+  : m_keyChain(keyChain)
+{
+}
+
+void LinkSigner::configure(SigningMode mode, const std::string& secretFile) {
+  m_mode = mode;
+  m_links.clear();
+  m_shared = (mode == SigningMode::DIGEST) ? ndn::security::signingWithSha256()
+                                           : ndn::security::SigningInfo();
+  if (mode != SigningMode::HMAC) {
+    return;
+  }
+
+  std::ifstream in(secretFile, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Não foi possível ler o segredo HMAC em '" + secretFile + "'.");
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  m_secret = buffer.str();
+  while (!m_secret.empty() && std::isspace(static_cast<unsigned char>(m_secret.back()))) {
+    m_secret.pop_back();
+  }
+  if (m_secret.size() < 16) {
+    throw std::runtime_error("Segredo HMAC em '" + secretFile + "' é curto demais (mínimo 16 bytes).");
+  }
+}
+
+LinkSigner::LinkId LinkSigner::addLink(const std::string& peer) {
+  const auto link = static_cast<LinkId>(m_links.size());
+  if (m_mode != SigningMode::HMAC) {
+    m_links.emplace_back();
+    return link;
+  }
+
+  ndn::util::Sha256 kdf;
+  kdf << std::string_view(m_secret);
+  const uint8_t separator = 0;
+  kdf.update({&separator, 1});
+  kdf << std::string_view(peer);
+  auto key = kdf.computeDigest();
+
+  std::ostringstream base64;
+  ndn::security::transform::bufferSource(*key) >> ndn::security::transform::base64Encode(false)
+                                               >> ndn::security::transform::streamSink(base64);
+
+  ndn::security::SigningInfo info;
+  info.setSigningHmacKey(base64.str());
+  // A chave entra no TPM na primeira assinatura; assinar um pacote descartável
+  // permite verificar o enlace antes de enviar qualquer coisa por ele.
+  ndn::Data primer{ndn::Name(peer)};
+  m_hmacKeyChain.sign(primer, info);
+  m_links.push_back(std::move(info));
+  return link;
+}
+
+const ndn::security::SigningInfo& LinkSigner::signingInfo(LinkId link) const {
+  return m_mode == SigningMode::HMAC ? m_links.at(link) : m_shared;
+}
+
+void LinkSigner::sign(ndn::Data& data, LinkId link) {
+  auto& keyChain = (m_mode == SigningMode::HMAC) ? m_hmacKeyChain : m_keyChain;
+  keyChain.sign(data, signingInfo(link));
+}
+
+void LinkSigner::sign(ndn::Interest& interest, LinkId link) {
+  auto& keyChain = (m_mode == SigningMode::HMAC) ? m_hmacKeyChain : m_keyChain;
+  keyChain.sign(interest, signingInfo(link));
+}
+
+bool LinkSigner::verify(const ndn::Data& data, LinkId link) const {
+  switch (m_mode) {
+    case SigningMode::HMAC:
+      return link < m_links.size() &&
+             ndn::security::verifySignature(data, m_hmacKeyChain.getTpm(), m_links[link].getSignerName(),
+                                            ndn::DigestAlgorithm::SHA256);
+    case SigningMode::DIGEST:
+      return ndn::security::verifyDigest(data, ndn::DigestAlgorithm::SHA256);
+    default:
+      return false;
+  }
+}
+
+bool LinkSigner::verify(const ndn::Interest& interest, LinkId link) const {
+  switch (m_mode) {
+    case SigningMode::HMAC:
+      return link < m_links.size() &&
+             ndn::security::verifySignature(interest, m_hmacKeyChain.getTpm(), m_links[link].getSignerName(),
+                                            ndn::DigestAlgorithm::SHA256);
+    case SigningMode::DIGEST:
+      return ndn::security::verifyDigest(interest, ndn::DigestAlgorithm::SHA256);
+    default:
+      return false;
+  }
+}
+
+std::shared_ptr<const ndn::Data> SignedDataCache::find(const ndn::Name& name, std::span<const uint8_t> key,
+                                                       Clock::time_point now) {
+  for (const auto& entry : m_entries) {
+    if (entry.data->getName() != name) {
+      continue;
+    }
+    if (now < entry.expiry && std::equal(key.begin(), key.end(), entry.key.begin(), entry.key.end())) {
+      m_hits++;
+      return entry.data;
+    }
+    break;
+  }
+  m_misses++;
+  return nullptr;
+}
+
+void SignedDataCache::insert(std::shared_ptr<const ndn::Data> data, std::span<const uint8_t> key,
+                             Clock::time_point now) {
+  const auto expiry = now + std::chrono::milliseconds(data->getFreshnessPeriod().count());
+  data->wireEncode();
+
+  auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& entry) {
+    return entry.data->getName() == data->getName();
+  });
+  if (it == m_entries.end() && m_entries.size() < m_capacity) {
+    it = m_entries.emplace(m_entries.end());
+  } else if (it == m_entries.end()) {
+    // Descarta a entrada que expira primeiro.
+    it = std::min_element(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+      return a.expiry < b.expiry;
+    });
+  }
+  it->data = std::move(data);
+  it->key.assign(key.begin(), key.end());   // reaproveita a capacidade da entrada
+  it->expiry = expiry;
+}
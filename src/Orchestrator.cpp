@@ -3,20 +3,59 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm> // Necessário para std::find_if
+#include <cmath>
+#include <random>
+#include <filesystem>
+#include <boost/asio/post.hpp>
 
 Orchestrator::Orchestrator()
-  : m_face(m_ioCtx),
+  : Orchestrator(nullptr, nullptr)
+{
+}
+
+Orchestrator::Orchestrator(ndn::Face& face, ndn::KeyChain& keyChain)
+  : Orchestrator(&face, &keyChain)
+{
+}
+
+// Sem Face ou KeyChain de fora, o orquestrador cria os seus.
+Orchestrator::Orchestrator(ndn::Face* face, ndn::KeyChain* keyChain)
+  : m_ownFace(face ? nullptr : std::make_unique<ndn::Face>(m_ioCtx)),
+    m_ownKeyChain(keyChain ? nullptr : std::make_unique<ndn::KeyChain>()),
+    m_face(face ? *face : *m_ownFace),
+    m_keyChain(keyChain ? *keyChain : *m_ownKeyChain),
     m_validator(m_face),
-    m_scheduler(m_ioCtx),
-    m_metricsFilename("metrics/rtt.csv") 
+    m_scheduler(m_face.getIoContext()),
+    m_metricsFilename("metrics/rtt.csv"),
+    m_trafficFilename("metrics/status_traffic.csv"),
+    m_validationFilename("metrics/validation.csv"),
+    m_engineFilename("metrics/engine.csv"),
+    m_latencyFilename("metrics/callback_latency.csv"),
+    m_rttFilename("metrics/rtt_lights.csv"),
+    m_pollingFilename("metrics/polling.csv"),
+    m_predictionFilename("metrics/prediction.csv"),
+    m_clockSyncFilename("metrics/clock_sync.csv"),
+    m_phaseTimingFilename("metrics/phase_timing.csv")
 {
-  m_validator.load("config/trust-schema.conf");
 }
 
 Orchestrator::~Orchestrator() {
   m_face.shutdown();
 }
 
+void Orchestrator::enableSimulation(uint32_t seed) {
+  m_simulated = true;
+  m_nextNonce = seed;
+}
+
+void Orchestrator::setMetricsDirectory(const std::string& dir) {
+  for (std::string* filename : {&m_metricsFilename, &m_trafficFilename, &m_validationFilename, &m_engineFilename,
+                                &m_latencyFilename, &m_rttFilename, &m_pollingFilename, &m_predictionFilename,
+                                &m_clockSyncFilename, &m_phaseTimingFilename}) {
+    *filename = (std::filesystem::path(dir) / std::filesystem::path(*filename).filename()).string();
+  }
+}
+
 void Orchestrator::setup(const std::string& prefix) {
   prefix_ = std::move(prefix);
 }
@@ -27,63 +66,195 @@ void Orchestrator::loadConfig(const std::vector<std::pair<std::string, TrafficLi
                                 const std::map<std::string, Intersection>& intersections,
                                 const std::vector<GreenWaveGroup>& greenWaves,
                                 const std::vector<SyncGroup>& syncGroups,
+                                const std::vector<AggregatorConfig>& aggregators,
+                                const ProtocolOptions& protocol,
+                                const OrchestratorOptions& options,
+                                const HierarchyRole& hierarchy,
                                 LogLevel level)
 {
   this->m_logLevel = level;
+  this->m_protocol = protocol;
+  this->m_options = options;
+  this->m_hierarchy = hierarchy;
   
   // ALTERAÇÃO: Populando o vetor a partir do vetor de pares
   trafficLights_.clear();
   for (const auto& pair : trafficLights) {
       TrafficLightState newState = pair.second;
       newState.name = pair.first; // Garante que o nome está dentro do objeto
-      newState.command = "";
+      newState.command.clear();
       trafficLights_.push_back(newState);
   }
 
-  intersections_ = intersections;
+  intersections_.clear();
+  for (const auto& [intersectionName, intersectionData] : intersections) {
+      intersections_.push_back(intersectionData);
+  }
   greenWaves_ = greenWaves;
   syncGroups_ = syncGroups;
 
-  for (const auto& [intersectionName, intersectionData] : intersections_) {
-      for (const std::string& lightName : intersectionData.trafficLightNames) {
-          if (auto* tl = findTrafficLight(lightName)) { // ALTERAÇÃO: Usando a função auxiliar
-              tl->partOfIntersection = true;
-          }
-      }
+  std::vector<std::string> lightNames;
+  lightNames.reserve(trafficLights_.size());
+  for (const auto& tl : trafficLights_) {
+      lightNames.push_back(tl.name);
   }
+  m_registry.build(lightNames, intersections_, greenWaves_, syncGroups_);
 
-  for (const auto& wave : greenWaves_) {
-      for (const std::string& lightName : wave.trafficLightNames) {
-          if (auto* tl = findTrafficLight(lightName)) { // ALTERAÇÃO
-              tl->partOfGreenWave = true;
+  m_signer.configure(protocol.signing, protocol.hmacSecretFile);
+  if (protocol.signing == SigningMode::ASYMMETRIC) {
+    m_validator.load(protocol.trustSchema);
+    log(LogLevel::INFO, "Trust schema: " + protocol.trustSchema);
+  }
+  for (const auto& name : lightNames) {
+      m_signer.addLink(name);
+  }
+
+  m_hot.resize(trafficLights_.size());
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+      m_hot.color[id] = trafficLights_[id].state;
+      m_hot.endTime[id] = trafficLights_[id].endTime;
+      m_hot.partOfIntersection[id] = m_registry.intersectionOf(id) != NO_GROUP;
+      m_hot.partOfGreenWave[id] = m_registry.waveOf(id) != NO_GROUP;
+      m_hot.partOfSyncGroup[id] = m_registry.syncGroupOf(id) != NO_GROUP;
+  }
+
+  // Sequências começam no relógio de parede para continuar crescendo se o
+  // orquestrador reiniciar; o semáforo descarta lotes com sequência antiga. O
+  // relógio é o da ndn-cxx, que na simulação é o de parede virtual, então a
+  // mesma semente reproduz as mesmas sequências.
+  const uint64_t seqBase = static_cast<uint64_t>(ndn::time::duration_cast<ndn::time::microseconds>(
+      ndn::time::system_clock::now().time_since_epoch()).count());
+  m_commandSeq.assign(trafficLights_.size(), seqBase);
+  m_heldCommandInterests.clear();
+  m_heldCommandInterests.resize(trafficLights_.size());
+  m_mailboxes = std::vector<CommandMailbox>(trafficLights_.size());
+  m_commandMask.assign(trafficLights_.size(), 0);
+  m_reachable.resize(trafficLights_.size());
+  m_reachable.set();
+  // Folga para alguns segundos de estados de todos os semáforos entre duas passagens.
+  m_ingest.reset(std::max<size_t>(1024, 4 * trafficLights_.size()));
+
+  m_regions.clear();
+  m_lightRegion.assign(trafficLights_.size(), NO_GROUP);
+  m_relayed.assign(trafficLights_.size(), 0);
+  m_relayedLights.clear();
+  auto addRegion = [&](const std::string& prefix, bool orchestrated, uint32_t lightCount) {
+      const GroupId regionId = static_cast<GroupId>(m_regions.size());
+      AggregateRegion region;
+      region.prefix = prefix;
+      region.orchestrated = orchestrated;
+      region.lightCount = lightCount;
+      region.fetchName = orchestrated ? ndn::Name(prefix).append("_orch").append("summary")
+                                      : ndn::Name(prefix).append("_agg");
+      m_regions.push_back(std::move(region));
+      m_signer.addLink(prefix);   // enlace lights + regionId
+      const std::string lightPrefix = prefix + "/";
+      for (LightId id = 0; id < trafficLights_.size(); ++id) {
+          if (m_lightRegion[id] == NO_GROUP && trafficLights_[id].name.compare(0, lightPrefix.size(), lightPrefix) == 0) {
+              m_lightRegion[id] = regionId;
+              if (orchestrated) {
+                  m_relayed[id] = 1;
+                  m_relayedLights.push_back(id);
+              }
           }
       }
+  };
+  for (const auto& aggregator : aggregators) {
+      addRegion(aggregator.region, false, 0);
+  }
+  for (const auto& [prefix, lightCount] : hierarchy.subRegions) {
+      addRegion(prefix, true, lightCount);
+  }
+  m_rtt.assign(trafficLights_.size() + m_regions.size(), RttEstimator{});
+  m_rttReported.assign(m_rtt.size(), 0);
+  m_pending.resize(trafficLights_.size(), config::STATUS_IN_FLIGHT);
+  if (!m_simulated) {
+      m_nextNonce = std::random_device{}();
   }
 
-  for (const auto& group : syncGroups_) {
-      for (const std::string& lightName : group.trafficLightNames) {
-          if (auto* tl = findTrafficLight(lightName)) { // ALTERAÇÃO
-              tl->partOfSyncGroup = true;
-          }
+  // Fases espalhadas por igual no período; a roda cobre o maior intervalo.
+  const uint64_t periodSlots = config::POLL_PERIOD_MS / config::POLL_SLOT_MS;
+  m_pollWheel.reset(config::POLL_RECONTACT_MS / config::POLL_SLOT_MS + 1);
+  m_pollPhase.resize(trafficLights_.size());
+  m_pollEnd.assign(trafficLights_.size(), 0);
+  m_lightClock.assign(trafficLights_.size(), LightClock{});
+  m_lightTiming.assign(trafficLights_.size(), LightTiming{});
+  m_timingDue.assign(trafficLights_.size(), 0);
+  m_phaseDurations.resize(trafficLights_.size());
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+      m_phaseDurations[id] = phase::defaultDurations(trafficLights_[id].cycle);
+  }
+  m_plannedDurations = m_phaseDurations;
+  m_plans.assign(trafficLights_.size(), phase::Plan{});
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+      m_pollPhase[id] = static_cast<uint16_t>(id * periodSlots / trafficLights_.size());
+      m_pollWheel.schedule(id, m_pollWheel.nextAligned(periodSlots, m_pollPhase[id]));
+  }
+  m_regionPriority = std::vector<std::atomic<float>>(m_regions.size());
+  for (auto& average : m_regionPriority) {
+      average.store(std::nanf(""), std::memory_order_relaxed);
+  }
+
+  m_boundaryLights.clear();
+  for (const auto& name : hierarchy.boundaryLights) {
+      if (LightId id = m_registry.find(name); id != INVALID_LIGHT) {
+          m_boundaryLights.push_back(id);
       }
   }
+  if (!hierarchy.region.empty()) {
+      m_upstreamLink = m_signer.addLink(hierarchy.region);
+  }
+  m_relayedCommands.reset(std::max<size_t>(64, 4 * m_boundaryLights.size()));
+
+  sortedPriorityCache_.assign(intersections_.size(), {});
+  m_activeLightPerIntersection.assign(intersections_.size(), INVALID_LIGHT);
+  m_allRedSince.assign(intersections_.size(), 0);
+
+  // Com um worker tudo fica num shard só; com mais, cada worker recebe alguns
+  // shards para que o roubo de trabalho compense componentes de tamanhos desiguais.
+  const size_t workers = m_options.workers > 0
+      ? static_cast<size_t>(m_options.workers)
+      : std::max<size_t>(1, std::thread::hardware_concurrency());
+  m_partition.build(m_registry, workers > 1 ? workers * config::SHARDS_PER_WORKER : 1);
+  m_shards = std::vector<ShardState>(m_partition.size());
+  m_pool = workers > 1 ? std::make_unique<ShardPool>(workers) : nullptr;
+  m_changedMask.assign(trafficLights_.size(), 0);
+  m_pendingIntersections.assign(intersections_.size(), 0);
+  m_pendingWaves.assign(greenWaves_.size(), 0);
+  m_pendingSyncGroups.assign(syncGroups_.size(), 0);
+  m_scheduledEnd.assign(trafficLights_.size(), 0);
 
   std::stringstream ss;
   ss << "Configuração carregada. " << trafficLights_.size() << " semáforos, "
      << intersections_.size() << " cruzamentos, " << greenWaves_.size() << " ondas verdes e "
-     << syncGroups_.size() << " grupos de sincronia.";
+     << syncGroups_.size() << " grupos de sincronia e " << m_regions.size() << " regiões agregadas.";
   log(LogLevel::INFO, ss.str());
+  log(LogLevel::INFO, "Motor de regras com " + std::to_string(workers) + " worker(s): " +
+      std::to_string(m_partition.componentCount()) + " componentes independentes em " +
+      std::to_string(m_partition.size()) + " shard(s).");
+  if (!hierarchy.region.empty()) {
+      log(LogLevel::INFO, "Orquestrador regional de " + hierarchy.region + ": " +
+          std::to_string(m_boundaryLights.size()) + " semáforos de fronteira coordenados por " + hierarchy.upstream + ".");
+      publishSummary();
+  } else if (!hierarchy.subRegions.empty()) {
+      log(LogLevel::INFO, "Orquestrador da cidade: " + std::to_string(hierarchy.subRegions.size()) +
+          " regiões com orquestrador próprio, " + std::to_string(m_relayedLights.size()) + " semáforos de fronteira.");
+  }
 
-  // ALTERAÇÃO: Iterando sobre o vetor
-  for (const auto& tl : trafficLights_) {
-      log(LogLevel::DEBUG, " - Semáforo: " + tl.name + 
-          " (Cruzamento: " + (tl.partOfIntersection ? "S" : "N") +
-          ", Onda Verde: " + (tl.partOfGreenWave ? "S" : "N") +
-          ", Grupo Sync: " + (tl.partOfSyncGroup ? "S" : "N") + ")");
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+      log(LogLevel::DEBUG, " - Semáforo: " + trafficLights_[id].name + 
+          " (Cruzamento: " + (m_hot.partOfIntersection[id] ? "S" : "N") +
+          ", Onda Verde: " + (m_hot.partOfGreenWave[id] ? "S" : "N") +
+          ", Grupo Sync: " + (m_hot.partOfSyncGroup[id] ? "S" : "N") + ")");
   }
 }
 
 void Orchestrator::run() {
+  start();
+  m_face.processEvents();
+}
+
+void Orchestrator::start() {
   std::ofstream outFile(m_metricsFilename, std::ios_base::trunc);
   if (outFile.is_open()) {
     outFile << "rtt_ms\n";
@@ -92,11 +263,75 @@ void Orchestrator::run() {
   } else {
     log(LogLevel::ERROR, "Não foi possível inicializar o arquivo de métricas: " + m_metricsFilename);
   }
+  std::ofstream trafficFile(m_trafficFilename, std::ios_base::trunc);
+  if (trafficFile.is_open()) {
+    trafficFile << "window_s,lights,poll_equivalent_pps,actual_pps,saved_pps\n";
+  }
+  std::ofstream validationFile(m_validationFilename, std::ios_base::trunc);
+  if (validationFile.is_open()) {
+    validationFile << "window_s,verified,memo_hits,failures,avg_latency_us,max_latency_us,packets_per_s\n";
+  }
+  std::ofstream engineFile(m_engineFilename, std::ios_base::trunc);
+  if (engineFile.is_open()) {
+    engineFile << "window_s,evaluations,changed_lights,groups_evaluated,groups_per_evaluation,max_groups,total_groups,shards,steals\n";
+  }
+  std::ofstream latencyFile(m_latencyFilename, std::ios_base::trunc);
+  if (latencyFile.is_open()) {
+    latencyFile << "window_s,callbacks,p50_us,p90_us,p99_us,max_us,ingest_drops\n";
+  }
+  std::ofstream rttFile(m_rttFilename, std::ios_base::trunc);
+  if (rttFile.is_open()) {
+    rttFile << "window_s,link,samples,srtt_ms,rttvar_ms,rto_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+  }
+  std::ofstream pollingFile(m_pollingFilename, std::ios_base::trunc);
+  if (pollingFile.is_open()) {
+    pollingFile << "window_s,polls,visits,max_burst,p99_burst,lateness_p50_us,lateness_p99_us,lateness_max_us\n";
+  }
+  std::ofstream clockSyncFile(m_clockSyncFilename, std::ios_base::trunc);
+  if (clockSyncFile.is_open()) {
+    clockSyncFile << "window_s,light,offset_ms,error_bound_ms\n";
+  }
+  std::ofstream phaseTimingFile(m_phaseTimingFilename, std::ios_base::trunc);
+  if (phaseTimingFile.is_open()) {
+    phaseTimingFile << "window_s,light,transitions,lateness_p50_us,lateness_p99_us,lateness_max_us,real_time\n";
+  }
+  if (m_protocol.statusMode == StatusMode::PREDICT) {
+    std::ofstream predictionFile(m_predictionFilename, std::ios_base::trunc);
+    if (predictionFile.is_open()) {
+      predictionFile << "window_s,reports,phase_mismatches,avg_error_ms,max_error_ms\n";
+    }
+  }
 
+  m_scheduler.schedule(ndn::time::milliseconds(0), [this]{ prefetchCertificates(); });
   m_scheduler.schedule(ndn::time::seconds(1), [this]{ runConsumer(); });
+  m_pollTickDue = steadyNow() + std::chrono::seconds(1);
+  m_pollTickEvent = m_scheduler.schedule(ndn::time::seconds(1), [this]{ pollTick(); });
+  // Consultas do atraso das trocas espalhadas por igual no período, feitas nas
+  // visitas da roda de poll.
+  const Ticks timingStart = nowTicks();
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+    m_timingDue[id] = timingStart + config::PHASE_TIMING_FETCH_MS * static_cast<Ticks>(id + 1) /
+                                        static_cast<Ticks>(trafficLights_.size());
+  }
   runProducer("command");
-  m_cycleThread = std::jthread([this] { this->cycle(); }); 
-  m_face.processEvents();
+  if (!m_hierarchy.region.empty()) {
+    m_summaryPrefix = ndn::Name(prefix_).append("summary");
+    runProducer("summary");
+    for (LightId id : m_boundaryLights) {
+      relayCommands(id);
+    }
+  }
+  if (m_protocol.statusMode != StatusMode::POLL) {
+    // O prazo do primeiro heartbeat conta a partir da partida do orquestrador.
+    std::fill(m_hot.lastReport.begin(), m_hot.lastReport.end(), nowTicks());
+    runProducer("status");
+  }
+  m_fullEvaluation = true;
+  if (m_options.engine == EngineMode::TICK) {
+    m_cycleThread = std::jthread([this] { this->cycle(); });
+  } else {
+    startEventEngine();
+  }
 }
 
 void Orchestrator::appendToMetricsFile(int rtt_ms) {
@@ -109,8 +344,12 @@ void Orchestrator::appendToMetricsFile(int rtt_ms) {
     outFile.close();
 }
 
+bool Orchestrator::logs(LogLevel level) const {
+    return level <= m_logLevel;
+}
+
 void Orchestrator::log(LogLevel level, const std::string& message) {
-    if (level <= m_logLevel) {
+    if (logs(level)) {
         std::string levelStr;
         switch (level) {
             case LogLevel::ERROR: levelStr = "[ERROR]"; break;
@@ -119,30 +358,236 @@ void Orchestrator::log(LogLevel level, const std::string& message) {
             default: return;
         }
         
+        // Uma única escrita por linha: com vários workers o motor também registra.
         auto& stream = (level == LogLevel::ERROR) ? std::cerr : std::cout;
-        stream << levelStr << " [" << this->prefix_ << "] " << message << std::endl;
+        stream << (levelStr + " [" + this->prefix_ + "] " + message + "\n") << std::flush;
     }
 }
 
 void Orchestrator::cycle() {
     const auto cycleInterval = std::chrono::seconds(1);
-    const int allRedTimeoutCycles = 5; 
+    std::vector<LightId> ready;
 
     while (!m_stopFlag) {
-        auto cycleStart = std::chrono::steady_clock::now();
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto now = std::chrono::steady_clock::now();
-
-            if (syncGroups_.size()>0) processSyncGroups();
-            assignPriorityCommands();
-            if (intersections_.size()>0) processIntersections(allRedTimeoutCycles);
-            if (greenWaves_.size()>0) processGreenWaves();
+        evaluateDirty(nowTicks(), true, ready);
+        if (!ready.empty()) {
+            boost::asio::post(m_face.getIoContext(), [this, ids = std::move(ready)] { flushHeldInterests(ids); });
+            ready.clear();
         }
         std::this_thread::sleep_for(cycleInterval);
     }
 }
 
+void Orchestrator::startEventEngine() {
+    // As passagens partem do io_context da Face: os prazos e os callbacks de Data
+    // não competem por thread. Com mais de um worker a thread de I/O espera os
+    // shards da passagem. A primeira avaliação cobre todos os grupos.
+    log(LogLevel::INFO, "Motor de regras por eventos.");
+    requestEvaluation();
+    schedulePriorityPass();
+}
+
+void Orchestrator::schedulePriorityPass() {
+    // Os ajustes de prioridade têm histerese contada em passos de 1 s e dependem
+    // da média global, então continuam periódicos.
+    m_priorityEvent = m_scheduler.schedule(ndn::time::milliseconds(config::PRIORITY_PASS_MS), [this] {
+        std::vector<LightId> ready;
+        const Ticks now = nowTicks();
+        evaluateDirty(now, true, ready);
+        if (hasPendingChanges()) {
+            requestEvaluation();
+        }
+        armWake(now);
+        flushHeldInterests(ready);
+        schedulePriorityPass();
+    });
+}
+
+// Estado novo de um semáforo, recebido ou produzido pelas regras; a próxima
+// passagem avalia os grupos que o contêm.
+void Orchestrator::noteChange(LightId id) {
+    if (!m_changedMask[id]) {
+        m_changedMask[id] = 1;
+        m_shards[m_partition.shardOfLight(id)].changedLights.push_back(id);
+    }
+}
+
+bool Orchestrator::hasPendingChanges() const {
+    return std::any_of(m_shards.begin(), m_shards.end(),
+                       [](const ShardState& shard) { return !shard.changedLights.empty(); });
+}
+
+void Orchestrator::requestEvaluation() {
+    // Vários Data no mesmo lote de I/O geram uma única avaliação.
+    if (m_evaluationPending) {
+        return;
+    }
+    m_evaluationPending = true;
+    boost::asio::post(m_face.getIoContext(), [this] { evaluate(); });
+}
+
+void Orchestrator::scheduleDeadline(DeadlineQueue::Kind kind, uint32_t target, Ticks due) {
+    const uint32_t shardId = (kind == DeadlineQueue::Kind::PHASE_END)
+        ? m_partition.shardOfLight(target)
+        : m_partition.shardOfIntersection(static_cast<GroupId>(target));
+    m_shards[shardId].deadlines.push(due, kind, target);
+}
+
+void Orchestrator::armWake(Ticks now) {
+    std::optional<Ticks> next;
+    for (const auto& shard : m_shards) {
+        if (!shard.deadlines.empty() && (!next || shard.deadlines.nextDue() < *next)) {
+            next = shard.deadlines.nextDue();
+        }
+    }
+    if (!next) {
+        m_wakeEvent.cancel();
+        return;
+    }
+    const Ticks delay = std::max<Ticks>(*next - now, 0);
+    m_wakeEvent = m_scheduler.schedule(ndn::time::milliseconds(delay), [this] { evaluate(); });
+}
+
+void Orchestrator::evaluate() {
+    std::vector<LightId> ready;
+    m_evaluationPending = false;
+    const Ticks now = nowTicks();
+    evaluateDirty(now, false, ready);
+    // Mudanças feitas pelas regras desta passagem pedem a seguinte.
+    if (hasPendingChanges()) {
+        requestEvaluation();
+    }
+    armWake(now);
+    flushHeldInterests(ready);
+}
+
+// Uma passagem do motor. A ingestão, a média global e as estatísticas ficam na
+// thread que chama; os shards são avaliados pelo pool, quando há um.
+void Orchestrator::evaluateDirty(Ticks now, bool priorityPass, std::vector<LightId>& ready) {
+    drainIngest();
+
+    const bool full = std::exchange(m_fullEvaluation, false);
+    const float averagePriority = priorityPass ? calculateAveragePriority() : 0.0f;
+    const auto task = [&](size_t shardId) {
+        evaluateShard(static_cast<uint32_t>(shardId), now, full, priorityPass, averagePriority);
+    };
+    if (m_pool) {
+        m_pool->run(m_shards.size(), task);
+    } else {
+        for (size_t shardId = 0; shardId < m_shards.size(); ++shardId) {
+            task(shardId);
+        }
+    }
+
+    size_t changedLights = 0;
+    size_t groups = 0;
+    for (auto& shard : m_shards) {
+        changedLights += shard.changedCount;
+        groups += shard.groupCount;
+        ready.insert(ready.end(), shard.ready.begin(), shard.ready.end());
+        shard.ready.clear();
+    }
+
+    m_engineStats.evaluations.fetch_add(1, std::memory_order_relaxed);
+    m_engineStats.changedLights.fetch_add(changedLights, std::memory_order_relaxed);
+    m_engineStats.groupsEvaluated.fetch_add(groups, std::memory_order_relaxed);
+    uint64_t maxGroups = m_engineStats.maxGroups.load(std::memory_order_relaxed);
+    while (groups > maxGroups && !m_engineStats.maxGroups.compare_exchange_weak(maxGroups, groups, std::memory_order_relaxed)) {
+    }
+    if (groups > 0) {
+        log(LogLevel::DEBUG, "Avaliação: " + std::to_string(changedLights) + " semáforos alterados, " +
+            std::to_string(groups) + " grupos avaliados.");
+    }
+    if (!m_boundaryLights.empty() && (priorityPass || changedLights > 0)) {
+        publishSummary();
+    }
+}
+
+namespace {
+
+void markGroup(std::vector<uint8_t>& flags, std::vector<GroupId>& pending, GroupId group) {
+    if (!flags[group]) {
+        flags[group] = 1;
+        pending.push_back(group);
+    }
+}
+
+void markAll(std::vector<uint8_t>& flags, std::vector<GroupId>& pending, const std::vector<GroupId>& groups) {
+    for (GroupId group : groups) {
+        markGroup(flags, pending, group);
+    }
+}
+
+} // namespace
+
+void Orchestrator::evaluateShard(uint32_t shardId, Ticks now, bool full, bool priorityPass,
+                                 float averagePriority) {
+    auto& state = m_shards[shardId];
+    const auto& shard = m_partition.shards()[shardId];
+
+    // Prazos vencidos marcam o semáforo (fim de fase) ou o cruzamento (todo em vermelho).
+    while (!state.deadlines.empty() && state.deadlines.nextDue() <= now) {
+        const auto entry = state.deadlines.pop();
+        if (entry.kind == DeadlineQueue::Kind::PHASE_END) {
+            if (m_hot.endTime[entry.target] == entry.due) {
+                if (m_protocol.statusMode == StatusMode::PREDICT) {
+                    // O semáforo só notifica desvios: a troca prevista é feita aqui.
+                    phase::advance(m_hot.color[entry.target], m_hot.endTime[entry.target], now,
+                                   m_phaseDurations[entry.target], m_plans[entry.target]);
+                }
+                noteChange(entry.target);
+            }
+        } else {
+            markGroup(m_pendingIntersections, state.pendingIntersections, static_cast<GroupId>(entry.target));
+        }
+    }
+
+    // Cada semáforo alterado marca os grupos que o contêm. Mudanças feitas pelas
+    // regras abaixo voltam para changedLights e ficam para a próxima passagem.
+    std::swap(state.evaluating, state.changedLights);
+    for (LightId id : state.evaluating) {
+        m_changedMask[id] = 0;
+        const Ticks endTime = m_hot.endTime[id];
+        if (endTime != m_scheduledEnd[id] && endTime > now) {
+            m_scheduledEnd[id] = endTime;
+            state.deadlines.push(endTime, DeadlineQueue::Kind::PHASE_END, id);
+        }
+        if (GroupId g = m_registry.intersectionOf(id); g != NO_GROUP) markGroup(m_pendingIntersections, state.pendingIntersections, g);
+        if (GroupId g = m_registry.waveOf(id); g != NO_GROUP) markGroup(m_pendingWaves, state.pendingWaves, g);
+        if (GroupId g = m_registry.syncGroupOf(id); g != NO_GROUP) markGroup(m_pendingSyncGroups, state.pendingSyncGroups, g);
+    }
+    state.changedCount = state.evaluating.size();
+    state.evaluating.clear();
+
+    if (full) {
+        markAll(m_pendingIntersections, state.pendingIntersections, shard.intersections);
+        markAll(m_pendingWaves, state.pendingWaves, shard.waves);
+        markAll(m_pendingSyncGroups, state.pendingSyncGroups, shard.syncGroups);
+    }
+    state.groupCount = state.pendingSyncGroups.size() + state.pendingIntersections.size() + state.pendingWaves.size();
+
+    for (GroupId g : state.pendingSyncGroups) {
+        m_pendingSyncGroups[g] = 0;
+        processSyncGroup(g, now);
+    }
+    if (priorityPass) {
+        assignPriorityCommands(shard, averagePriority, now);
+    }
+    for (GroupId g : state.pendingIntersections) {
+        m_pendingIntersections[g] = 0;
+        processIntersection(g, now);
+    }
+    for (GroupId g : state.pendingWaves) {
+        m_pendingWaves[g] = 0;
+        processGreenWave(g, now);
+    }
+    state.pendingSyncGroups.clear();
+    state.pendingIntersections.clear();
+    state.pendingWaves.clear();
+
+    publishCommands(state);
+}
+
 void Orchestrator::runProducer(const std::string& suffix){
   ndn::Name nameSuffix = ndn::Name(prefix_).append(suffix);
   m_face.setInterestFilter(nameSuffix,
@@ -152,10 +597,18 @@ void Orchestrator::runProducer(const std::string& suffix){
       [this](const ndn::Name& name, const std::string& reason) {
         this->onRegisterFailed(name, reason);
       });
+  if (m_certServed) {
+    return;
+  }
+  m_certServed = true;
+  // Em /<identidade>/KEY, e não na identidade inteira: com a identidade /central
+  // o filtro pegaria também /central/command e /central/status.
   auto cert = m_keyChain.getPib().getDefaultIdentity().getDefaultKey().getDefaultCertificate();
-  m_certServeHandle = m_face.setInterestFilter(security::extractIdentityFromCertName(cert.getName()),
-                                                [this, cert] (auto&&...) {
-                                                  m_face.put(cert);
+  m_certServeHandle = m_face.setInterestFilter(security::extractIdentityFromCertName(cert.getName()).append(status::CERT_COMPONENT),
+                                                [this, cert] (const ndn::InterestFilter&, const ndn::Interest& interest) {
+                                                  if (interest.matchesData(cert)) {
+                                                    m_face.put(cert);
+                                                  }
                                                 },
                                                 std::bind(&Orchestrator::onRegisterFailed, this, _1, _2));
   log(LogLevel::INFO, "Registrando produtor para o prefixo: " + nameSuffix.toUri());                                                            
@@ -163,55 +616,330 @@ void Orchestrator::runProducer(const std::string& suffix){
 
 
 void Orchestrator::onInterest(const ndn::Interest& interest) {
+  ScopedLatency latency(m_callbackLatency);
   const auto& name = interest.getName();
-  bool isCommand = false;
+  if (!m_summaryPrefix.empty() && m_summaryPrefix.isPrefixOf(name)) {
+    serveSummary(interest);
+    return;
+  }
+  std::string kind;
   std::string trafficLightName;
 
   for (size_t i = 0; i < name.size(); ++i) {
-    const auto& component = name.get(i).toUri();
-    if (component == "command" && i + 1 < name.size()) {
-      isCommand = true;
-      std::ostringstream oss;
-      for (size_t j = i + 1; j < name.size(); ++j) {
-        oss << "/" << name.get(j).toUri();
-      }
-      trafficLightName = oss.str();
+    std::string component = name.get(i).toUri();
+    if ((component == "command" || component == "status") && i + 1 < name.size()) {
+      kind = component;
+      // O semáforo acrescenta um número de sequência para que cada Interest seja
+      // único e nunca seja atendido pelo Content Store; Interests de estado
+      // assinados trazem ainda o digest dos ApplicationParameters.
+      size_t end = name.size();
+      if (name.get(end - 1).isParametersSha256Digest()) end--;
+      if (end > i + 1 && name.get(end - 1).isSequenceNumber()) end--;
+      trafficLightName = name.getSubName(i + 1, end - (i + 1)).toUri();
       break;
     }
   }
 
-  if (isCommand) {
-    // ALTERAÇÃO: Usando a função auxiliar para checar a existência
-    if (!findTrafficLight(trafficLightName)) {
-      log(LogLevel::ERROR, "Comando recebido para semáforo desconhecido: " + trafficLightName);
-      return;
-    }
-    return produce(trafficLightName, interest);
-  } else {
+  if (kind.empty()) {
     log(LogLevel::ERROR, "Interest com sufixo inválido recebido: " + name.toUri());
     return;
   }
+  LightId id = m_registry.find(trafficLightName);
+  if (id == INVALID_LIGHT) {
+    log(LogLevel::ERROR, "Interest de " + kind + " recebido para semáforo desconhecido: " + trafficLightName);
+    return;
+  }
+  if (kind == "status") {
+    return ingestStatusReport(id, interest);
+  }
+  return produce(id, interest);
 }
 
-void Orchestrator::produce(const std::string& trafficLightName, const ndn::Interest& interest) {
-  log(LogLevel::INFO, "Processando comando para " + trafficLightName);
-  std::string command;
-  auto data = std::make_shared<ndn::Data>(interest.getName());
-  {
-      std::lock_guard<std::mutex> guard(mutex_);
-      // ALTERAÇÃO: Usando a função auxiliar para buscar e modificar
-      if (auto* tl = findTrafficLight(trafficLightName)) {
-          command = tl->command;
-          tl->command = "";
+void Orchestrator::ingestStatusReport(LightId id, const ndn::Interest& interest) {
+  m_verifier.verify(interest, id,
+      [this, id, interest] { acceptStatusReport(id, interest); },
+      [this, name = interest.getName()](const std::string& reason) {
+        log(LogLevel::ERROR, "Notificação de estado rejeitada (" + reason + "): " + name.toUri());
+      });
+}
+
+void Orchestrator::acceptStatusReport(LightId id, const ndn::Interest& interest) {
+  if (!interest.hasApplicationParameters()) {
+    log(LogLevel::ERROR, "Notificação de estado sem parâmetros: " + interest.getName().toUri());
+    return;
+  }
+  const auto& params = interest.getApplicationParameters();
+  auto report = status::decode(std::span<const uint8_t>(params.value(), params.value_size()));
+  if (!report) {
+    log(LogLevel::ERROR, "Notificação de estado malformada: " + interest.getName().toUri());
+    return;
+  }
+
+  m_statusTraffic.pushReports++;
+  // Notificações podem chegar fora de ordem; uma mais antiga não sobrescreve o estado.
+  if (report->sequence > m_hot.statusSeq[id] || !m_reachable[id]) {
+    ingestStatus(id, *report, rttFor(id).oneWayMs(), nowTicks());
+  }
+  m_statusTraffic.pushAcks++;
+  log(LogLevel::DEBUG, "Notificação de estado de " + m_registry.nameOf(id) + ": " + ToString(report->phase));
+
+  auto ack = std::make_shared<ndn::Data>(interest.getName());
+  ack->setFreshnessPeriod(ndn::time::milliseconds(0));
+  m_signer.sign(*ack, id);
+  m_face.put(*ack);
+}
+
+void Orchestrator::produce(LightId id, const ndn::Interest& interest) {
+  const Ticks receivedAt = nowTicks();
+  log(LogLevel::DEBUG, "Processando comando para " + m_registry.nameOf(id));
+  CommandBatch batch = takeCommand(id);
+  if (batch.empty()) {
+      holdInterest(id, interest, receivedAt);
+      return;
+  }
+  answerCommand(id, interest, batch, receivedAt);
+}
+
+CommandBatch Orchestrator::takeCommand(LightId id) {
+  auto batch = m_mailboxes[id].take();
+  if (!batch || batch->empty()) {
+      return CommandBatch{};
+  }
+  batch->sequence = ++m_commandSeq[id];
+  return *batch;
+}
+
+void Orchestrator::holdInterest(LightId id, const ndn::Interest& interest, Ticks receivedAt) {
+  // Sem comando pendente: o Interest fica retido até surgir um comando para o
+  // semáforo ou até pouco antes de expirar, quando é respondido vazio.
+  ndn::time::milliseconds lifetime = interest.getInterestLifetime();
+  auto holdFor = std::max(lifetime - ndn::time::milliseconds(config::COMMAND_HOLD_MARGIN_MS),
+                          ndn::time::milliseconds(0));
+
+  auto& held = m_heldCommandInterests[id];
+  if (held.interest && held.interest->getName() != interest.getName()) {
+      // O semáforo expressou outro Interest (p.ex. ao reconectar): o anterior é
+      // respondido vazio em vez de ficar sem resposta até expirar. Uma
+      // retransmissão com o mesmo nome só renova o retido.
+      std::optional<ndn::Interest> previous = std::move(held.interest);
+      held.interest.reset();
+      held.expiry.cancel();
+      log(LogLevel::DEBUG, "Substituindo Interest retido de " + m_registry.nameOf(id));
+      answerCommand(id, *previous, CommandBatch{}, held.receivedAt);
+  }
+  held.interest = interest;
+  held.receivedAt = receivedAt;
+  held.expiry = m_scheduler.schedule(holdFor, [this, id] {
+      auto& entry = m_heldCommandInterests[id];
+      std::optional<ndn::Interest> expired = std::move(entry.interest);
+      entry.interest.reset();
+      if (expired) {
+          answerCommand(id, *expired, CommandBatch{}, entry.receivedAt);
+      }
+  });
+}
+
+// Chamada na thread de I/O com os semáforos que receberam comandos na última passagem.
+void Orchestrator::flushHeldInterests(const std::vector<LightId>& ids) {
+  for (LightId id : ids) {
+      auto& held = m_heldCommandInterests[id];
+      if (!held.interest) {
+          continue;
+      }
+      CommandBatch batch = takeCommand(id);
+      if (batch.empty()) {
+          continue;
+      }
+      std::optional<ndn::Interest> interest = std::move(held.interest);
+      held.interest.reset();
+      held.expiry.cancel();
+      log(LogLevel::DEBUG, "Respondendo Interest retido de " + m_registry.nameOf(id));
+      answerCommand(id, *interest, batch, held.receivedAt);
+  }
+}
+
+// Lote em montagem na passagem atual do motor; publishCommands() o entrega.
+CommandBatch& Orchestrator::commandFor(LightId id) {
+  if (!m_commandMask[id]) {
+      m_commandMask[id] = 1;
+      m_shards[m_partition.shardOfLight(id)].commandLights.push_back(id);
+  }
+  return trafficLights_[id].command;
+}
+
+// Há comandos para o semáforo ainda não retirados pela thread de I/O.
+bool Orchestrator::hasPendingCommand(LightId id) const {
+  return !trafficLights_[id].command.empty() || m_mailboxes[id].pending();
+}
+
+void Orchestrator::clearCommand(LightId id) {
+  trafficLights_[id].command.clear();
+  m_mailboxes[id].discard();
+}
+
+// Motor: o lote do semáforo passa a levar um plano com as próximas fases, a
+// partir da fase atual em m_hot e das durações planejadas para ele.
+void Orchestrator::sendPlan(LightId id) {
+  auto& plan = m_plans[id];
+  plan.clear();
+  Color color = m_hot.color[id];
+  Ticks end = m_hot.endTime[id];
+  if (!phase::cycles(color)) {
+      return;
+  }
+  plan.push(color, end);
+  while (plan.count < phase::Plan::CAPACITY) {
+      color = phase::next(color);
+      end += m_plannedDurations[id].of(color);
+      plan.push(color, end);
+  }
+  commandFor(id).plan = plan;
+}
+
+size_t Orchestrator::plannedPhasesLeft(LightId id, Ticks now) const {
+  const auto& plan = m_plans[id];
+  return static_cast<size_t>(std::count_if(plan.begin(), plan.end(),
+                                           [now](const phase::PlanEntry& entry) { return entry.end > now; }));
+}
+
+void Orchestrator::publishCommands(ShardState& shard) {
+  for (LightId id : shard.commandLights) {
+      m_commandMask[id] = 0;
+      auto& batch = trafficLights_[id].command;
+      if (!batch.empty()) {
+          m_mailboxes[id].publish(batch);
+          batch.clear();
+          shard.ready.push_back(id);
       }
   }
-  data->setContent(std::string_view(command)); 
+  shard.commandLights.clear();
+}
+
+// Toda resposta, mesmo sem comandos, leva a chegada do Interest e o instante de
+// envio: é a amostra com que o semáforo sincroniza o relógio (ClockSync.hpp).
+void Orchestrator::answerCommand(LightId id, const ndn::Interest& interest, CommandBatch batch, Ticks receivedAt) {
+  auto data = std::make_shared<ndn::Data>(interest.getName());
+  batch.receivedAt = receivedAt;
+  batch.sentAt = nowTicks();
+  command::CommandBuffer buffer;
+  size_t length = command::encode(batch, buffer);
+  data->setContent(ndn::make_span(buffer.data(), length));
   data->setFreshnessPeriod(ndn::time::seconds(1));
 
-  m_keyChain.sign(*data);
+  m_signer.sign(*data, id);
   m_face.put(*data);
 }
 
+// Motor: fotografa os semáforos de fronteira para o próximo resumo pedido pela cidade.
+void Orchestrator::publishSummary() {
+  auto snapshot = std::make_shared<RegionSnapshot>();
+  snapshot->summary.lightCount = static_cast<uint32_t>(trafficLights_.size());
+  snapshot->summary.averagePriority = m_hot.averagePriority();
+  snapshot->lights.reserve(m_boundaryLights.size());
+  for (LightId id : m_boundaryLights) {
+    snapshot->lights.push_back({id, m_hot.color[id], m_hot.endTime[id], m_hot.priority[id], m_hot.queueLength[id]});
+  }
+  m_summary.store(std::move(snapshot), std::memory_order_release);
+}
+
+// Thread de I/O: /<região>/_orch/summary -> /<região>/_orch/summary/<versão>/<segmento 0>.
+void Orchestrator::serveSummary(const ndn::Interest& interest) {
+  const auto snapshot = m_summary.load(std::memory_order_acquire);
+  if (!snapshot) {
+    return;
+  }
+  const Ticks now = nowTicks();
+  std::vector<uint8_t> payload;
+  payload.reserve(status::REGION_SUMMARY_MAX_SIZE);
+  status::appendRegionSummary(payload, snapshot->summary);
+  size_t skipped = 0;
+  for (const auto& light : snapshot->lights) {
+    status::StatusReport report;
+    report.phase = light.phase;
+    report.remainingMs = static_cast<uint32_t>(std::max<Ticks>(light.endTime - now, 0));
+    report.priority = light.priority;
+    report.queueLength = light.queueLength;
+    const std::string_view suffix = std::string_view(m_registry.nameOf(light.id)).substr(m_hierarchy.region.size());
+    if (!status::appendAggregateEntry(payload, suffix, report, status::REGION_SUMMARY_MAX_SIZE)) {
+      skipped++;
+    }
+  }
+  if (skipped > 0) {
+    log(LogLevel::ERROR, std::to_string(skipped) + " semáforos de fronteira não couberam no resumo.");
+  }
+
+  const uint64_t version = std::max<uint64_t>(m_summaryVersion + 1,
+      ndn::time::toUnixTimestamp(ndn::time::system_clock::now()).count());
+  m_summaryVersion = version;
+  auto data = std::make_shared<ndn::Data>(ndn::Name(m_summaryPrefix).appendVersion(version).appendSegment(0));
+  data->setContent(ndn::make_span(payload.data(), payload.size()));
+  data->setFreshnessPeriod(ndn::time::milliseconds(config::SUMMARY_FRESHNESS_MS));
+  data->setFinalBlock(ndn::name::Component::fromSegment(0));
+  m_signer.sign(*data, m_upstreamLink);
+  m_face.put(*data);
+}
+
+// Thread de I/O: mantém um Interest de comando na cidade por semáforo de
+// fronteira, como o próprio semáforo faria se falasse com ela.
+void Orchestrator::relayCommands(LightId id) {
+  ndn::Name name(m_hierarchy.upstream + "/command" + m_registry.nameOf(id));
+  name.appendSequenceNumber(++m_relaySeq);
+  auto interest = createInterest(name, true, false, ndn::time::milliseconds(config::RELAY_INTEREST_LIFETIME_MS));
+  const Ticks sentAt = nowTicks();
+  m_face.expressInterest(interest,
+      [this, id, sentAt](const ndn::Interest&, const ndn::Data& data) {
+        ScopedLatency latency(m_callbackLatency);
+        const Ticks arrival = nowTicks();
+        relayCommands(id);
+        m_verifier.verify(data, id,
+            [this, id, data, sentAt, arrival] { acceptRelayedCommands(id, data, sentAt, arrival); },
+            [this, id](const std::string& reason) {
+              log(LogLevel::ERROR, "Lote da cidade para " + m_registry.nameOf(id) + " rejeitado (" + reason + ").");
+            });
+      },
+      [this, id](const ndn::Interest&, const ndn::lp::Nack&) {
+        m_scheduler.schedule(ndn::time::milliseconds(config::RELAY_RETRY_MS), [this, id] { relayCommands(id); });
+      },
+      [this, id](const ndn::Interest&) { relayCommands(id); });
+}
+
+void Orchestrator::acceptRelayedCommands(LightId id, const ndn::Data& data, Ticks sentAt, Ticks arrival) {
+  const auto& content = data.getContent();
+  if (content.value_size() == 0) {
+    return;
+  }
+  auto batch = command::decode(std::span<const uint8_t>(content.value(), content.value_size()));
+  if (!batch) {
+    log(LogLevel::ERROR, "Lote da cidade malformado: " + data.getName().toUri());
+    return;
+  }
+  if (batch->sentAt != 0) {
+    m_upstreamClock.addSample(sentAt, batch->receivedAt, batch->sentAt, arrival);
+  }
+  if (batch->empty()) {
+    return;
+  }
+  // Os prazos absolutos vêm no relógio da cidade; o semáforo os recebe no nosso.
+  for (size_t i = 0; i < batch->count; ++i) {
+    Command& command = batch->items[i];
+    if (command.op == CommandOp::SET_PHASE_END) {
+      command.value = m_upstreamClock.toLocal(command.value, arrival);
+    }
+  }
+  for (size_t i = 0; i < batch->plan.count; ++i) {
+    auto& entry = batch->plan.entries[i];
+    entry.end = m_upstreamClock.toLocal(entry.end, arrival);
+  }
+  log(LogLevel::DEBUG, "Lote da cidade para " + m_registry.nameOf(id) + ": " + command::toString(*batch));
+  if (!m_relayedCommands.push({id, *batch})) {
+    m_ingestDrops++;
+    return;
+  }
+  if (m_options.engine == EngineMode::EVENT) {
+    requestEvaluation();
+  }
+}
+
 void Orchestrator::onRegisterFailed(const ndn::Name& nome, const std::string& reason) {
   log(LogLevel::ERROR, "Falha ao registrar prefixo: " + nome.toUri() + " Motivo: " + reason);
 }
@@ -219,26 +947,518 @@ void Orchestrator::onRegisterFailed(const ndn::Name& nome, const std::string& re
 void Orchestrator::runConsumer() {
     m_scheduler.schedule(1000_ms, [this] {
     m_cycleCount++;
-    // ALTERAÇÃO: Iterando sobre o vetor
-    for (const auto& tl : trafficLights_) {
-      if (!tl.isUnknown()) {
-        Name interestName(tl.name);
-        auto interest = createInterest(interestName, true, false, 4000_ms); 
-        sendInterest(interest);
-      }
-      else {
-        if (m_cycleCount % 5 == 0) {
-            log(LogLevel::INFO, "Tentando contactar o nó falho: " + tl.name);
-            Name interestName(tl.name);
-            auto interest = createInterest(tl.name, true, false, 4000_ms);
-            sendInterest(interest);
-        }
+    const bool push = m_protocol.statusMode != StatusMode::POLL;
+    // Os semáforos são consultados pela roda de poll (pollTick); aqui ficam os
+    // agregados. Os resumos das regiões com orquestrador próprio são buscados
+    // também no modo push.
+    for (GroupId regionId = 0; regionId < static_cast<GroupId>(m_regions.size()); ++regionId) {
+      const auto& region = m_regions[regionId];
+      if ((!push || region.orchestrated) &&
+          (region.failures < config::AGGREGATE_FAILURE_THRESHOLD || m_cycleCount % 5 == 0)) {
+        fetchAggregate(regionId, region.fetchName, true);
       }
     }
+    if (m_cycleCount % config::STATUS_TRAFFIC_WINDOW_CYCLES == 0) {
+      reportStatusTraffic();
+    }
     runConsumer();
   });
 }
 
+// Visita os slots vencidos da roda de poll. Se a thread de I/O atrasou mais de um
+// slot, os atrasados são visitados de uma vez para a roda acompanhar o relógio.
+void Orchestrator::pollTick() {
+  const auto start = steadyNow();
+  m_pollLateness.record(static_cast<uint64_t>(std::max<int64_t>(0,
+      std::chrono::duration_cast<std::chrono::microseconds>(start - m_pollTickDue).count())));
+  const uint64_t sentBefore = m_statusTraffic.pollInterests;
+  const Ticks now = nowTicks();
+  do {
+    m_pollWheel.advance([this, now](LightId id) { visitLight(id, now); });
+    m_pollTickDue += std::chrono::milliseconds(config::POLL_SLOT_MS);
+  } while (m_pollTickDue <= start);
+  const uint64_t sent = m_statusTraffic.pollInterests - sentBefore;
+  m_pollSent += sent;
+  m_pollBurst.record(sent);
+
+  const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(m_pollTickDue - steadyNow());
+  m_pollTickEvent = m_scheduler.schedule(ndn::time::microseconds(std::max<int64_t>(0, delay.count())),
+                                         [this] { pollTick(); });
+}
+
+// Um semáforo na sua vez: consulta, confere o heartbeat ou só o reagenda.
+void Orchestrator::visitLight(LightId id, Ticks now) {
+  if (m_timingDue[id] <= now) {
+    m_timingDue[id] += config::PHASE_TIMING_FETCH_MS;
+    if (!m_relayed[id] && m_reachable[id]) {
+      fetchPhaseTiming(id);
+    }
+  }
+  int intervalMs = config::POLL_PERIOD_MS;
+  if (m_relayed[id]) {
+    // Estado chega no resumo do orquestrador regional; sem ele, o semáforo
+    // fica inalcançável até a região voltar a responder.
+    if (m_reachable[id] && !regionCovers(id)) {
+      markUnreachable(id, "orquestrador regional inalcançável");
+    }
+  }
+  else if (m_protocol.statusMode != StatusMode::POLL && m_reachable[id]) {
+    // No modo push o orquestrador só escuta; o silêncio além de alguns
+    // heartbeats equivale aos timeouts do modo poll.
+    if (m_hot.lastReport[id] < now - static_cast<Ticks>(m_protocol.heartbeatMs * config::HEARTBEAT_MISS_FACTOR)) {
+      log(LogLevel::ERROR, "Sem heartbeat de " + trafficLights_[id].name);
+      markUnreachable(id, "ausência de heartbeat");
+    }
+  }
+  else if (m_reachable[id] && regionCovers(id)) {
+    // Estado chega no agregado da região.
+  }
+  else if (m_reachable[id]) {
+    pollStatus(id, false);
+    intervalMs = pollIntervalMs(id, now);
+  }
+  else {
+    log(LogLevel::INFO, "Tentando contactar o nó falho: " + trafficLights_[id].name);
+    pollStatus(id, false);
+    intervalMs = config::POLL_RECONTACT_MS;
+  }
+  m_pollWheel.schedule(id, m_pollWheel.nextAligned(intervalMs / config::POLL_SLOT_MS, m_pollPhase[id]));
+}
+
+// Mais polls perto da troca de fase, quando o estado vai mudar, e menos no meio
+// de uma fase longa.
+int Orchestrator::pollIntervalMs(LightId id, Ticks now) const {
+  const Ticks remaining = m_pollEnd[id] - now;
+  if (remaining < config::POLL_NEAR_END_MS) {
+    return config::POLL_FAST_MS;
+  }
+  if (remaining > config::POLL_MID_PHASE_MS) {
+    return config::POLL_SLOW_MS;
+  }
+  return config::POLL_PERIOD_MS;
+}
+
+bool Orchestrator::regionCovers(LightId id) const {
+  GroupId regionId = m_lightRegion[id];
+  return regionId != NO_GROUP && m_regions[regionId].failures < config::AGGREGATE_FAILURE_THRESHOLD;
+}
+
+void Orchestrator::fetchAggregate(GroupId regionId, const ndn::Name& name, bool canBePrefix) {
+  // Sem o prefixo de versão, CanBePrefix traz o segmento 0 da versão mais recente;
+  // os demais segmentos são pedidos pelo nome exato.
+  auto& rtt = m_rtt[regionLink(regionId)];
+  auto interest = createInterest(name, true, canBePrefix, ndn::time::milliseconds(rtt.rtoMs()));
+  auto sentAt = steadyNow();
+  m_statusTraffic.pollInterests++;
+  m_face.expressInterest(interest,
+      [this, regionId, sentAt, &rtt](const ndn::Interest&, const ndn::Data& data) {
+        ScopedLatency latency(m_callbackLatency);
+        const int rttMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            steadyNow() - sentAt).count());
+        rtt.addSample(rttMs);
+        const int oneWayDelayMs = rttMs / 2;
+        m_verifier.verify(data, regionLink(regionId),
+            [this, regionId, data, oneWayDelayMs] { onAggregateData(regionId, data, oneWayDelayMs); },
+            [this, regionId](const std::string& reason) { onAggregateFailure(regionId, "validação: " + reason); });
+      },
+      [this, regionId](const ndn::Interest&, const ndn::lp::Nack& nack) {
+        std::stringstream ss;
+        ss << "Nack " << nack.getReason();
+        onAggregateFailure(regionId, ss.str());
+      },
+      [this, regionId, &rtt](const ndn::Interest&) {
+        rtt.backoff();
+        onAggregateFailure(regionId, "Timeout");
+      });
+}
+
+void Orchestrator::onAggregateData(GroupId regionId, const ndn::Data& data, int oneWayDelayMs) {
+  const auto& name = data.getName();
+  const auto& content = data.getContent();
+  m_statusTraffic.pollData++;
+  auto& region = m_regions[regionId];
+  const std::span<const uint8_t> wire(content.value(), content.value_size());
+  status::RegionSummary summary;
+  const bool decoded = region.orchestrated ? status::decodeRegionSummary(wire, summary, m_aggregateScratch)
+                                           : status::decodeAggregate(wire, m_aggregateScratch);
+  if (!decoded) {
+    log(LogLevel::ERROR, "Agregado malformado: " + name.toUri());
+    return;
+  }
+  if (region.failures >= config::AGGREGATE_FAILURE_THRESHOLD) {
+    log(LogLevel::INFO, std::string(region.orchestrated ? "Orquestrador regional" : "Agregador") + " de " +
+        region.prefix + " voltou a responder.");
+  }
+  region.failures = 0;
+  if (region.orchestrated) {
+    m_regionPriority[regionId].store(summary.averagePriority, std::memory_order_relaxed);
+  }
+
+  const Ticks now = nowTicks();
+  std::string lightName = region.prefix;
+  for (const auto& [suffix, report] : m_aggregateScratch) {
+    lightName.resize(region.prefix.size());
+    lightName.append(suffix);
+    LightId id = m_registry.find(lightName);
+    if (id == INVALID_LIGHT) {
+      continue;
+    }
+    if (report.phase == Color::UNKNOWN) {
+      markUnreachable(id, "falha reportada pelo agregador");
+      continue;
+    }
+    ingestStatus(id, report, oneWayDelayMs, now);
+  }
+  log(LogLevel::DEBUG, "Agregado de " + region.prefix + ": " + std::to_string(m_aggregateScratch.size()) + " semáforos.");
+
+  // Segmento 0 anuncia o último segmento; os demais são buscados pelo nome exato.
+  if (name.size() >= 2 && name.get(-1).isSegment() && name.get(-1).toSegment() == 0 && data.getFinalBlock()) {
+    const uint64_t lastSegment = data.getFinalBlock()->toSegment();
+    for (uint64_t segment = 1; segment <= lastSegment; ++segment) {
+      fetchAggregate(regionId, name.getPrefix(-1).appendSegment(segment), false);
+    }
+  }
+}
+
+void Orchestrator::onAggregateFailure(GroupId regionId, const std::string& reason) {
+  auto& region = m_regions[regionId];
+  if (region.failures < UINT8_MAX && ++region.failures == config::AGGREGATE_FAILURE_THRESHOLD) {
+    if (region.orchestrated) {
+      log(LogLevel::ERROR, "Orquestrador regional de " + region.prefix + " inalcançável (" + reason +
+          "); seus semáforos de fronteira ficam sem coordenação.");
+    } else {
+      log(LogLevel::ERROR, "Agregador de " + region.prefix + " inalcançável (" + reason +
+          "); voltando a consultar cada semáforo.");
+    }
+  }
+}
+
+void Orchestrator::reportStatusTraffic() {
+  // Compara os pacotes de estado da janela com o que o poll de 1 s custaria:
+  // um Interest e um Data por semáforo por segundo.
+  StatusTraffic window;
+  std::swap(window, m_statusTraffic);
+  m_statusTraffic.windowStart = steadyNow();
+  double seconds = std::chrono::duration<double>(steadyNow() - window.windowStart).count();
+  if (seconds <= 0.0) return;
+
+  const size_t lights = trafficLights_.size();
+  double pollEquivalent = 2.0 * lights;
+  double actual = (window.pollInterests + window.pollData + window.pushReports + window.pushAcks) / seconds;
+  double saved = pollEquivalent - actual;
+
+  std::ostringstream ss;
+  ss.setf(std::ios::fixed);
+  ss.precision(2);
+  ss << "Tráfego de estado: " << actual << " pkt/s (poll equivalente " << pollEquivalent
+     << " pkt/s, economia " << saved << " pkt/s)";
+  if (window.pollsDeferred > 0) {
+    ss << "; " << window.pollsDeferred << " polls adiados com " << config::STATUS_IN_FLIGHT
+       << " Interests já em voo, " << m_pending.total() << " pendentes agora";
+  }
+  log(LogLevel::INFO, ss.str());
+
+  std::ofstream outFile(m_trafficFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << seconds << "," << lights << "," << pollEquivalent << "," << actual << "," << saved << "\n";
+  }
+  reportValidation(seconds);
+  reportEngine(seconds);
+  reportCallbackLatency(seconds);
+  reportRtt(seconds);
+  reportPolling(seconds);
+  reportClockSync(seconds);
+  if (m_protocol.statusMode == StatusMode::PREDICT) {
+    reportPrediction(seconds);
+  }
+}
+
+void Orchestrator::reportClockSync(double windowSeconds) {
+  std::ofstream outFile(m_clockSyncFilename, std::ios_base::app);
+  if (!outFile.is_open()) {
+    return;
+  }
+  outFile.setf(std::ios::fixed);
+  outFile.precision(2);
+  for (LightId id = 0; id < m_lightClock.size(); ++id) {
+    auto& clock = m_lightClock[id];
+    if (!clock.fresh) {
+      continue;
+    }
+    outFile << windowSeconds << "," << trafficLights_[id].name << "," << clock.offsetMs << "," << clock.errorMs << "\n";
+    clock.fresh = false;
+  }
+}
+
+// O semáforo mede o atraso de cada troca de fase em relação ao prazo e serve o
+// histograma acumulado em /<semáforo>/timing. A consulta é rara e fica fora do
+// poll de estado: cada semáforo é consultado a cada PHASE_TIMING_FETCH_MS numa
+// visita da roda, com as vezes espalhadas pelo período, e uma falha só adia a
+// linha para a consulta seguinte.
+void Orchestrator::fetchPhaseTiming(LightId id) {
+  Name name(trafficLights_[id].name);
+  name.append(status::TIMING_COMPONENT);
+  m_face.expressInterest(createInterest(name, true, false, ndn::time::milliseconds(m_rtt[id].rtoMs())),
+      [this, id](const ndn::Interest&, const ndn::Data& data) {
+        m_verifier.verify(data, id,
+            [this, id, data] { onPhaseTiming(id, data); },
+            [this, id](const std::string& reason) {
+              log(LogLevel::ERROR, "Atraso de fases de " + trafficLights_[id].name + " rejeitado: " + reason);
+            });
+      },
+      [](const ndn::Interest&, const ndn::lp::Nack&) {},
+      [](const ndn::Interest&) {});
+}
+
+// Uma linha por resposta com as trocas desde a anterior: a diferença entre os
+// dois histogramas acumulados dá os percentis da janela.
+void Orchestrator::onPhaseTiming(LightId id, const ndn::Data& data) {
+  const auto& content = data.getContent();
+  auto report = status::decodeTiming(std::span<const uint8_t>(content.value(), content.value_size()));
+  if (!report) {
+    log(LogLevel::ERROR, "Atraso de fases malformado: " + data.getName().toUri());
+    return;
+  }
+  auto& last = m_lightTiming[id];
+  const auto now = steadyNow();
+  LatencyHistogram window;
+  for (size_t b = 0; b < status::TIMING_BUCKETS; ++b) {
+    // Contagens menores que as anteriores: o semáforo reiniciou.
+    const uint32_t previous = report->buckets[b] >= last.report.buckets[b] ? last.report.buckets[b] : 0;
+    const uint64_t bucketMax = b + 1 < status::TIMING_BUCKETS ? (uint64_t{1} << b) - 1 : report->maxLatenessUs;
+    window.addBucket(b, report->buckets[b] - previous, std::min(bucketMax, report->maxLatenessUs));
+  }
+  const double seconds = std::chrono::duration<double>(now - last.at).count();
+  last = LightTiming{*report, now};
+
+  std::ofstream outFile(m_phaseTimingFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << seconds << "," << trafficLights_[id].name << "," << window.count() << ","
+            << window.percentile(0.5) << "," << window.percentile(0.99) << "," << window.max() << ","
+            << (report->realTime ? 1 : 0) << "\n";
+  }
+}
+
+void Orchestrator::reportPrediction(double windowSeconds) {
+  const uint64_t reports = m_predictionStats.reports.exchange(0, std::memory_order_relaxed);
+  const uint64_t mismatches = m_predictionStats.phaseMismatches.exchange(0, std::memory_order_relaxed);
+  const uint64_t errorSum = m_predictionStats.errorSumMs.exchange(0, std::memory_order_relaxed);
+  const uint64_t errorMax = m_predictionStats.errorMaxMs.exchange(0, std::memory_order_relaxed);
+  const uint64_t matched = reports - mismatches;
+  const double avgError = matched ? static_cast<double>(errorSum) / matched : 0.0;
+
+  std::ostringstream ss;
+  ss.setf(std::ios::fixed);
+  ss.precision(1);
+  ss << "Previsão de fases: " << reports << " notificações, " << mismatches << " com outra fase, erro médio "
+     << avgError << " ms, máx " << errorMax << " ms";
+  log(LogLevel::INFO, ss.str());
+
+  std::ofstream outFile(m_predictionFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << windowSeconds << "," << reports << "," << mismatches << "," << avgError << "," << errorMax << "\n";
+  }
+}
+
+// Espalhamento do poll na janela: Interests de estado por visita à roda (a
+// rajada) e o atraso de cada visita em relação ao slot, que mede o jitter da
+// thread de I/O.
+void Orchestrator::reportPolling(double windowSeconds) {
+  std::ostringstream ss;
+  ss << "Poll: " << m_pollSent << " Interests em " << m_pollBurst.count() << " visitas; rajada máx "
+     << m_pollBurst.max() << ", atraso p99 " << m_pollLateness.percentile(0.99) << " us";
+  log(LogLevel::DEBUG, ss.str());
+
+  std::ofstream outFile(m_pollingFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << windowSeconds << "," << m_pollSent << "," << m_pollBurst.count() << "," << m_pollBurst.max() << ","
+            << m_pollBurst.percentile(0.99) << "," << m_pollLateness.percentile(0.5) << ","
+            << m_pollLateness.percentile(0.99) << "," << m_pollLateness.max() << "\n";
+  }
+  m_pollSent = 0;
+  m_pollBurst.reset();
+  m_pollLateness.reset();
+}
+
+void Orchestrator::reportEngine(double windowSeconds) {
+  const uint64_t evaluations = m_engineStats.evaluations.exchange(0, std::memory_order_relaxed);
+  const uint64_t changedLights = m_engineStats.changedLights.exchange(0, std::memory_order_relaxed);
+  const uint64_t groupsEvaluated = m_engineStats.groupsEvaluated.exchange(0, std::memory_order_relaxed);
+  const uint64_t maxGroups = m_engineStats.maxGroups.exchange(0, std::memory_order_relaxed);
+  const size_t totalGroups = intersections_.size() + greenWaves_.size() + syncGroups_.size();
+  const double perEvaluation = evaluations ? static_cast<double>(groupsEvaluated) / evaluations : 0.0;
+  const uint64_t steals = m_pool ? m_pool->takeSteals() : 0;
+
+  std::ostringstream ss;
+  ss.setf(std::ios::fixed);
+  ss.precision(2);
+  ss << "Motor de regras: " << evaluations << " avaliações, " << changedLights
+     << " semáforos alterados, " << perEvaluation << " de " << totalGroups << " grupos por avaliação";
+  if (m_pool) {
+    ss << "; " << m_shards.size() << " shards, " << steals << " roubados entre workers";
+  }
+  log(LogLevel::INFO, ss.str());
+
+  std::ofstream outFile(m_engineFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << windowSeconds << "," << evaluations << "," << changedLights << ","
+            << groupsEvaluated << "," << perEvaluation << "," << maxGroups << "," << totalGroups << ","
+            << m_shards.size() << "," << steals << "\n";
+  }
+}
+
+void Orchestrator::reportCallbackLatency(double windowSeconds) {
+  // Tempo gasto dentro dos callbacks da Face; com a thread de I/O livre de locks
+  // ele não depende mais da duração da passagem do motor.
+  const auto& h = m_callbackLatency;
+  std::ostringstream ss;
+  ss << "Callbacks de I/O: " << h.count() << " na janela; p50 " << h.percentile(0.5) << " us, p99 "
+     << h.percentile(0.99) << " us, máx " << h.max() << " us";
+  if (m_ingestDrops > 0) {
+    ss << "; " << m_ingestDrops << " estados descartados com a fila do motor cheia";
+  }
+  log(m_ingestDrops > 0 ? LogLevel::ERROR : LogLevel::INFO, ss.str());
+
+  std::ofstream outFile(m_latencyFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << windowSeconds << "," << h.count() << "," << h.percentile(0.5) << "," << h.percentile(0.9) << ","
+            << h.percentile(0.99) << "," << h.max() << "," << m_ingestDrops << "\n";
+  }
+  m_callbackLatency.reset();
+  m_ingestDrops = 0;
+}
+
+// Uma linha por enlace com amostras novas na janela; os percentis são das
+// últimas RttEstimator::WINDOW amostras do enlace.
+void Orchestrator::reportRtt(double windowSeconds) {
+  std::ofstream outFile(m_rttFilename, std::ios_base::app);
+  if (!outFile.is_open()) {
+    return;
+  }
+  outFile.setf(std::ios::fixed);
+  outFile.precision(2);
+  for (size_t link = 0; link < m_rtt.size(); ++link) {
+    const auto& rtt = m_rtt[link];
+    if (rtt.sampleCount() == m_rttReported[link]) {
+      continue;
+    }
+    const std::string& name = link < trafficLights_.size() ? trafficLights_[link].name
+                                                           : m_regions[link - trafficLights_.size()].prefix;
+    outFile << windowSeconds << "," << name << "," << rtt.sampleCount() - m_rttReported[link] << ","
+            << rtt.srttMs() << "," << rtt.rttvarMs() << "," << rtt.rtoMs() << "," << rtt.percentile(0.5) << ","
+            << rtt.percentile(0.9) << "," << rtt.percentile(0.99) << "," << rtt.max() << "\n";
+    m_rttReported[link] = rtt.sampleCount();
+  }
+}
+
+void Orchestrator::reportValidation(double windowSeconds) {
+  const auto stats = m_verifier.takeStats();
+  const uint64_t total = stats.verified + stats.memoHits + stats.failures;
+  const double avgLatencyUs = total ? static_cast<double>(stats.totalLatencyUs) / total : 0.0;
+  const double perSecond = total / windowSeconds;
+
+  std::ostringstream ss;
+  ss.setf(std::ios::fixed);
+  ss.precision(1);
+  ss << "Validação: " << stats.verified << " verificados, " << stats.memoHits << " em cache, "
+     << stats.failures << " rejeitados; latência média " << avgLatencyUs << " us, máx "
+     << stats.maxLatencyUs << " us";
+  log(stats.failures ? LogLevel::ERROR : LogLevel::INFO, ss.str());
+
+  std::ofstream outFile(m_validationFilename, std::ios_base::app);
+  if (outFile.is_open()) {
+    outFile.setf(std::ios::fixed);
+    outFile.precision(2);
+    outFile << windowSeconds << "," << stats.verified << "," << stats.memoHits << "," << stats.failures << ","
+            << avgLatencyUs << "," << stats.maxLatencyUs << "," << perSecond << "\n";
+  }
+}
+
+void Orchestrator::prefetchCertificates() {
+  // No modo asymmetric, o certificado de cada semáforo é buscado em
+  // /<semáforo>/KEY antes do primeiro ciclo e vai para o cache de não
+  // verificados do Validator, que o usa sem buscar pela rede e ainda o valida
+  // até a âncora no primeiro pacote. Em seguida, com ou sem certificado, o
+  // semáforo recebe um Interest de estado, que dá a primeira amostra de RTT do
+  // enlace, usada no modo push.
+  const bool asymmetric = m_protocol.signing == SigningMode::ASYMMETRIC;
+  if (asymmetric) {
+    log(LogLevel::INFO, "Pré-carregando certificados de " + std::to_string(trafficLights_.size()) + " semáforos.");
+  }
+  for (LightId id = 0; id < trafficLights_.size(); ++id) {
+    if (m_relayed[id]) {
+      continue;
+    }
+    if (!asymmetric) {
+      pollStatus(id, false);
+      continue;
+    }
+    Name name(trafficLights_[id].name);
+    name.append(status::CERT_COMPONENT);
+    m_face.expressInterest(createInterest(name, false, false, ndn::time::milliseconds(config::CERT_FETCH_LIFETIME_MS)),
+        [this, id](const ndn::Interest&, const ndn::Data& data) {
+          cacheCertificate(id, data);
+          pollStatus(id, false);
+        },
+        [this, id](const ndn::Interest&, const ndn::lp::Nack&) {
+          log(LogLevel::ERROR, "Certificado de " + trafficLights_[id].name + " indisponível (Nack).");
+          pollStatus(id, false);
+        },
+        [this, id](const ndn::Interest&) {
+          log(LogLevel::ERROR, "Certificado de " + trafficLights_[id].name + " indisponível (timeout).");
+          pollStatus(id, false);
+        });
+  }
+}
+
+void Orchestrator::cacheCertificate(LightId id, const ndn::Data& data) {
+  try {
+    ndn::security::Certificate cert(data.getContent().blockFromValue());
+    log(LogLevel::DEBUG, "Certificado de " + trafficLights_[id].name + ": " + cert.getName().toUri());
+    m_validator.cacheUnverifiedCert(std::move(cert));
+  } catch (const std::exception& e) {
+    log(LogLevel::ERROR, "Certificado malformado de " + trafficLights_[id].name + ": " + e.what());
+  }
+}
+
+// Interest de estado com lifetime igual ao RTO do enlace: uma perda é notada em
+// centenas de ms e retransmitida uma vez, com o RTO dobrado, antes de contar.
+void Orchestrator::pollStatus(LightId id, bool retransmission) {
+  Name interestName(trafficLights_[id].name);
+  if (m_protocol.textStatus) {
+    interestName.append(status::TEXT_COMPONENT);
+  }
+  expressStatus(id, createInterest(interestName, true, false, ndn::time::milliseconds(m_rtt[id].rtoMs())), retransmission);
+}
+
+// Cada envio ocupa uma entrada de m_pending com um nonce próprio; os callbacks já
+// sabem o LightId e o nonce, sem montar nem procurar nomes.
+void Orchestrator::expressStatus(LightId id, ndn::Interest interest, bool retransmission) {
+  const uint32_t nonce = m_nextNonce++;
+  if (!m_pending.insert(id, nonce, steadyNow(), retransmission)) {
+    m_statusTraffic.pollsDeferred++;
+    return;
+  }
+  interest.setNonce(nonce);
+  m_statusTraffic.pollInterests++;
+  m_face.expressInterest(interest,
+      [this, id, nonce](const ndn::Interest&, const ndn::Data& data) { onStatusData(id, nonce, data); },
+      [this, id, nonce](const ndn::Interest& sent, const ndn::lp::Nack& nack) { onStatusNack(id, nonce, sent, nack); },
+      [this, id, nonce](const ndn::Interest& sent) { onStatusTimeout(id, nonce, sent); });
+}
+
 ndn::Interest Orchestrator::createInterest(const ndn::Name& name, bool mustBeFresh, bool canBePrefix, ndn::time::milliseconds lifetime) {
   ndn::Interest interest(name);
   interest.setMustBeFresh(mustBeFresh);
@@ -247,212 +1467,345 @@ ndn::Interest Orchestrator::createInterest(const ndn::Name& name, bool mustBeFre
   return interest;
 }
 
+// Interface ProConInterface: Interests de estado de nome arbitrário. O caminho
+// normal é pollStatus(), que já conhece o LightId.
 void Orchestrator::sendInterest(const ndn::Interest& interest) {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    interestTimestamps_[interest.getName().toUri()] = std::chrono::steady_clock::now();
+  LightId id = lightIdFor(interest.getName());
+  if (id != INVALID_LIGHT) {
+    expressStatus(id, interest, false);
   }
-  m_face.expressInterest(interest,
-                        std::bind(&Orchestrator::onData, this, _1, _2),
-                        std::bind(&Orchestrator::onNack, this, _1, _2),
-                        std::bind(&Orchestrator::onTimeout, this, _1));
 }
 
+namespace {
+
+// O nonce como foi posto em expressStatus(). Interest::Nonce(uint32_t) guarda os
+// bytes em big-endian, então o valor é remontado nessa ordem, e não copiado.
+uint32_t nonceOf(const ndn::Interest& interest) {
+  const ndn::Interest::Nonce nonce = interest.getNonce();
+  return (uint32_t{nonce[0]} << 24) | (uint32_t{nonce[1]} << 16) | (uint32_t{nonce[2]} << 8) | uint32_t{nonce[3]};
+}
+
+// Fim da fase no relógio do orquestrador. Um semáforo sincronizado o manda
+// absoluto, e ele vale mesmo numa resposta que saiu do cache do semáforo ou do
+// Content Store; sem sincronia, o tempo restante conta do envio, estimado pela
+// chegada menos a ida.
+Ticks phaseEndOf(const status::StatusReport& report, int oneWayDelayMs, Ticks arrival) {
+  if (report.phaseEnd != 0) {
+    return report.phaseEnd;
+  }
+  return arrival + std::max<Ticks>(static_cast<Ticks>(report.remainingMs) - oneWayDelayMs, 0);
+}
+
+} // namespace
+
 void Orchestrator::onData(const ndn::Interest& interest, const ndn::Data& data) {
-  using namespace std::chrono;
-  std::lock_guard<std::mutex> lock(mutex_);
+  LightId id = lightIdFor(interest.getName());
+  if (id != INVALID_LIGHT) {
+    onStatusData(id, nonceOf(interest), data);
+  }
+}
+
+void Orchestrator::onStatusData(LightId id, uint32_t nonce, const ndn::Data& data) {
+  ScopedLatency latency(m_callbackLatency);
+  const Ticks arrival = nowTicks();
+  m_statusTraffic.pollData++;
 
-  std::string trafficLightName = interest.getName().toUri();
-  // ALTERAÇÃO: Usando a função auxiliar
-  auto* tl_ptr = findTrafficLight(trafficLightName);
-  if (!tl_ptr) {
+  if (logs(LogLevel::DEBUG)) {
+    log(LogLevel::DEBUG, "Recebeu Data de: " + data.getName().toUri());
+  }
+  const auto sent = m_pending.take(id, nonce);
+  if (!sent) {
+    log(LogLevel::ERROR, "Data sem Interest pendente: " + data.getName().toUri());
     return;
   }
-  auto& tl = *tl_ptr;
-  
-  if (tl.state == "UNKNOWN") {
-    log(LogLevel::INFO, "Semáforo " + trafficLightName + " voltou a comunicar.");
-    const auto* intersection = findIntersectionFor(trafficLightName);
-    if (intersection && intersection->isCompromised) {
-        bool allLightsOk = true;
-        for (const auto& peerLightName : intersection->trafficLightNames) {
-            // ALTERAÇÃO: busca no vetor
-            if (const auto* peer_tl = findTrafficLight(peerLightName)) {
-                if (peer_tl->state == "UNKNOWN" && peerLightName != trafficLightName) {
-                    allLightsOk = false;
-                    break;
-                }
-            }
-        }
-        if (allLightsOk) {
-              intersections_.at(intersection->name).isCompromised = false;
-              intersections_.at(intersection->name).needsNormalization = true;
-              log(LogLevel::INFO, "Cruzamento " + intersection->name + " operacional. Iniciando fase de normalização.");
-        }
-    }
+  int oneWayDelayMs = recordRTT(id, *sent);
+
+  // O RTT e o instante de chegada são medidos antes da validação, que pode
+  // esperar pela busca de um certificado.
+  m_verifier.verify(data, id,
+      [this, id, data, oneWayDelayMs, arrival] { acceptStatusData(id, data, oneWayDelayMs, arrival); },
+      [this, name = data.getName()](const std::string& reason) {
+        log(LogLevel::ERROR, "Data rejeitado (" + reason + "): " + name.toUri());
+      });
+}
+
+void Orchestrator::acceptStatusData(LightId id, const ndn::Data& data, int oneWayDelayMs, Ticks arrival) {
+  const auto& content = data.getContent();
+  std::span<const uint8_t> wire(content.value(), content.value_size());
+  std::optional<status::StatusReport> report;
+  if (status::isBinary(wire)) {
+    report = status::decode(wire);
+  } else {
+    report = status::decodeText(std::string_view(reinterpret_cast<const char*>(wire.data()), wire.size()));
   }
 
-  std::string content(reinterpret_cast<const char*>(data.getContent().value()), data.getContent().value_size());
-  std::string nameStr = interest.getName().toUri();
-  log(LogLevel::DEBUG, "Recebeu Data de: " + data.getName().toUri());
-  auto it = interestTimestamps_.find(nameStr);
-  if (it == interestTimestamps_.end()) {
-    log(LogLevel::ERROR, "Interest timestamp not found:  " + nameStr);
+  if (!report) {
+    log(LogLevel::ERROR, "Invalid message format:  " + data.getName().toUri());
     return;
   }
 
-  steady_clock::time_point now = steady_clock::now();
-  auto delimiter = '|';
-  std::istringstream iss(content);
-  std::string token;
-  std::vector<std::string> tokens;
-  while (std::getline(iss, token, delimiter)) {
-    tokens.push_back(token);
+  ingestStatus(id, *report, oneWayDelayMs, arrival);
+}
+
+// Thread de I/O: registra o que ela mesma usa e repassa o estado ao motor.
+void Orchestrator::ingestStatus(LightId id, const status::StatusReport& report, int oneWayDelayMs, Ticks arrival) {
+  m_hot.statusSeq[id] = report.sequence;
+  m_hot.lastReport[id] = arrival;
+  m_pollEnd[id] = phaseEndOf(report, oneWayDelayMs, arrival);
+  if (report.clockErrorMs != status::CLOCK_UNSYNCED) {
+    m_lightClock[id] = LightClock{report.clockOffsetMs, report.clockErrorMs, true};
   }
+  m_hot.timeoutCounter[id] = 0;
+  m_reachable.set(id);
+
+  IngestEvent event;
+  event.id = id;
+  event.report = report;
+  event.oneWayDelayMs = oneWayDelayMs;
+  event.arrival = arrival;
+  enqueueIngest(event);
+}
 
-  if (tokens.size() < 3) {
-    log(LogLevel::ERROR, "Invalid message format:  " + content);
-    return;
+// Semáforo sem amostras próprias (servido por um agregador ou um orquestrador
+// regional) usa a estimativa do enlace da região.
+const RttEstimator& Orchestrator::rttFor(LightId id) const {
+  const GroupId regionId = m_lightRegion[id];
+  if (m_rtt[id].hasSamples() || regionId == NO_GROUP) {
+    return m_rtt[id];
   }
+  return m_rtt[regionLink(regionId)];
+}
 
-  std::string state = tokens[0];
-  int remainingMs = std::stoi(tokens[1]);
+bool Orchestrator::enqueueIngest(const IngestEvent& event) {
+  if (!m_ingest.push(event)) {
+    // O próximo estado do mesmo semáforo repõe o que se perdeu aqui.
+    m_ingestDrops++;
+    return false;
+  }
+  if (m_options.engine == EngineMode::EVENT) {
+    requestEvaluation();
+  }
+  return true;
+}
 
-  int correctedRemainingMs = remainingMs - recordRTT(data.getName().toUri());
-  interestTimestamps_.erase(it);
-  if (correctedRemainingMs < 0)
-    correctedRemainingMs = 0;
+// Motor: aplica tudo o que a thread de I/O recebeu desde a última passagem.
+void Orchestrator::drainIngest() {
+  IngestEvent event;
+  while (m_ingest.pop(event)) {
+    if (event.reachable) {
+      applyStatus(event.id, event);
+    } else {
+      applyUnreachable(event.id, event.reason);
+    }
+  }
+  // Lotes da cidade entram no lote da passagem e são entregues com ele.
+  RelayedCommand relayed;
+  while (m_relayedCommands.pop(relayed)) {
+    auto& batch = commandFor(relayed.id);
+    for (const Command& command : relayed.batch) {
+      batch.push(command.op, command.value);
+    }
+    if (!relayed.batch.plan.empty()) {
+      batch.plan = relayed.batch.plan;
+      m_plans[relayed.id] = relayed.batch.plan;
+    }
+  }
+}
+
+void Orchestrator::applyStatus(LightId id, const IngestEvent& event) {
+  const auto& report = event.report;
+  const Ticks now = event.arrival;
+  if (m_hot.color[id] == Color::UNKNOWN) {
+    log(LogLevel::INFO, "Semáforo " + m_registry.nameOf(id) + " voltou a comunicar.");
+    GroupId interId = m_registry.intersectionOf(id);
+    if (interId != NO_GROUP && intersections_[interId].isCompromised) {
+        bool allLightsOk = true;
+        for (LightId peerId : m_registry.intersectionMembers(interId)) {
+            if (peerId != INVALID_LIGHT && peerId != id && m_hot.color[peerId] == Color::UNKNOWN) {
+                allLightsOk = false;
+                break;
+            }
+        }
+        if (allLightsOk) {
+              auto& intersection = intersections_[interId];
+              intersection.isCompromised = false;
+              intersection.needsNormalization = true;
+              log(LogLevel::INFO, "Cruzamento " + intersection.name + " operacional. Iniciando fase de normalização.");
+        }
+    }
+  }
 
-  tl.state = state;
-  tl.endTime = now + milliseconds(correctedRemainingMs);
-  tl.priority = std::stof(tokens[2]);
-  tl.timeOutCounter = 0;
+  const Ticks endTime = phaseEndOf(report, event.oneWayDelayMs, now);
+  if (m_protocol.statusMode == StatusMode::PREDICT && phase::cycles(m_hot.color[id])) {
+    // Erro da previsão no instante da notificação, antes de reancorar o modelo.
+    Color predicted = m_hot.color[id];
+    Ticks predictedEnd = m_hot.endTime[id];
+    phase::advance(predicted, predictedEnd, now, m_phaseDurations[id], m_plans[id]);
+    m_predictionStats.reports.fetch_add(1, std::memory_order_relaxed);
+    if (predicted != report.phase) {
+      m_predictionStats.phaseMismatches.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      const uint64_t error = static_cast<uint64_t>(std::abs(predictedEnd - endTime));
+      m_predictionStats.errorSumMs.fetch_add(error, std::memory_order_relaxed);
+      if (error > m_predictionStats.errorMaxMs.load(std::memory_order_relaxed)) {
+        m_predictionStats.errorMaxMs.store(error, std::memory_order_relaxed);
+      }
+    }
+  }
+  const bool changed = m_hot.color[id] != report.phase || m_hot.priority[id] != report.priority ||
+                       std::abs(endTime - m_hot.endTime[id]) > config::END_TIME_TOLERANCE_MS;
+
+  m_hot.color[id] = report.phase;
+  m_hot.endTime[id] = endTime;
+  m_hot.setPriority(id, report.priority);
+  m_hot.queueLength[id] = report.queueLength;
+  if (changed) {
+    noteChange(id);
+  }
 }
 
 void Orchestrator::onNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+    LightId id = lightIdFor(interest.getName());
+    if (id != INVALID_LIGHT) {
+        onStatusNack(id, nonceOf(interest), interest, nack);
+    }
+}
+
+void Orchestrator::onStatusNack(LightId id, uint32_t nonce, const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+    ScopedLatency latency(m_callbackLatency);
+    m_pending.take(id, nonce);
     std::stringstream ss;
     ss << "Nack recebido para " << interest.getName().toUri() << ". Motivo: " << nack.getReason();
     log(LogLevel::ERROR, ss.str());
-
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::string failedLightName = interest.getName().toUri();
-
-    // ALTERAÇÃO: busca e modificação no vetor
-    if (auto* tl = findTrafficLight(failedLightName)) {
-        tl->state = "UNKNOWN"; 
-        const auto* intersection = findIntersectionFor(failedLightName);
-        if (intersection) {
-            intersections_.at(intersection->name).isCompromised = true;
-            log(LogLevel::ERROR, "Cruzamento " + intersection->name 
-                      + " comprometido devido a Nack em " + failedLightName);
-        }
-    }
+    markUnreachable(id, "Nack");
 }
 
 
 void Orchestrator::onTimeout(const ndn::Interest& interest) {
+    LightId id = lightIdFor(interest.getName());
+    if (id != INVALID_LIGHT) {
+        onStatusTimeout(id, nonceOf(interest), interest);
+    }
+}
+
+void Orchestrator::onStatusTimeout(LightId id, uint32_t nonce, const ndn::Interest& interest) {
+    ScopedLatency latency(m_callbackLatency);
+    m_pending.take(id, nonce);
     log(LogLevel::ERROR, "Timeout no Interest para: " + interest.getName().toUri());
-    std::lock_guard<std::mutex> lock(mutex_); 
-
-    std::string failedLightName = interest.getName().toUri();
-
-    // ALTERAÇÃO: busca e modificação no vetor
-    if (auto* tl = findTrafficLight(failedLightName)) {
-        tl->timeOutCounter++;
-        if (tl->timeOutCounter >= 2) {
-            tl->state = "UNKNOWN";
-            const auto* intersection = findIntersectionFor(failedLightName);
-            if (intersection) {
-                intersections_.at(intersection->name).isCompromised = true;
-                log(LogLevel::ERROR, "Cruzamento " + intersection->name 
-                          + " comprometido devido a Timeouts em " + failedLightName);
-            }
-        }
+
+    m_rtt[id].backoff();
+    auto& timeouts = m_hot.timeoutCounter[id];
+    if (timeouts < UINT8_MAX) timeouts++;
+    if (timeouts >= 2) {
+        markUnreachable(id, "Timeouts");
+    } else if (m_reachable[id]) {
+        pollStatus(id, true);
     }
 }
 
+LightId Orchestrator::lightIdFor(const ndn::Name& interestName) const {
+    const auto& last = interestName.get(-1);
+    if (last.toUri() == status::TEXT_COMPONENT) {
+        return m_registry.find(interestName.getPrefix(-1).toUri());
+    }
+    return m_registry.find(interestName.toUri());
+}
+
+// Thread de I/O. Se a fila do motor estiver cheia, o semáforo continua alcançável
+// e o próximo timeout tenta de novo.
+void Orchestrator::markUnreachable(LightId id, const char* reason) {
+    if (!m_reachable[id]) {
+        return;
+    }
+    m_reachable.reset(id);
+    IngestEvent event;
+    event.id = id;
+    event.reachable = false;
+    event.reason = reason;
+    if (!enqueueIngest(event)) {
+        m_reachable.set(id);
+    }
+}
 
-int Orchestrator::recordRTT(const std::string& interestName) {
-    auto now = std::chrono::steady_clock::now();
-    auto it = interestTimestamps_.find(interestName);
-    if (it == interestTimestamps_.end()) {
-        log(LogLevel::ERROR, "Timestamp do Interest não encontrado para calcular RTT: " + interestName);
-        return 0; 
+void Orchestrator::applyUnreachable(LightId id, const char* reason) {
+    if (m_hot.color[id] != Color::UNKNOWN) {
+        noteChange(id);
     }
+    m_hot.color[id] = Color::UNKNOWN;
+    GroupId interId = m_registry.intersectionOf(id);
+    if (interId != NO_GROUP) {
+        intersections_[interId].isCompromised = true;
+        log(LogLevel::ERROR, "Cruzamento " + intersections_[interId].name
+                  + " comprometido devido a " + std::string(reason) + " em " + m_registry.nameOf(id));
+    }
+}
 
-    int rttMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second).count();
+
+int Orchestrator::recordRTT(LightId id, const PendingTable::Entry& sent) {
+    auto now = steadyNow();
+    int rttMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - sent.sentAt).count();
     
     appendToMetricsFile(rttMs);
 
-    rttHistory_.push_back(rttMs);
-    if (rttHistory_.size() > config::RTT_WINDOW_SIZE) {
-        rttHistory_.erase(rttHistory_.begin());
+    // Algoritmo de Karn: a resposta a um Interest retransmitido não entra no estimador.
+    if (!sent.retransmission) {
+        m_rtt[id].addSample(rttMs);
     }
     return rttMs / 2;
 }
 
+void Orchestrator::processIntersection(GroupId interId, Ticks now) {
+    auto& intersectionRef = intersections_[interId];
+    // Cruzamento de uma região com orquestrador próprio: a cidade só lê o estado.
+    const auto& members = m_registry.intersectionMembers(interId);
+    if (!members.empty() && members.front() != INVALID_LIGHT && m_relayed[members.front()]) {
+        return;
+    }
+    updatePriorityList(interId);
 
-const Intersection* Orchestrator::findIntersectionFor(const std::string& lightName) const {
-    for (const auto& [intersectionName, intersection] : intersections_) {
-        if (intersection.contains(lightName)) {
-            return &intersection;
+    LightId activeId = INVALID_LIGHT;
+    for (LightId id : m_registry.intersectionMembers(interId)) {
+        if (id != INVALID_LIGHT && m_hot.isActive(id)) {
+            activeId = id;
+            break;
         }
     }
-    return nullptr;
-}
-
-int Orchestrator::getAverageRTT() const {
-    if (rttHistory_.empty()) return 0;
-    int total = std::accumulate(rttHistory_.begin(), rttHistory_.end(), 0);
-    return total / static_cast<int>(rttHistory_.size());
-}
-
-void Orchestrator::processIntersections(const int& allRedTimeoutCycles) {
-    for (auto& [interName, intersectionRef] : intersections_) {
-        updatePriorityList(interName);
-        bool isIntersectionActive = false;
+    m_activeLightPerIntersection[interId] = activeId;
 
-        for (const auto& lightName : intersectionRef.trafficLightNames) {
-            // ALTERAÇÃO: busca no vetor
-            if (auto* light = findTrafficLight(lightName)) {
-                if (light->command.empty()){
-                  generateIntersectionCommand(intersectionRef, lightName);
-                }
-
-                if (light->state == "GREEN" || light->state == "YELLOW") {
-                    isIntersectionActive = true;
-                }
-            }
+    for (LightId id : m_registry.intersectionMembers(interId)) {
+        if (id != INVALID_LIGHT && !hasPendingCommand(id)) {
+            generateIntersectionCommand(interId, id, now);
         }
+    }
 
-        if (!isIntersectionActive) {
-            m_allRedCounter[interName]++;
-            if (m_allRedCounter[interName] >= allRedTimeoutCycles) {
-                forceCycleStart(interName);
-                m_allRedCounter[interName] = 0;
-            }
-        } else {
-            m_allRedCounter[interName] = 0;
-        }
-        
-        if (intersectionRef.needsNormalization) {
-            intersectionRef.needsNormalization = false;
-            log(LogLevel::DEBUG, "Fase de normalização concluída para " + interName + ". Retomando ciclo normal.");
+    // Todo em vermelho por ALL_RED_TIMEOUT_MS: força o início de um ciclo e, se
+    // ainda assim nada abrir, tenta de novo após o mesmo prazo.
+    auto& allRedSince = m_allRedSince[interId];
+    if (activeId != INVALID_LIGHT) {
+        allRedSince = 0;
+    } else if (allRedSince == 0 || now - allRedSince >= config::ALL_RED_TIMEOUT_MS) {
+        if (allRedSince != 0) {
+            forceCycleStart(interId, now);
         }
+        allRedSince = now;
+        scheduleDeadline(DeadlineQueue::Kind::ALL_RED_TIMEOUT, static_cast<uint32_t>(interId),
+                         now + config::ALL_RED_TIMEOUT_MS);
+    }
+
+    if (intersectionRef.needsNormalization) {
+        intersectionRef.needsNormalization = false;
+        log(LogLevel::DEBUG, "Fase de normalização concluída para " + intersectionRef.name + ". Retomando ciclo normal.");
     }
 }
 
 
-void Orchestrator::updatePriorityList(const std::string& intersectionName) {
-    auto it = intersections_.find(intersectionName);
-    if (it == intersections_.end()) return;
-    auto& list = sortedPriorityCache_[intersectionName];
+void Orchestrator::updatePriorityList(GroupId intersectionId) {
+    auto& list = sortedPriorityCache_[intersectionId];
     list.clear();
 
-    for (const auto& name : it->second.trafficLightNames) {
-        // ALTERAÇÃO: busca no vetor
-        if (const auto* tl = findTrafficLight(name)) {
-            list.emplace_back(name, tl->priority);
+    for (LightId id : m_registry.intersectionMembers(intersectionId)) {
+        if (id != INVALID_LIGHT) {
+            list.emplace_back(id, m_hot.priority[id]);
         }
     }
     std::sort(list.begin(), list.end(), [](const auto& a, const auto& b) {
@@ -461,304 +1814,307 @@ void Orchestrator::updatePriorityList(const std::string& intersectionName) {
 }
 
 float Orchestrator::calculateAveragePriority() const {
-    if (trafficLights_.empty()) {
-        return 15.0f; 
+    if (m_relayedLights.empty()) {
+        return m_hot.averagePriority();
     }
-    double sumOfPriorities = 0.0;
-    // ALTERAÇÃO: Iterando sobre o vetor
-    for (const auto& tl : trafficLights_) {
-        sumOfPriorities += tl.priority;
+    // Cidade: semáforos diretos mais as médias reportadas pelas regiões, ponderadas
+    // pelo número de semáforos. Os de fronteira já contam na média da sua região.
+    double sum = m_hot.prioritySum();
+    size_t count = m_hot.size() - m_relayedLights.size();
+    for (LightId id : m_relayedLights) {
+        sum -= m_hot.priority[id];
     }
-    return static_cast<float>(sumOfPriorities / trafficLights_.size());
+    for (GroupId regionId = 0; regionId < static_cast<GroupId>(m_regions.size()); ++regionId) {
+        const float average = m_regionPriority[regionId].load(std::memory_order_relaxed);
+        if (m_regions[regionId].orchestrated && !std::isnan(average)) {
+            sum += static_cast<double>(average) * m_regions[regionId].lightCount;
+            count += m_regions[regionId].lightCount;
+        }
+    }
+    return count > 0 ? static_cast<float>(sum / count) : m_hot.averagePriority();
 }
 
 
-void Orchestrator::generateIntersectionCommand(const Intersection& intersection, const std::string& requesterName) {
-    auto now = std::chrono::steady_clock::now();
-    // ALTERAÇÃO: busca no vetor
-    auto* requesterTL_ptr = findTrafficLight(requesterName);
-    if (!requesterTL_ptr) return;
-    auto& requesterTL = *requesterTL_ptr;
+void Orchestrator::generateIntersectionCommand(GroupId intersectionId, LightId requesterId, Ticks now) {
+    const auto& intersection = intersections_[intersectionId];
+    auto& requesterTL = trafficLights_[requesterId];
+    const std::string& requesterName = requesterTL.name;
     
-    int avgRttOneWay = getAverageRTT() / 2;
-
     if (intersection.needsNormalization) {
-        requesterTL.command += ";set_state:RED;set_current_time:" + std::to_string(config::RECOVERY_RED_TIME_MS);
-        requesterTL.endTime = now + std::chrono::milliseconds(config::RECOVERY_RED_TIME_MS);
-        log(LogLevel::DEBUG, "Comando de normalização para " + requesterName + ": " + requesterTL.command);
+        m_hot.color[requesterId] = Color::RED;
+        m_hot.endTime[requesterId] = now + m_options.control.recoveryRedTimeMs;
+        sendPlan(requesterId);
+        noteChange(requesterId);
+        log(LogLevel::DEBUG, "Comando de normalização para " + requesterName + ": " + command::toString(requesterTL.command));
         return; 
     }
     if (intersection.isCompromised) {
-        requesterTL.command += ";set_state:ALERT";
-        log(LogLevel::DEBUG, "Comando de alerta (cruzamento comprometido) para " + requesterName + ": " + requesterTL.command);
+        commandFor(requesterId).push(CommandOp::SET_STATE, Color::ALERT);
+        log(LogLevel::DEBUG, "Comando de alerta (cruzamento comprometido) para " + requesterName + ": " + command::toString(requesterTL.command));
         return; 
     }
 
-    std::string activeLightName = "";
-    for (const auto& name : intersection.trafficLightNames) {
-        // ALTERAÇÃO: busca no vetor
-        if (const auto* tl = findTrafficLight(name)) {
-            if (tl->state == "GREEN" || tl->state == "YELLOW") {
-                activeLightName = name;
-                break;
-            }
-        }
-    }
-
-    if (activeLightName.empty() || requesterName == activeLightName) {
+    LightId activeId = m_activeLightPerIntersection[intersectionId];
+    if (activeId == INVALID_LIGHT || activeId == requesterId) {
         return;
     }
 
-    // ALTERAÇÃO: busca no vetor
-    const auto* activeTL_ptr = findTrafficLight(activeLightName);
-    if (!activeTL_ptr) return;
-    const auto& activeTL = *activeTL_ptr;
-
-    int activeRemainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(activeTL.endTime - now).count();
-    if (activeTL.state == "GREEN") {
+    int activeRemainingMs = m_hot.remainingMs(activeId, now);
+    if (m_hot.color[activeId] == Color::GREEN) {
         activeRemainingMs += config::YELLOW_TIME_MS;
     }
 
-    int finalCommandTime = activeRemainingMs - avgRttOneWay;
-    if (finalCommandTime < 0) return;
+    if (activeRemainingMs < 0) return;
 
-    int currentRemainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(requesterTL.endTime - now).count();
+    int currentRemainingMs = m_hot.remainingMs(requesterId, now);
 
     if (std::abs(currentRemainingMs - activeRemainingMs) > 2000) {
-        requesterTL.command += ";set_state:RED;set_current_time:" + std::to_string(finalCommandTime);
-        requesterTL.endTime = activeTL.endTime;
-        log(LogLevel::DEBUG, "Comando de sincronia para " + requesterName + ": " + requesterTL.command);
+        m_hot.color[requesterId] = Color::RED;
+        m_hot.endTime[requesterId] = now + activeRemainingMs;
+        sendPlan(requesterId);
+        noteChange(requesterId);
+        log(LogLevel::DEBUG, "Comando de sincronia para " + requesterName + ": " + command::toString(requesterTL.command));
         return;
     }
 }
 
 
-void Orchestrator::forceCycleStart(const std::string& intersectionName) {
-    const auto& priorityList = sortedPriorityCache_.at(intersectionName);
+void Orchestrator::forceCycleStart(GroupId intersectionId, Ticks now) {
+    const auto& priorityList = sortedPriorityCache_[intersectionId];
     if (priorityList.empty()) return;
 
-    const std::string& leaderName = priorityList.front().first;
-    // ALTERAÇÃO: busca no vetor
-    auto* leaderTL_ptr = findTrafficLight(leaderName);
-    if (!leaderTL_ptr) return;
-    auto& leaderTL = *leaderTL_ptr;
-    
-    auto now = std::chrono::steady_clock::now();
-
-    int avgRttOneWay = getAverageRTT() / 2;
-    int finalCommandTime = config::GREEN_BASE_TIME_MS - avgRttOneWay;
-    if (finalCommandTime < 0) return;
+    LightId leaderId = priorityList.front().first;
+    auto& leaderTL = trafficLights_[leaderId];
 
-    leaderTL.command += ";set_state:GREEN;set_current_time:" + std::to_string(finalCommandTime);
-    leaderTL.endTime = now + std::chrono::milliseconds(config::GREEN_BASE_TIME_MS);
-    leaderTL.state = "GREEN";
+    m_hot.endTime[leaderId] = now + m_options.control.greenBaseTimeMs;
+    m_hot.color[leaderId] = Color::GREEN;
+    sendPlan(leaderId);
+    noteChange(leaderId);
 
-    log(LogLevel::INFO, "Cruzamento " + intersectionName + " inativo. Forçando início com " + leaderName);
-    log(LogLevel::DEBUG, "Comando gerado para " + leaderName + ": " + leaderTL.command);
+    log(LogLevel::INFO, "Cruzamento " + intersections_[intersectionId].name + " inativo. Forçando início com " + leaderTL.name);
+    log(LogLevel::DEBUG, "Comando gerado para " + leaderTL.name + ": " + command::toString(leaderTL.command));
 }
 
 
-void Orchestrator::processGreenWaves() {
-    for (auto& wave : greenWaves_) {
-        if (wave.trafficLightNames.empty()) continue;
+void Orchestrator::processGreenWave(GroupId waveId, Ticks now) {
+    auto& wave = greenWaves_[waveId];
+    const auto& members = m_registry.waveMembers(waveId);
+    if (members.empty()) return;
 
-        const std::string& waveLeaderName = wave.trafficLightNames.front();
-        // ALTERAÇÃO: busca no vetor
-        const auto* waveLeaderTL_ptr = findTrafficLight(waveLeaderName);
-        if (!waveLeaderTL_ptr) continue;
-        const auto& waveLeaderTL = *waveLeaderTL_ptr;
+    LightId waveLeaderId = members.front();
+    if (waveLeaderId == INVALID_LIGHT) return;
+    const Color leaderColor = m_hot.color[waveLeaderId];
 
-        if (waveLeaderTL.state == "GREEN" && !wave.hasBeenTriggered) {
-            wave.hasBeenTriggered = true; 
-            auto now = std::chrono::steady_clock::now();
-            log(LogLevel::INFO, "Processando '" + wave.name + "'.");
+    if (leaderColor == Color::GREEN && !wave.hasBeenTriggered) {
+        wave.hasBeenTriggered = true; 
+        log(LogLevel::INFO, "Processando '" + wave.name + "'.");
 
-            int leaderRemainingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(waveLeaderTL.endTime - now).count();
-            if (leaderRemainingTimeMs < 0) leaderRemainingTimeMs = 0;
+        int leaderRemainingTimeMs = m_hot.remainingMs(waveLeaderId, now);
+        if (leaderRemainingTimeMs < 0) leaderRemainingTimeMs = 0;
 
-            for (size_t i = 0; i < wave.trafficLightNames.size(); ++i) {
-                const std::string& memberName = wave.trafficLightNames[i];
-                if (memberName == waveLeaderName) continue;
-                int offsetMs = static_cast<int>(i) * wave.travelTimeMs;
-                
-                // ALTERAÇÃO: busca no vetor
-                auto* memberTL_ptr = findTrafficLight(memberName);
-                if (!memberTL_ptr) continue;
-                auto& memberTL = *memberTL_ptr;
-
-                const auto* intersection = findIntersectionFor(memberName);
-                if (intersection) {
-                    if (memberTL.state == "GREEN") {
-                        int memberRemainingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(memberTL.endTime - now).count();
-                        int timeDiffMs = leaderRemainingTimeMs - memberRemainingTimeMs;
-
-                        if (timeDiffMs <= offsetMs) {
-                            memberTL.command += ";set_current_time:" + std::to_string(leaderRemainingTimeMs + offsetMs);
-                            memberTL.endTime = waveLeaderTL.endTime;
-                            log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
-                        }
-                        else if (timeDiffMs > offsetMs) {
-                            memberTL.command += ";increase_time:" + std::to_string(offsetMs);
-                            memberTL.endTime += std::chrono::seconds(5);
-                            log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
-                        }
+        for (size_t i = 0; i < members.size(); ++i) {
+            LightId memberId = members[i];
+            if (memberId == INVALID_LIGHT || memberId == waveLeaderId) continue;
+            int offsetMs = static_cast<int>(i) * wave.travelTimeMs;
+            auto& memberTL = trafficLights_[memberId];
+            const Color memberColor = m_hot.color[memberId];
+            const Ticks memberEndTime = m_hot.endTime[memberId];
+
+            bool replan = false;
+
+            if (m_hot.partOfIntersection[memberId]) {
+                if (memberColor == Color::GREEN) {
+                    int memberRemainingTimeMs = m_hot.remainingMs(memberId, now);
+                    int timeDiffMs = leaderRemainingTimeMs - memberRemainingTimeMs;
+
+                    if (timeDiffMs <= offsetMs) {
+                        m_hot.endTime[memberId] = now + leaderRemainingTimeMs + offsetMs;
                     }
-                    double greenDurationFactor = 1.0;
-                    const std::string& competitorName = (intersection->trafficLightNames[0] == memberName)
-                                                      ? intersection->trafficLightNames[1]
-                                                      : intersection->trafficLightNames[0];
-
-                    // ALTERAÇÃO: busca no vetor
-                    if (const auto* competitorTL = findTrafficLight(competitorName)) {
-                        if (memberTL.priority < competitorTL->priority) {
-                            greenDurationFactor = config::LOW_PRIORITY_WAVE_FACTOR;
-                        }
+                    else if (timeDiffMs > offsetMs) {
+                        m_hot.endTime[memberId] += offsetMs;
                     }
-                    
-                    int finalGreenDurationMs = static_cast<int>(leaderRemainingTimeMs * greenDurationFactor);
-                    memberTL.command += ";set_green_duration:" + std::to_string(finalGreenDurationMs + offsetMs);
-                    log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
                 }
-                else { 
-                    if (memberTL.state == "GREEN") {
-                        int targetRemainingMs = leaderRemainingTimeMs + offsetMs;
-                        int currentRemainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(memberTL.endTime - now).count();
-                        if (std::abs(currentRemainingMs - targetRemainingMs) > 1000) {
-                            memberTL.command = ";set_current_time:" + std::to_string(targetRemainingMs);
-                            memberTL.endTime = now + std::chrono::milliseconds(targetRemainingMs);
-                            log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
-                        }
+                double greenDurationFactor = 1.0;
+                LightId competitorId = m_registry.competitorOf(memberId);
+                if (competitorId != INVALID_LIGHT && m_hot.priority[memberId] < m_hot.priority[competitorId]) {
+                    greenDurationFactor = m_options.control.lowPriorityWaveFactor;
+                }
+                
+                int finalGreenDurationMs = static_cast<int>(leaderRemainingTimeMs * greenDurationFactor);
+                m_plannedDurations[memberId].ms[static_cast<size_t>(Color::GREEN)] = finalGreenDurationMs + offsetMs;
+                replan = true;
+            }
+            else { 
+                if (memberColor == Color::GREEN) {
+                    int targetRemainingMs = leaderRemainingTimeMs + offsetMs;
+                    int currentRemainingMs = m_hot.remainingMs(memberId, now);
+                    if (std::abs(currentRemainingMs - targetRemainingMs) > 1000) {
+                        clearCommand(memberId);
+                        m_hot.endTime[memberId] = now + targetRemainingMs;
+                        replan = true;
+                    }
+                }
+                else if (memberColor == Color::RED) {
+                    int memberRemainingTimeMs = m_hot.remainingMs(memberId, now);
+                    
+                    if (memberRemainingTimeMs > 5000) {
+                        clearCommand(memberId);
+                        m_hot.endTime[memberId] -= 5000;
                     }
-                    else if (memberTL.state == "RED") {
-                        int memberRemainingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(memberTL.endTime - now).count();
-                        
-                        if (memberRemainingTimeMs > 5000) {
-                            memberTL.command = ";decrease_time:5000";
-                            memberTL.endTime -= std::chrono::milliseconds(offsetMs);
-                            log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
-                        }
-                        else {
-                            int targetRemainingMs = leaderRemainingTimeMs + offsetMs;
-                            int finalCommandTime = targetRemainingMs - (getAverageRTT() / 2);
-                            if (finalCommandTime < 0) finalCommandTime = 0;
-
-                            memberTL.command = ";set_state:GREEN;set_current_time:" + std::to_string(finalCommandTime);
-                            memberTL.endTime = now + std::chrono::milliseconds(targetRemainingMs);
-                            memberTL.state = "GREEN";
-                            log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + memberTL.command);
-                        }
+                    else {
+                        int targetRemainingMs = leaderRemainingTimeMs + offsetMs;
+
+                        clearCommand(memberId);
+                        m_hot.endTime[memberId] = now + targetRemainingMs;
+                        m_hot.color[memberId] = Color::GREEN;
                     }
+                    replan = true;
                 }
             }
-        }
-        else if (waveLeaderTL.state != "GREEN") {
-            wave.hasBeenTriggered = false;
+            if (replan) {
+                sendPlan(memberId);
+                log(LogLevel::DEBUG, "Comando gerado para " + memberTL.name + ": " + command::toString(memberTL.command));
+            }
+            if (m_hot.color[memberId] != memberColor || m_hot.endTime[memberId] != memberEndTime) {
+                noteChange(memberId);
+            }
         }
     }
+    else if (leaderColor != Color::GREEN) {
+        wave.hasBeenTriggered = false;
+    }
 }
 
 
-void Orchestrator::processSyncGroups() {
-    auto now = std::chrono::steady_clock::now();
-    int avgRttOneWay = getAverageRTT() / 2;
+void Orchestrator::processSyncGroup(GroupId groupId, Ticks now) {
+    const auto& members = m_registry.syncGroupMembers(groupId);
+    if (members.size() < 2) return;
 
-    for (const auto& group : syncGroups_) {
-        if (group.trafficLightNames.size() < 2) continue;
+    LightId leaderId = members.front();
+    if (leaderId == INVALID_LIGHT) return;
+    const auto& leaderTL = trafficLights_[leaderId];
 
-        const std::string& leaderName = group.trafficLightNames.front();
-        // ALTERAÇÃO: busca no vetor
-        const auto* leaderTL_ptr = findTrafficLight(leaderName);
-        if (!leaderTL_ptr) continue;
-        const auto& leaderTL = *leaderTL_ptr;
+    for (size_t i = 1; i < members.size(); i++) {
+        LightId followerId = members[i];
+        if (followerId == INVALID_LIGHT) continue;
+        auto& followerTL = trafficLights_[followerId];
 
-        for (size_t i = 1; i < group.trafficLightNames.size(); i++) {
-            const std::string& followerName = group.trafficLightNames[i];
-            // ALTERAÇÃO: busca no vetor
-            auto* followerTL_ptr = findTrafficLight(followerName);
-            if (!followerTL_ptr) continue;
-            auto& followerTL = *followerTL_ptr;
 
+        int remainingMs = m_hot.remainingMs(leaderId, now);
 
-            int remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(leaderTL.endTime - now).count();
-            remainingMs -= avgRttOneWay;
-            
-            int followerRemainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(followerTL.endTime - now).count();
+        int followerRemainingMs = m_hot.remainingMs(followerId, now);
 
-            if (followerTL.state != leaderTL.state && std::abs(followerRemainingMs - remainingMs) > 1000) {
-                if (remainingMs < 0) {
-                    continue; 
-                }
+        if (m_hot.color[followerId] != m_hot.color[leaderId] && std::abs(followerRemainingMs - remainingMs) > 1000) {
+            if (remainingMs < 0) {
+                continue; 
+            }
 
-                followerTL.command = ";set_state:" + leaderTL.state + ";set_current_time:" + std::to_string(remainingMs);
-                
-                followerTL.endTime = leaderTL.endTime;
-                followerTL.state = leaderTL.state;
+            clearCommand(followerId);
+            m_hot.endTime[followerId] = m_hot.endTime[leaderId];
+            m_hot.color[followerId] = m_hot.color[leaderId];
+            sendPlan(followerId);
+            noteChange(followerId);
 
-                std::stringstream ss;
-                ss << "Forçando " << followerName << " a sincronizar com o líder " << leaderName;
-                log(LogLevel::INFO, ss.str());
-                log(LogLevel::DEBUG, "Comando gerado para " + followerName + ": " + followerTL.command);
-            }
+            std::stringstream ss;
+            ss << "Forçando " << followerTL.name << " a sincronizar com o líder " << leaderTL.name;
+            log(LogLevel::INFO, ss.str());
+            log(LogLevel::DEBUG, "Comando gerado para " + followerTL.name + ": " + command::toString(followerTL.command));
         }
     }
 }
 
 
-void Orchestrator::assignPriorityCommands() {
-    float averagePriority = calculateAveragePriority();
+// Só os semáforos do shard; a média é a global, calculada antes da passagem.
+void Orchestrator::assignPriorityCommands(const Shard& shard, float averagePriority, Ticks now) {
+    const int maxAdjustments = m_options.control.maxAdjustments;
+    const int adjustmentMs = m_options.control.adjustmentMs;
+
+    // Os ajustes mudam as durações planejadas, e o plano seguinte as leva inteiras:
+    // um lote perdido ou repetido não desloca o tempo do semáforo.
+    auto shiftGreen = [this](LightId id, int deltaMs) {
+        auto& durations = m_plannedDurations[id].ms;
+        int& green = durations[static_cast<size_t>(Color::GREEN)];
+        int& red = durations[static_cast<size_t>(Color::RED)];
+        if (deltaMs > 0) {
+            green += deltaMs;
+            if (red > deltaMs + config::MIN_PLANNED_PHASE_MS) red -= deltaMs;
+        } else {
+            if (green > -deltaMs + config::MIN_PLANNED_PHASE_MS) green += deltaMs;
+            red -= deltaMs;
+        }
+        sendPlan(id);
+    };
 
-    // ALTERAÇÃO: Iterando sobre o vetor
-    for (auto& light : trafficLights_) {
-        if (light.isAlert() && !light.partOfIntersection) {
-            light.command += ";set_default_duration;set_state:RED;set_current_time:15000"; 
+    for (LightId id : shard.lights) {
+        if (m_relayed[id]) {
+            continue;   // a prioridade do semáforo de fronteira é ajustada pela região
+        }
+        auto& light = trafficLights_[id];
+        if (m_hot.color[id] == Color::ALERT && !m_hot.partOfIntersection[id]) {
+            m_plannedDurations[id] = m_phaseDurations[id];
+            m_hot.color[id] = Color::RED;
+            m_hot.endTime[id] = now + config::ALERT_RECOVERY_RED_MS;
+            noteChange(id);
+            sendPlan(id);
             log(LogLevel::INFO, "Semáforo " + light.name + 
-                                " em ALERTA. Enviando comando para RESETAR DURAÇÕES e ir para o estado VERMELHO.");
-            light.adjustment_state = {0, true};
+                                " em ALERTA. Enviando plano com as DURAÇÕES PADRÃO a partir do estado VERMELHO.");
+            m_hot.adjustCount[id] = 0;
+            m_hot.adjustGaining[id] = true;
             continue; 
         }
+        // O plano é renovado antes de acabar, para o semáforo seguir coordenado
+        // mesmo sem receber lotes por um tempo.
+        if (phase::cycles(m_hot.color[id]) &&
+            plannedPhasesLeft(id, now) < static_cast<size_t>(config::PLAN_REFRESH_PHASES)) {
+            sendPlan(id);
+        }
+
+        const float priority = m_hot.priority[id];
+        const int8_t trend = static_cast<int8_t>((priority > averagePriority) - (priority < averagePriority));
+        if (trend == 0) {
+            continue;
+        }
 
-        auto& adjustment = light.adjustment_state;
-        const int MAX_ADJUSTMENTS = 3;
-        const std::string ADJUSTMENT_VALUE_MS = "5000"; 
+        auto& count = m_hot.adjustCount[id];
+        const bool gaining = m_hot.adjustGaining[id];
+        const std::string priorityStr = std::to_string(m_hot.priority[id]);
 
-        if (light.priority > averagePriority){ 
-            if (adjustment.second == false) { 
-                if (adjustment.first > 0) {
-                    adjustment.first--;
-                    log(LogLevel::DEBUG, light.name + " pagando débito. Contador: " + std::to_string(adjustment.first));
+        if (trend > 0) { 
+            if (gaining == false) { 
+                if (count > 0) {
+                    count--;
+                    log(LogLevel::DEBUG, light.name + " pagando débito. Contador: " + std::to_string(count));
                 } else { 
-                    adjustment.second = true;
-                    adjustment.first = 1;
-                    light.command += ";increase_green_duration:" + ADJUSTMENT_VALUE_MS + ";decrease_red_duration:" + ADJUSTMENT_VALUE_MS;
-                    log(LogLevel::INFO, light.name + " (P:" + std::to_string(light.priority) + ") inverteu tendência para GANHAR tempo.");
+                    m_hot.adjustGaining[id] = true;
+                    count = 1;
+                    shiftGreen(id, adjustmentMs);
+                    log(LogLevel::INFO, light.name + " (P:" + priorityStr + ") inverteu tendência para GANHAR tempo.");
                 }
             } else { 
-                if (adjustment.first < MAX_ADJUSTMENTS) {
-                    adjustment.first++;
-                    light.command += ";increase_green_duration:" + ADJUSTMENT_VALUE_MS + ";decrease_red_duration:" + ADJUSTMENT_VALUE_MS;
-                    log(LogLevel::DEBUG, light.name + " continua a ganhar tempo. Contador: " + std::to_string(adjustment.first));
+                if (count < maxAdjustments) {
+                    count++;
+                    shiftGreen(id, adjustmentMs);
+                    log(LogLevel::DEBUG, light.name + " continua a ganhar tempo. Contador: " + std::to_string(count));
                 } else {
                     log(LogLevel::DEBUG, light.name + " no limite de ganho de tempo.");
                 }
             }
-        } else if (light.priority == averagePriority) {
-                continue;
-        }else {
-            if (adjustment.second == true) {
-                if (adjustment.first > 0) { 
-                    adjustment.first--;
-                    log(LogLevel::DEBUG, light.name + " pagando débito. Contador: " + std::to_string(adjustment.first));
+        } else {
+            if (gaining == true) {
+                if (count > 0) { 
+                    count--;
+                    log(LogLevel::DEBUG, light.name + " pagando débito. Contador: " + std::to_string(count));
                 } else { 
-                    adjustment.second = false;
-                    adjustment.first = 1;
-                    light.command += ";decrease_green_duration:" + ADJUSTMENT_VALUE_MS + ";increase_red_duration:" + ADJUSTMENT_VALUE_MS;
-                    log(LogLevel::INFO, light.name + " (P:" + std::to_string(light.priority) + ") inverteu tendência para CEDER tempo.");
+                    m_hot.adjustGaining[id] = false;
+                    count = 1;
+                    shiftGreen(id, -adjustmentMs);
+                    log(LogLevel::INFO, light.name + " (P:" + priorityStr + ") inverteu tendência para CEDER tempo.");
                 }
             } else {
-                if (adjustment.first < MAX_ADJUSTMENTS) {
-                    adjustment.first++;
-                    light.command += ";decrease_green_duration:" + ADJUSTMENT_VALUE_MS + ";increase_red_duration:" + ADJUSTMENT_VALUE_MS;
-                    log(LogLevel::DEBUG, light.name + " continua a ceder tempo. Contador: " + std::to_string(adjustment.first));
+                if (count < maxAdjustments) {
+                    count++;
+                    shiftGreen(id, -adjustmentMs);
+                    log(LogLevel::DEBUG, light.name + " continua a ceder tempo. Contador: " + std::to_string(count));
                 } else {
                     log(LogLevel::DEBUG, light.name + " no limite de cessão de tempo.");
                 }
@@ -766,12 +2122,3 @@ void Orchestrator::assignPriorityCommands() {
         }
     } 
 }
-
-
-TrafficLightState* Orchestrator::findTrafficLight(const std::string& name) {
-    auto it = std::find_if(trafficLights_.begin(), trafficLights_.end(),
-                           [&name](const TrafficLightState& tl) {
-                               return tl.name == name;
-                           });
-    return (it != trafficLights_.end()) ? &(*it) : nullptr;
-}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "../include/PacketVerifier.hpp"
+#include "../include/Clock.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+PacketVerifier::PacketVerifier(ndn::security::Validator& validator, const LinkSigner& signer)
+  : m_validator(validator),
+    m_signer(signer)
+{
+}
+
+void PacketVerifier::verify(const ndn::Data& data, LinkSigner::LinkId link,
+                            const SuccessCallback& onSuccess, const FailureCallback& onFailure) {
+  const auto start = Clock::now();
+  const auto& implicitDigest = data.getFullName().get(-1);
+  std::string digest(reinterpret_cast<const char*>(implicitDigest.value()), implicitDigest.value_size());
+
+  // A validade da memória segue o relógio do plano de controle (virtual na
+  // simulação); a latência, o relógio real.
+  const auto now = steadyNow();
+  auto it = m_memo.find(digest);
+  if (it != m_memo.end() && now < it->second) {
+    record(start, true, true);
+    return onSuccess();
+  }
+
+  if (m_signer.mode() != SigningMode::ASYMMETRIC) {
+    if (!m_signer.verify(data, link)) {
+      record(start, false, false);
+      return onFailure("assinatura inválida");
+    }
+    remember(digest, now);
+    record(start, true, false);
+    return onSuccess();
+  }
+
+  m_validator.validate(data,
+      [this, start, digest = std::move(digest), onSuccess](const ndn::Data&) {
+        remember(digest, steadyNow());
+        record(start, true, false);
+        onSuccess();
+      },
+      [this, start, onFailure](const ndn::Data&, const ndn::security::ValidationError& error) {
+        record(start, false, false);
+        std::ostringstream ss;
+        ss << error;
+        onFailure(ss.str());
+      });
+}
+
+void PacketVerifier::verify(const ndn::Interest& interest, LinkSigner::LinkId link,
+                            const SuccessCallback& onSuccess, const FailureCallback& onFailure) {
+  // Interests assinados são únicos (seq + nonce), então não passam pela memória.
+  const auto start = Clock::now();
+  if (m_signer.mode() != SigningMode::ASYMMETRIC) {
+    bool ok = m_signer.verify(interest, link);
+    record(start, ok, false);
+    return ok ? onSuccess() : onFailure("assinatura inválida");
+  }
+
+  m_validator.validate(interest,
+      [this, start, onSuccess](const ndn::Interest&) {
+        record(start, true, false);
+        onSuccess();
+      },
+      [this, start, onFailure](const ndn::Interest&, const ndn::security::ValidationError& error) {
+        record(start, false, false);
+        std::ostringstream ss;
+        ss << error;
+        onFailure(ss.str());
+      });
+}
+
+void PacketVerifier::remember(const std::string& digest, Clock::time_point now) {
+  auto [it, inserted] = m_memo.insert_or_assign(digest, now + MEMO_TTL);
+  if (!inserted) {
+    return;
+  }
+  m_memoOrder.push_back(digest);
+  if (m_memoOrder.size() > MEMO_CAPACITY) {
+    m_memo.erase(m_memoOrder.front());
+    m_memoOrder.pop_front();
+  }
+}
+
+void PacketVerifier::record(Clock::time_point start, bool ok, bool memoHit) {
+  auto latencyUs = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+  if (!ok) {
+    m_stats.failures++;
+  } else if (memoHit) {
+    m_stats.memoHits++;
+  } else {
+    m_stats.verified++;
+  }
+  m_stats.totalLatencyUs += latencyUs;
+  m_stats.maxLatencyUs = std::max(m_stats.maxLatencyUs, latencyUs);
+}
+
+PacketVerifier::Stats PacketVerifier::takeStats() {
+  Stats stats = m_stats;
+  m_stats = Stats{};
+  return stats;
+}
@@ -0,0 +1,58 @@
+#include "../include/RealTime.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+namespace rt {
+
+bool lockMemory(std::string& error) {
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    error = std::string("mlockall: ") + std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool pinToCpu(int cpu, std::string& error) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (rc != 0) {
+    error = "afinidade com o núcleo " + std::to_string(cpu) + ": " + std::strerror(rc);
+    return false;
+  }
+  return true;
+}
+
+bool setFifoPriority(int priority, std::string& error) {
+  sched_param param{};
+  param.sched_priority = priority;
+  const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (rc != 0) {
+    error = "SCHED_FIFO " + std::to_string(priority) + ": " + std::strerror(rc);
+    return false;
+  }
+  return true;
+}
+
+void prefaultStack(size_t bytes) {
+  volatile unsigned char* stack = static_cast<volatile unsigned char*>(__builtin_alloca(bytes));
+  for (size_t i = 0; i < bytes; i += 4096) {
+    stack[i] = 0;
+  }
+}
+
+void sleepUntil(Ticks deadline) {
+  timespec ts{};
+  ts.tv_sec = static_cast<time_t>(deadline / 1000);
+  ts.tv_nsec = static_cast<long>((deadline % 1000) * 1000000);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+  }
+}
+
+} // namespace rt
@@ -0,0 +1,103 @@
+#include "../include/RegionPlan.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace {
+
+// Região comum a todos os membros, ou -1 se o grupo atravessa regiões ou tem
+// algum membro fora delas.
+int commonRegion(const YamlParser& parser, const std::vector<std::string>& members) {
+  const int region = parser.getRegionIndexOf(members.front());
+  for (const auto& name : members) {
+    if (parser.getRegionIndexOf(name) != region) {
+      return -1;
+    }
+  }
+  return region;
+}
+
+bool aggregatorInside(const AggregatorConfig& aggregator, const RegionConfig& region) {
+  return aggregator.region == region.prefix || region.covers(aggregator.region);
+}
+
+} // namespace
+
+OrchestratorView buildOrchestratorView(const YamlParser& parser, int regionIndex, const std::string& cityPrefix) {
+  const auto& regions = parser.getRegions();
+  OrchestratorView view;
+
+  // Semáforos de região que algum grupo da cidade alcança, com os parceiros de cruzamento.
+  std::set<std::string> boundary;
+  auto addBoundary = [&](const std::vector<std::string>& members) {
+    for (const auto& name : members) {
+      if (parser.getRegionIndexOf(name) >= 0) {
+        boundary.insert(name);
+      }
+    }
+  };
+  for (const auto& wave : parser.getGreenWaves()) {
+    if (commonRegion(parser, wave.trafficLightNames) < 0) addBoundary(wave.trafficLightNames);
+  }
+  for (const auto& sync : parser.getSyncGroups()) {
+    if (commonRegion(parser, sync.trafficLightNames) < 0) addBoundary(sync.trafficLightNames);
+  }
+  std::vector<std::string> observedIntersections;
+  for (const auto& [crossName, cross] : parser.getIntersections()) {
+    if (commonRegion(parser, cross.trafficLightNames) >= 0 &&
+        std::any_of(cross.trafficLightNames.begin(), cross.trafficLightNames.end(),
+                    [&](const std::string& name) { return boundary.count(name) > 0; })) {
+      observedIntersections.push_back(crossName);
+    }
+  }
+  for (const auto& crossName : observedIntersections) {
+    addBoundary(parser.getIntersections().at(crossName).trafficLightNames);
+  }
+
+  for (const auto& light : parser.getTrafficLights()) {
+    const int region = parser.getRegionIndexOf(light.first);
+    if (region == regionIndex || (regionIndex < 0 && boundary.count(light.first) > 0)) {
+      view.trafficLights.push_back(light);
+    }
+    if (regionIndex >= 0 && region == regionIndex && boundary.count(light.first) > 0) {
+      view.role.boundaryLights.push_back(light.first);
+    }
+  }
+
+  for (const auto& [crossName, cross] : parser.getIntersections()) {
+    const int region = commonRegion(parser, cross.trafficLightNames);
+    if (region == regionIndex ||
+        (regionIndex < 0 && std::find(observedIntersections.begin(), observedIntersections.end(), crossName) != observedIntersections.end())) {
+      view.intersections[crossName] = cross;
+    }
+  }
+  for (const auto& wave : parser.getGreenWaves()) {
+    if (commonRegion(parser, wave.trafficLightNames) == regionIndex) view.greenWaves.push_back(wave);
+  }
+  for (const auto& sync : parser.getSyncGroups()) {
+    if (commonRegion(parser, sync.trafficLightNames) == regionIndex) view.syncGroups.push_back(sync);
+  }
+
+  for (const auto& aggregator : parser.getAggregators()) {
+    const bool inside = regionIndex >= 0
+        ? aggregatorInside(aggregator, regions[regionIndex])
+        : std::none_of(regions.begin(), regions.end(),
+                       [&](const RegionConfig& region) { return aggregatorInside(aggregator, region); });
+    if (inside) {
+      view.aggregators.push_back(aggregator);
+    }
+  }
+
+  if (regionIndex >= 0) {
+    view.role.region = regions[regionIndex].prefix;
+    view.role.upstream = cityPrefix;
+  } else {
+    for (size_t r = 0; r < regions.size(); ++r) {
+      const auto& lights = parser.getTrafficLights();
+      const auto count = std::count_if(lights.begin(), lights.end(),
+                                       [&](const auto& light) { return regions[r].covers(light.first); });
+      view.role.subRegions.emplace_back(regions[r].prefix, static_cast<uint32_t>(count));
+    }
+  }
+  return view;
+}
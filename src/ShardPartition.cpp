@@ -0,0 +1,121 @@
+#include "../include/ShardPartition.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace {
+
+// Union-find com compressão de caminho sobre LightIds.
+class DisjointSets {
+public:
+  explicit DisjointSets(size_t count) : parent_(count) {
+    std::iota(parent_.begin(), parent_.end(), LightId{0});
+  }
+
+  LightId find(LightId id) {
+    while (parent_[id] != id) {
+      parent_[id] = parent_[parent_[id]];
+      id = parent_[id];
+    }
+    return id;
+  }
+
+  void unite(const std::vector<LightId>& members) {
+    LightId first = INVALID_LIGHT;
+    for (LightId id : members) {
+      if (id == INVALID_LIGHT) {
+        continue;
+      }
+      if (first == INVALID_LIGHT) {
+        first = find(id);
+      } else {
+        parent_[find(id)] = first;
+      }
+    }
+  }
+
+private:
+  std::vector<LightId> parent_;
+};
+
+// Shard do primeiro membro válido; grupos sem membros ficam no shard 0.
+uint32_t shardOfGroup(const std::vector<LightId>& members, const std::vector<uint32_t>& lightShard) {
+  for (LightId id : members) {
+    if (id != INVALID_LIGHT) {
+      return lightShard[id];
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+void ShardPartition::build(const LightRegistry& registry, size_t maxShards) {
+  const size_t lightCount = registry.lightCount();
+  DisjointSets sets(lightCount);
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.intersectionCount()); ++g) {
+    sets.unite(registry.intersectionMembers(g));
+  }
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.waveCount()); ++g) {
+    sets.unite(registry.waveMembers(g));
+  }
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.syncGroupCount()); ++g) {
+    sets.unite(registry.syncGroupMembers(g));
+  }
+
+  // Componentes numerados na ordem do primeiro semáforo, com o tamanho de cada um.
+  std::vector<uint32_t> component(lightCount);
+  std::vector<uint32_t> rootComponent(lightCount, UINT32_MAX);
+  std::vector<size_t> componentSize;
+  for (LightId id = 0; id < lightCount; ++id) {
+    auto& slot = rootComponent[sets.find(id)];
+    if (slot == UINT32_MAX) {
+      slot = static_cast<uint32_t>(componentSize.size());
+      componentSize.push_back(0);
+    }
+    component[id] = slot;
+    componentSize[slot]++;
+  }
+  componentCount_ = componentSize.size();
+
+  const size_t shardCount = std::max<size_t>(1, std::min(maxShards, componentCount_));
+  std::vector<uint32_t> order(componentCount_);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return componentSize[a] > componentSize[b];
+  });
+
+  using Load = std::pair<size_t, uint32_t>;   // (semáforos, shard)
+  std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+  for (uint32_t s = 0; s < shardCount; ++s) {
+    loads.push({0, s});
+  }
+  std::vector<uint32_t> componentShard(componentCount_);
+  for (uint32_t c : order) {
+    auto [load, shard] = loads.top();
+    loads.pop();
+    componentShard[c] = shard;
+    loads.push({load + componentSize[c], shard});
+  }
+
+  shards_.assign(shardCount, {});
+  lightShard_.resize(lightCount);
+  for (LightId id = 0; id < lightCount; ++id) {
+    lightShard_[id] = componentShard[component[id]];
+    shards_[lightShard_[id]].lights.push_back(id);
+  }
+  intersectionShard_.resize(registry.intersectionCount());
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.intersectionCount()); ++g) {
+    intersectionShard_[g] = shardOfGroup(registry.intersectionMembers(g), lightShard_);
+    shards_[intersectionShard_[g]].intersections.push_back(g);
+  }
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.waveCount()); ++g) {
+    shards_[shardOfGroup(registry.waveMembers(g), lightShard_)].waves.push_back(g);
+  }
+  for (GroupId g = 0; g < static_cast<GroupId>(registry.syncGroupCount()); ++g) {
+    shards_[shardOfGroup(registry.syncGroupMembers(g), lightShard_)].syncGroups.push_back(g);
+  }
+}
@@ -0,0 +1,71 @@
+#include "../include/ShardPool.hpp"
+
+#include <algorithm>
+
+ShardPool::ShardPool(size_t workers)
+  : m_queues(std::max<size_t>(workers, 1)) {
+  for (size_t w = 1; w < m_queues.size(); ++w) {
+    m_threads.emplace_back([this, w] { workerLoop(w); });
+  }
+}
+
+ShardPool::~ShardPool() {
+  m_stop.store(true, std::memory_order_relaxed);
+  m_generation.fetch_add(1, std::memory_order_release);
+  m_generation.notify_all();
+  m_threads.clear();   // junta os workers antes de destruir os atômicos que eles usam
+}
+
+void ShardPool::run(size_t count, const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+  const size_t workers = m_queues.size();
+  for (size_t w = 0; w < workers; ++w) {
+    m_queues[w].next.store(count * w / workers, std::memory_order_relaxed);
+    m_queues[w].end = count * (w + 1) / workers;
+  }
+  m_task = &task;
+  if (workers > 1) {
+    m_running.store(workers - 1, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_release);
+    m_generation.notify_all();
+  }
+
+  drain(0);
+
+  size_t running;
+  while ((running = m_running.load(std::memory_order_acquire)) != 0) {
+    m_running.wait(running, std::memory_order_acquire);
+  }
+  m_task = nullptr;
+}
+
+void ShardPool::workerLoop(size_t worker) {
+  uint64_t seen = 0;
+  while (true) {
+    m_generation.wait(seen, std::memory_order_acquire);
+    seen = m_generation.load(std::memory_order_acquire);
+    if (m_stop.load(std::memory_order_relaxed)) {
+      return;
+    }
+    drain(worker);
+    if (m_running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      m_running.notify_one();
+    }
+  }
+}
+
+void ShardPool::drain(size_t worker) {
+  const size_t workers = m_queues.size();
+  for (size_t k = 0; k < workers; ++k) {
+    auto& queue = m_queues[(worker + k) % workers];
+    size_t shard;
+    while ((shard = queue.next.fetch_add(1, std::memory_order_relaxed)) < queue.end) {
+      if (k > 0) {
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+      }
+      (*m_task)(shard);
+    }
+  }
+}
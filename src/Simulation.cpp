@@ -0,0 +1,159 @@
+#include "../include/Simulation.hpp"
+#include "../include/Clock.hpp"
+#include "../include/Orchestrator.hpp"
+#include "../include/SmartTrafficLight.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/random.hpp>
+#include <ndn-cxx/util/time-custom-clock.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sim {
+namespace {
+
+// Início do relógio virtual: longe de zero, que os instantes usam como "nunca".
+constexpr std::chrono::hours VIRTUAL_START{24};
+// Relógio de parede da simulação: 2026-01-01 00:00:00 UTC mais o tempo virtual.
+constexpr std::chrono::seconds VIRTUAL_WALL_EPOCH{1767225600};
+
+// Os relógios da ndn-cxx são do processo; estes leem o relógio virtual da
+// thread que pergunta, então cada simulação vê o seu.
+class VirtualSteadyClock : public ndn::time::CustomSteadyClock {
+public:
+  ndn::time::steady_clock::time_point getNow() const override {
+    return ndn::time::steady_clock::time_point(ndn::time::duration_cast<ndn::time::steady_clock::duration>(
+        ndn::time::nanoseconds(virtualNowNs)));
+  }
+
+  std::string getSince() const override { return " desde o início da simulação"; }
+
+  // Quem espera é o laço da simulação: os timers vencidos disparam no próximo poll().
+  ndn::time::steady_clock::duration toWaitDuration(ndn::time::steady_clock::duration) const override {
+    return ndn::time::steady_clock::duration(1);
+  }
+};
+
+class VirtualSystemClock : public ndn::time::CustomSystemClock {
+public:
+  ndn::time::system_clock::time_point getNow() const override {
+    const int64_t wallNs = std::chrono::nanoseconds(VIRTUAL_WALL_EPOCH).count() + virtualNowNs;
+    return ndn::time::system_clock::time_point(ndn::time::duration_cast<ndn::time::system_clock::duration>(
+        ndn::time::nanoseconds(wallNs)));
+  }
+
+  std::string getSince() const override { return " desde 1970-01-01"; }
+
+  ndn::time::system_clock::duration toWaitDuration(ndn::time::system_clock::duration) const override {
+    return ndn::time::system_clock::duration(1);
+  }
+};
+
+std::once_flag g_clocksInstalled;
+
+TrafficKpis runScenario(const YamlParser& parser, const ControlParams& control, const RunOptions& options) {
+  const auto& trafficLights = parser.getTrafficLights();
+  ProtocolOptions protocol = parser.getProtocolOptions();
+  if (protocol.signing == SigningMode::ASYMMETRIC) {
+    protocol.signing = SigningMode::DIGEST;
+  }
+  OrchestratorOptions orchestratorOptions = parser.getOrchestratorOptions();
+  orchestratorOptions.engine = EngineMode::EVENT;   // o TICK tem thread própria
+  orchestratorOptions.workers = 1;
+  orchestratorOptions.control = control;
+  std::filesystem::create_directories(options.metricsDir);
+
+  // Nonces dos Interests e das assinaturas de Interest saem do gerador da
+  // ndn-cxx, que é por thread como o relógio virtual.
+  ndn::random::getRandomNumberEngine().seed(options.seed);
+
+  boost::asio::io_context ioCtx;
+  ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+  keyChain.createIdentity("/sim");
+
+  const ndn::DummyClientFace::Options faceOptions{false, true};   // sem log de pacotes, com registro de prefixo
+  std::vector<std::unique_ptr<ndn::DummyClientFace>> faces;
+  auto newFace = [&]() -> ndn::DummyClientFace& {
+    faces.push_back(std::make_unique<ndn::DummyClientFace>(ioCtx, keyChain, faceOptions));
+    if (faces.size() > 1) {
+      faces.back()->linkTo(*faces.front());
+    }
+    return *faces.back();
+  };
+
+  const std::string cityPrefix = "/central";
+  Orchestrator orch(newFace(), keyChain);
+  orch.enableSimulation(options.seed);
+  orch.setMetricsDirectory(options.metricsDir);
+  orch.setup(cityPrefix);
+  orch.loadConfig(trafficLights, parser.getIntersections(), parser.getGreenWaves(), parser.getSyncGroups(), {},
+                  protocol, orchestratorOptions, HierarchyRole{}, options.logLevel);
+
+  std::vector<std::unique_ptr<SmartTrafficLight>> lights;
+  for (size_t i = 0; i < trafficLights.size(); ++i) {
+    TrafficLightState state = trafficLights[i].second;
+    state.name = trafficLights[i].first;
+    auto light = std::make_unique<SmartTrafficLight>(newFace(), keyChain);
+    light->setup(cityPrefix);
+    light->loadConfig(state, protocol, options.logLevel);
+    light->enableSimulation(options.seed + 1 + static_cast<uint32_t>(i));
+    lights.push_back(std::move(light));
+  }
+
+  orch.start();
+  for (auto& light : lights) {
+    light->start();
+  }
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  const auto step = std::chrono::milliseconds(options.stepMs);
+  const auto end = std::chrono::nanoseconds(VIRTUAL_START) + std::chrono::seconds(options.durationS);
+  for (auto now = std::chrono::nanoseconds(VIRTUAL_START); now < end;) {
+    ioCtx.poll();
+    if (ioCtx.stopped()) {
+      ioCtx.restart();
+    }
+    now += step;
+    setVirtualTime(now);
+  }
+  ioCtx.poll();
+
+  TrafficKpis kpis;
+  kpis.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  kpis.lights = lights.size();
+  uint64_t ticks = 0, queueSum = 0;
+  for (const auto& light : lights) {
+    const auto& stats = light->trafficStats();
+    kpis.arrivals += stats.arrivals;
+    kpis.departures += stats.departures;
+    kpis.maxQueue = std::max(kpis.maxQueue, stats.maxQueue);
+    ticks += stats.ticks;
+    queueSum += stats.queueSum;
+  }
+  kpis.throughputVph = kpis.departures * 3600.0 / static_cast<double>(options.durationS);
+  kpis.meanQueue = ticks ? static_cast<double>(queueSum) / static_cast<double>(ticks) : 0.0;
+  kpis.meanDelayS = kpis.departures ? static_cast<double>(queueSum) / static_cast<double>(kpis.departures) : 0.0;
+
+  // Os semáforos e o orquestrador saem antes das Faces que usam.
+  lights.clear();
+  return kpis;
+}
+
+} // namespace
+
+TrafficKpis run(const YamlParser& parser, const ControlParams& control, const RunOptions& options) {
+  std::call_once(g_clocksInstalled, [] {
+    ndn::time::setCustomClocks(std::make_shared<VirtualSteadyClock>(), std::make_shared<VirtualSystemClock>());
+  });
+  setVirtualTime(VIRTUAL_START);
+  TrafficKpis kpis = runScenario(parser, control, options);
+  setVirtualTime(std::chrono::nanoseconds(-1));
+  return kpis;
+}
+
+} // namespace sim
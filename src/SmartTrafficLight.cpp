@@ -3,13 +3,24 @@
 using namespace std::chrono;
 
 SmartTrafficLight::SmartTrafficLight() 
-   : m_validator(m_face)
+   : m_ownFace(std::make_unique<ndn::Face>(m_ioCtx)),
+     m_ownKeyChain(std::make_unique<ndn::KeyChain>()),
+     m_face(*m_ownFace),
+     m_keyChain(*m_ownKeyChain),
+     m_validator(m_face)
+{
+}
+
+SmartTrafficLight::SmartTrafficLight(ndn::Face& face, ndn::KeyChain& keyChain)
+   : m_face(face),
+     m_keyChain(keyChain),
+     m_validator(m_face)
 {
-    m_validator.load("config/trust-schema.conf");
 }
 
 SmartTrafficLight::~SmartTrafficLight() {
   m_stopFlag = true;
+  m_phaseCv.notify_all();
   if (m_cycleThread.joinable()) {
     m_cycleThread.join();
   }
@@ -19,13 +30,17 @@ void SmartTrafficLight::setup(const std::string& prefix){
     central = prefix;
 }
 
-void SmartTrafficLight::loadConfig(const TrafficLightState& config, LogLevel level) {
+void SmartTrafficLight::loadConfig(const TrafficLightState& config, const ProtocolOptions& protocol, LogLevel level) {
     this->m_logLevel = level;
-
-    constexpr int TA = 3; 
+    this->m_protocol = protocol;
+    m_signer.configure(protocol.signing, protocol.hmacSecretFile);
+    m_centralLink = m_signer.addLink(config.name);
+    if (protocol.signing == SigningMode::ASYMMETRIC) {
+        m_validator.load(protocol.trustSchema);
+    }
 
     this->prefix_ = config.name;
-    this->start_color = parseColor(config.state);
+    this->start_color = config.state;
     this->current_color = this->start_color;
     this->cycle_time = config.cycle;
 
@@ -34,18 +49,20 @@ void SmartTrafficLight::loadConfig(const TrafficLightState& config, LogLevel lev
     this->capacity = columns * lines;
     this->intensity = config.intensity;
 
-    colors_vector = {
-        {"GREEN", (cycle_time / 2) - TA},
-        {"YELLOW", TA},
-        {"RED", cycle_time / 2}
-    };
-    default_colors_vector = colors_vector;
-    
+    // Durações em ms; o orquestrador prevê as fases com as mesmas (PhaseModel.hpp).
+    m_defaultDurations = phase::defaultDurations(cycle_time);
+    m_durations = m_defaultDurations;
+
     log(LogLevel::INFO, "Configuração carregada com sucesso.");
 }
 
+// O laço de ciclo só monta a mensagem se ela vai ao log, sem alocar à toa.
+bool SmartTrafficLight::logs(LogLevel level) const {
+    return level <= m_logLevel;
+}
+
 void SmartTrafficLight::log(LogLevel level, const std::string& message) {
-    if (level <= m_logLevel) {
+    if (logs(level)) {
         std::string levelStr;
         switch (level) {
             case LogLevel::ERROR: levelStr = "[ERROR]"; break;
@@ -59,69 +76,215 @@ void SmartTrafficLight::log(LogLevel level, const std::string& message) {
     }
 }
 
+// Modo tempo real para a thread de ciclo: núcleo dedicado, SCHED_FIFO, memória
+// travada e aproximação final de cada troca com clock_nanosleep. Antes de run().
+void SmartTrafficLight::enableRealTime(int cpu) {
+    m_realTime = true;
+    m_realTimeCpu = cpu;
+}
+
+// Simulação (main/simulate.cpp): o motor de fases roda na thread da Face, em
+// eventos do m_scheduler, e o tráfego segue `seed`. Antes de start().
+void SmartTrafficLight::enableSimulation(uint32_t seed) {
+    m_simulated = true;
+    m_rng.seed(seed);
+}
+
 void SmartTrafficLight::run() {
+    start();
+    m_face.processEvents();
+}
+
+void SmartTrafficLight::start() {
     index = static_cast<size_t>(start_color);
     runProducer("");
     runConsumer();
+    if (m_protocol.statusMode != StatusMode::POLL) {
+        scheduleStatusCheck();
+    }
+    if (m_realTime) {
+        std::string error;
+        if (!rt::lockMemory(error)) {
+            log(LogLevel::ERROR, "Modo tempo real: " + error);
+        }
+    }
+    if (m_simulated) {
+        startPhaseEngine();
+        schedulePhaseStep(runPhaseEngine());
+        return;
+    }
     m_cycleThread = std::thread([this] { this->cycle(); });
-    m_face.processEvents();
 }
 
+static steady_clock::time_point deadline(Ticks ticks) {
+  return steady_clock::time_point(milliseconds(ticks));
+}
+
+// Motor de fases: cada fase termina num prazo absoluto do steady_clock e a
+// seguinte começa exatamente nesse prazo, não quando a thread acorda, então o
+// atraso de uma troca não se acumula no ciclo. A thread dorme até o mais próximo
+// entre o fim da fase e o próximo tick de tráfego (1 s); um lote de comandos
+// acorda a thread pela variável de condição e vale na hora. Só esta thread muda o
+// estado do semáforo, e cada mudança é publicada em m_state antes de ir ao log.
+//
+// Em tempo real a thread não passa pelo mutex: dorme com clock_nanosleep até o
+// prazo absoluto, em fatias de no máximo RT_COMMAND_POLL_MS, e a cada volta
+// runPhaseEngine() esvazia a fila de comandos. Um lote espera no máximo uma
+// fatia, e a última fatia termina exatamente no prazo da troca.
 void SmartTrafficLight::cycle() {
+  if (m_realTime) {
+    configureRealTime();
+  }
+  startPhaseEngine();
+
   while (!m_stopFlag) {
-    if (current_color == Color::ALERT) {
-      log(LogLevel::DEBUG, "Estado de ALERTA ativo.");
-      generateTraffic();
-      {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        passVehicles();
-      }
-      std::this_thread::sleep_for(std::chrono::seconds(1));
+    const Ticks wake = runPhaseEngine();
+    if (m_realTime) {
+      rt::sleepUntil(std::min(wake, nowTicks() + RT_COMMAND_POLL_MS));
       continue;
     }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_phaseCv.wait_until(lock, deadline(wake), [this] { return m_commandsPending || m_stopFlag; });
+    m_commandsPending = false;
+  }
+
+  log(LogLevel::INFO, "Thread de ciclo finalizada.");
+}
 
-    const auto& [color_str, seconds] = colors_vector[static_cast<size_t>(current_color)];
-    Color initial_color = current_color;
-    time_left = seconds;
-    int count = 0;
-    log(LogLevel::INFO, ToString(current_color));
-    while (time_left > 0 && !m_stopFlag) {
-      if(current_color != initial_color){
+void SmartTrafficLight::startPhaseEngine() {
+  const Ticks start = nowTicks();
+  m_nextTrafficTick = start + TRAFFIC_TICK_MS;
+  m_nextLatenessReport = start + LATENESS_REPORT_MS;
+  if (phase::cycles(current_color) && !enterPlannedPhase(start - phase::Plan::SLACK_MS)) {
+    enterPhase(current_color, start);
+  }
+  publishState();
+  log(LogLevel::INFO, ToString(current_color));
+}
+
+// Aplica os comandos na fila e tudo o que venceu até agora: trocas de fase e
+// ticks de tráfego. Retorna o próximo prazo.
+Ticks SmartTrafficLight::runPhaseEngine() {
+  for (;;) {
+    drainCommands();
+    const auto now = steadyNow();
+    const bool timed = phase::cycles(current_color);
+    if (timed && deadline(m_phaseEnd) <= now) {
+      const uint64_t lateUs = duration_cast<microseconds>(now - deadline(m_phaseEnd)).count();
+      advancePhase();
+      publishState();
+      m_transitionLateness.record(lateUs);
+      m_totalLateness.record(lateUs);
+      m_publishedLateness.write(m_totalLateness);
+      if (logs(LogLevel::INFO)) {
         log(LogLevel::INFO, ToString(current_color));
-        initial_color=current_color;
-      } 
-      log(LogLevel::DEBUG, ToString(current_color) + ": " + std::to_string(time_left) + " segundos");
-      log(LogLevel::DEBUG, "Veículos no semáforo: " + std::to_string(vehicles));
-      generateTraffic();
+      }
+      continue;
+    }
+    if (deadline(m_nextTrafficTick) <= now) {
+      trafficTick();
+      m_nextTrafficTick += TRAFFIC_TICK_MS;
+      publishState();
+      continue;
+    }
+    return timed ? std::min(m_phaseEnd, m_nextTrafficTick) : m_nextTrafficTick;
+  }
+}
 
-      if (current_color != Color::RED) {
-        if (current_color == Color::GREEN && count == 0) {
-          full_cicle_vehicles_quantity = 0;
-        }
-        if (vehicles > 0 && count >= 2) {
-          std::lock_guard<std::mutex> lock(m_mutex);
-          passVehicles();
-        } else {
-          count++;
-        }
+// Simulação: o motor de fases como evento do m_scheduler no prazo seguinte. Um
+// lote de comandos antecipa o passo para já.
+void SmartTrafficLight::schedulePhaseStep(Ticks wake) {
+  m_phaseStepEvent = m_scheduler.schedule(ndn::time::milliseconds(std::max<Ticks>(wake - nowTicks(), 0)),
+                                          [this] { schedulePhaseStep(runPhaseEngine()); });
+}
+
+// Fase seguinte à que terminou em m_phaseEnd: a do plano do orquestrador, se ele
+// a cobre, ou a do ciclo com as durações em vigor.
+void SmartTrafficLight::advancePhase() {
+  const Ticks phaseEnd = m_phaseEnd;
+  if (!enterPlannedPhase(phaseEnd)) {
+    current_color = phase::next(current_color);
+    m_phaseEnd = phaseEnd + std::max<Ticks>(m_durations.of(current_color), TRAFFIC_TICK_MS);
+  }
+  m_phaseTicks = 0;
+}
+
+// Começa uma fase de `color` com a duração em vigor.
+void SmartTrafficLight::enterPhase(Color color, Ticks start) {
+  current_color = color;
+  m_phaseEnd = start + std::max<Ticks>(m_durations.of(color), TRAFFIC_TICK_MS);
+  m_phaseTicks = 0;
+}
+
+Ticks SmartTrafficLight::remainingMs(Ticks now) const {
+  return phase::cycles(current_color) ? std::max<Ticks>(m_phaseEnd - now, 0) : 0;
+}
+
+// Um segundo de tráfego: chegam veículos e, fora do vermelho e passados os dois
+// primeiros segundos da fase, alguns passam.
+void SmartTrafficLight::trafficTick() {
+  generateTraffic();
+  if (current_color == Color::ALERT) {
+    if (logs(LogLevel::DEBUG)) {
+      log(LogLevel::DEBUG, "Estado de ALERTA ativo.");
+    }
+    passVehicles();
+  } else {
+    if (logs(LogLevel::DEBUG)) {
+      log(LogLevel::DEBUG, ToString(current_color) + ": " + std::to_string(remainingMs(nowTicks())) + " ms");
+      log(LogLevel::DEBUG, "Veículos no semáforo: " + std::to_string(vehicles));
+    }
+    if (current_color != Color::RED) {
+      if (current_color == Color::GREEN && m_phaseTicks == 0) {
+        full_cicle_vehicles_quantity = 0;
+      }
+      if (vehicles > 0 && m_phaseTicks >= 2) {
+        passVehicles();
       } else {
-        count = 0;
+        m_phaseTicks++;
       }
-
-      time_left--;
-      std::this_thread::sleep_for(std::chrono::seconds(1));
+    } else {
+      m_phaseTicks = 0;
     }
+  }
+  m_trafficStats.ticks++;
+  m_trafficStats.queueSum += static_cast<uint64_t>(vehicles);
+  m_trafficStats.maxQueue = std::max(m_trafficStats.maxQueue, vehicles);
+  if (m_nextTrafficTick >= m_nextLatenessReport) {
+    reportTransitionLateness();
+    m_nextLatenessReport += LATENESS_REPORT_MS;
+  }
+}
 
-    // Troca de cor
-    switch (current_color) {
-      case Color::GREEN:  current_color = Color::YELLOW; break;
-      case Color::YELLOW: current_color = Color::RED;    break;
-      case Color::RED:    current_color = Color::GREEN;  break;
-      default: break;
-    }
+// Chamada na thread de ciclo. Cada ajuste recusado vai ao log e o ciclo segue
+// sem ele.
+void SmartTrafficLight::configureRealTime() {
+  std::string error;
+  if (m_realTimeCpu >= 0 && !rt::pinToCpu(m_realTimeCpu, error)) {
+    log(LogLevel::ERROR, "Modo tempo real: " + error);
   }
+  if (!rt::setFifoPriority(RT_PRIORITY, error)) {
+    log(LogLevel::ERROR, "Modo tempo real: " + error);
+  }
+  rt::prefaultStack(RT_STACK_PREFAULT_BYTES);
+  log(LogLevel::INFO, "Thread de ciclo em modo tempo real (núcleo " + std::to_string(m_realTimeCpu) +
+                      ", SCHED_FIFO " + std::to_string(RT_PRIORITY) + ").");
+}
 
-  log(LogLevel::INFO, "Thread de ciclo finalizada.");
+void SmartTrafficLight::publishState() {
+  m_state.write(LightSnapshot{current_color, m_phaseEnd, vehicles, full_cicle_vehicles_quantity, m_plan});
+}
+
+// Atraso das trocas de fase na última janela: quanto a thread acordou depois do
+// prazo. Mede o escalonamento do sistema, não a rede.
+void SmartTrafficLight::reportTransitionLateness() {
+  if (m_transitionLateness.count() > 0 && logs(LogLevel::INFO)) {
+    log(LogLevel::INFO, "Trocas de fase: " + std::to_string(m_transitionLateness.count()) +
+                        ", atraso p50 " + std::to_string(m_transitionLateness.percentile(0.5)) +
+                        " µs, p99 " + std::to_string(m_transitionLateness.percentile(0.99)) +
+                        " µs, máx " + std::to_string(m_transitionLateness.max()) + " µs.");
+  }
+  m_transitionLateness.reset();
 }
 
 
@@ -129,37 +292,69 @@ void SmartTrafficLight::passVehicles(){
     int vehicles_to_pass = std::min(vehicles, columns);
     vehicles_to_pass = generateNumber(0, vehicles_to_pass);
     vehicles -= vehicles_to_pass;
-    log(LogLevel::DEBUG, "Veículos passaram: " + std::to_string(vehicles_to_pass));
+    m_trafficStats.departures += static_cast<uint64_t>(vehicles_to_pass);
+    if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Veículos passaram: " + std::to_string(vehicles_to_pass));
+    }
 }
 
-float SmartTrafficLight::calculatePriority() {
-    float basePriority = full_cicle_vehicles_quantity * 0.5f
-                         + (static_cast<float>(vehicles) / capacity) * 5;
-
-    log(LogLevel::DEBUG, "Prioridade: " + std::to_string(basePriority));
+float SmartTrafficLight::calculatePriority(const LightSnapshot& state) const {
+    float basePriority = state.fullCycleVehicles * 0.5f
+                         + (static_cast<float>(state.vehicles) / capacity) * 5;
     return basePriority;
 }
 
+// A sequência conta os Data de estado assinados: quem chama a avança a cada
+// resposta que não sai do cache (chave nova, frescor vencido ou pedido /txt) e a
+// cada notificação push. Um reenvio do cache repete a sequência do Data
+// reenviado, e dois Data com o mesmo estado podem ter sequências diferentes.
+// `state` é o publicado pela thread de ciclo, lido sem locks.
+status::StatusReport SmartTrafficLight::currentStatus(const LightSnapshot& state) {
+    status::StatusReport report;
+    report.phase = state.color;
+    report.remainingMs = phase::cycles(state.color)
+                         ? static_cast<uint32_t>(std::max<Ticks>(state.phaseEnd - nowTicks(), 0)) : 0;
+    report.priority = calculatePriority(state);
+    report.queueLength = static_cast<uint16_t>(std::max(state.vehicles, 0));
+    report.sequence = m_statusSeq;
+    if (m_centralClock.synchronized()) {
+        const Ticks now = nowTicks();
+        report.clockOffsetMs = std::llround(m_centralClock.offsetAt(now));
+        report.clockErrorMs = static_cast<uint16_t>(
+            std::min(m_centralClock.errorBoundMs(now), static_cast<int>(status::CLOCK_UNSYNCED) - 1));
+        if (phase::cycles(state.color)) {
+            report.phaseEnd = m_centralClock.toRemote(state.phaseEnd);
+        }
+    }
+    if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Prioridade: " + std::to_string(report.priority));
+    }
+    return report;
+}
+
 int SmartTrafficLight::generateNumber(int min, int max) {
-    static std::mt19937 rng(std::chrono::system_clock::now().time_since_epoch().count());
     std::uniform_int_distribution<int> dist(min, max);
-    return dist(rng);
+    return dist(m_rng);
 }
 
 void SmartTrafficLight::generateTraffic() {
     if (generateNumber(1, 10) < static_cast<int>(intensity) && vehicles < capacity) {
         vehicles++;
         full_cicle_vehicles_quantity++;
+        m_trafficStats.arrivals++;
     }
 }
 
 
 void SmartTrafficLight::runConsumer() {
-    m_scheduler.schedule(1000_ms, [this] {
-        auto interestCommand = createInterest(central + "/command"+prefix_, true, false, 4000_ms);
-        sendInterest(interestCommand);
-        runConsumer();
-    });
+    // Long-poll: sempre há exatamente um Interest de comando pendente no
+    // orquestrador, que o retém até ter um comando. Um novo é expresso assim que
+    // o anterior é respondido ou expira.
+    ndn::Name name(central + "/command" + prefix_);
+    name.appendSequenceNumber(++m_commandInterestSeq);
+    auto interestCommand = createInterest(name, true, false, COMMAND_INTEREST_LIFETIME);
+    m_commandInterestSentAt = nowTicks();
+    sendInterest(interestCommand);
 }
 
 void SmartTrafficLight::runProducer(const std::string& suffix){
@@ -172,33 +367,199 @@ void SmartTrafficLight::runProducer(const std::string& suffix){
       [this](const ndn::Name& nameSuffix, const std::string& reason) {
         this->onRegisterFailed(nameSuffix, reason);
       });
+  // O certificado fica em /<identidade>/KEY, que é /<semáforo>/KEY quando a
+  // identidade tem o nome do semáforo, como o trust schema padrão exige.
   auto cert = m_keyChain.getPib().getDefaultIdentity().getDefaultKey().getDefaultCertificate();
-  m_certServeHandle = m_face.setInterestFilter(security::extractIdentityFromCertName(cert.getName()),
-                                                [this, cert] (auto&&...) {
-                                                  m_face.put(cert);
+  m_certPrefix = security::extractIdentityFromCertName(cert.getName()).append(status::CERT_COMPONENT);
+  m_certServeHandle = m_face.setInterestFilter(m_certPrefix,
+                                                [this, cert] (const ndn::InterestFilter&, const ndn::Interest& interest) {
+                                                  if (interest.matchesData(cert)) {
+                                                    m_face.put(cert);
+                                                  }
                                                 },
                                                 std::bind(&SmartTrafficLight::onRegisterFailed, this, _1, _2));
 }
 
 void SmartTrafficLight::onInterest(const ndn::Interest& interest) {
-    log(LogLevel::DEBUG, "Recebeu Interest para: " + interest.getName().toUri());
+    if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Recebeu Interest para: " + interest.getName().toUri());
+    }
+
+    const auto& name = interest.getName();
+    if (name.size() > m_certPrefix.size() && m_certPrefix.isPrefixOf(name)) {
+        return;     // busca do certificado pelo nome da chave: é do filtro do certificado
+    }
+    if (!name.empty() && name.get(-1).toUri() == status::TIMING_COMPONENT) {
+        replyTiming(interest);
+        return;
+    }
+    if (!name.empty() && name.get(-1).toUri() == status::CERT_COMPONENT) {
+        replyCertificate(interest);
+        return;
+    }
+    const LightSnapshot state = m_state.read();
+    status::StatusReport report = currentStatus(state);
 
-    std::string currentStateStr = ToString(current_color); 
-    int remainingMs = time_left * 1000; 
-    float priority = calculatePriority();
+    auto data = std::make_shared<ndn::Data>(interest.getName());
+    if (!name.empty() && name.get(-1).toUri() == status::TEXT_COMPONENT) {
+        report.sequence = ++m_statusSeq;
+        data->setContent(std::string_view(status::encodeText(report)));
+    } else {
+        // O tempo restante muda a cada consulta e fica fora da chave: a resposta
+        // reaproveitada o traz de quando foi assinada, e o orquestrador usa o fim
+        // absoluto da fase (StatusCodec.hpp). Sem sincronia só há o tempo
+        // restante, e a resposta é sempre assinada de novo.
+        const auto now = steadyNow();
+        const bool reusable = report.clockErrorMs != status::CLOCK_UNSYNCED;
+        const status::ReplyKey key = status::replyKey(report, state.phaseEnd);
+        reportStatusCache(now);
+        if (auto cached = reusable ? m_statusCache.find(name, key, now) : nullptr) {
+            m_face.put(*cached);
+            return;
+        }
+        report.sequence = ++m_statusSeq;
+        status::StatusBuffer buffer;
+        const size_t length = status::encode(report, buffer);
+        data->setContent(ndn::make_span(buffer.data(), length));
+        data->setFreshnessPeriod(ndn::time::seconds(1));
+        m_signer.sign(*data, m_centralLink);
+        if (reusable) {
+            m_statusCache.insert(data, key, now);
+        }
+        m_face.put(*data);
+        return;
+    }
+    data->setFreshnessPeriod(ndn::time::seconds(1));
 
-    std::ostringstream oss;
-    oss << currentStateStr << "|" << remainingMs << "|" << priority;
+    m_signer.sign(*data, m_centralLink);
+    m_face.put(*data);
 
-    std::string content = oss.str();
+}
+
+// Histograma acumulado do atraso das trocas de fase, lido sem locks do que a
+// thread de ciclo publica a cada troca.
+void SmartTrafficLight::replyTiming(const ndn::Interest& interest) {
+    static_assert(status::TIMING_BUCKETS == LatencyHistogram::BUCKETS);
+    const LatencyHistogram lateness = m_publishedLateness.read();
+    status::TimingReport report;
+    report.realTime = m_realTime;
+    report.maxLatenessUs = lateness.max();
+    for (size_t b = 0; b < status::TIMING_BUCKETS; ++b) {
+        report.buckets[b] = static_cast<uint32_t>(lateness.bucket(b));
+    }
+    status::TimingBuffer buffer;
+    const size_t length = status::encodeTiming(report, buffer);
 
     auto data = std::make_shared<ndn::Data>(interest.getName());
-    data->setContent(ndn::make_span(reinterpret_cast<const uint8_t*>(content.data()), content.size()));
+    data->setContent(ndn::make_span(buffer.data(), length));
     data->setFreshnessPeriod(ndn::time::seconds(1));
+    m_signer.sign(*data, m_centralLink);
+    m_face.put(*data);
+}
+
+// Thread de I/O: a cada 60 s, quantas respostas de estado saíram do cache sem
+// nova assinatura.
+void SmartTrafficLight::reportStatusCache(steady_clock::time_point now) {
+    if (now < m_nextCacheReport) {
+        return;
+    }
+    const bool first = m_nextCacheReport == steady_clock::time_point{};
+    m_nextCacheReport = now + milliseconds(LATENESS_REPORT_MS);
+    const uint64_t hits = m_statusCache.hits() - m_reportedCacheHits;
+    const uint64_t misses = m_statusCache.misses() - m_reportedCacheMisses;
+    m_reportedCacheHits = m_statusCache.hits();
+    m_reportedCacheMisses = m_statusCache.misses();
+    if (first || !logs(LogLevel::INFO)) {
+        return;
+    }
+    const uint64_t total = hits + misses;
+    log(LogLevel::INFO, "Respostas de estado: " + std::to_string(total) + ", " + std::to_string(hits) +
+                        " do cache (" + std::to_string(total ? hits * 100 / total : 0) + "% sem nova assinatura).");
+}
 
-    m_keyChain.sign(*data);
+// O Data só transporta o certificado; quem o usa o valida pela cadeia até a âncora.
+void SmartTrafficLight::replyCertificate(const ndn::Interest& interest) {
+    const auto cert = m_keyChain.getPib().getDefaultIdentity().getDefaultKey().getDefaultCertificate();
+    auto data = std::make_shared<ndn::Data>(interest.getName());
+    data->setContent(cert.wireEncode());
+    data->setFreshnessPeriod(ndn::time::seconds(10));
+    m_signer.sign(*data, m_centralLink);
     m_face.put(*data);
+}
+
+void SmartTrafficLight::scheduleStatusCheck() {
+    m_statusCheckEvent = m_scheduler.schedule(STATUS_CHECK_INTERVAL, [this] {
+        checkStatusReport();
+        scheduleStatusCheck();
+    });
+}
 
+void SmartTrafficLight::checkStatusReport() {
+    // Notifica só o que o orquestrador não consegue prever: troca de fase,
+    // variação relevante de prioridade, ou o heartbeat que prova que o nó vive.
+    const LightSnapshot state = m_state.read();
+    bool phaseChanged = (m_protocol.statusMode == StatusMode::PREDICT) ? deviatesFromPrediction(state)
+                                                                       : state.color != m_lastReportedColor;
+    bool priorityChanged = std::abs(calculatePriority(state) - m_lastReportedPriority) >= m_protocol.priorityReportDelta;
+    bool heartbeatDue = steadyNow() - m_lastReportTime >= milliseconds(m_protocol.heartbeatMs);
+    if (!phaseChanged && !priorityChanged && !heartbeatDue && !m_reportPending) {
+        return;
+    }
+    status::StatusReport report = currentStatus(state);
+    report.sequence = ++m_statusSeq;
+    sendStatusReport(report);
+}
+
+// Modo predict: o orquestrador avança a última fase notificada pelas durações
+// padrão. Uma troca de fase só é notificada se a fase ou o seu fim fugirem
+// dessa previsão além da tolerância.
+bool SmartTrafficLight::deviatesFromPrediction(const LightSnapshot& state) {
+    const Ticks now = nowTicks();
+    phase::advance(m_predictedColor, m_predictedEnd, now, m_defaultDurations, state.plan);
+    if (state.color != m_predictedColor) {
+        return true;
+    }
+    if (!phase::cycles(state.color)) {
+        return false;
+    }
+    return std::abs(state.phaseEnd - m_predictedEnd) > m_protocol.predictionToleranceMs;
+}
+
+void SmartTrafficLight::sendStatusReport(const status::StatusReport& report) {
+    // Interest assinado para /central/status/<semáforo>/<seq>; o estado vai nos
+    // ApplicationParameters e o orquestrador responde com um Data vazio.
+    ndn::Name name(central + "/status" + prefix_);
+    name.appendSequenceNumber(report.sequence);
+    ndn::Interest interest(name);
+    interest.setMustBeFresh(true);
+    interest.setCanBePrefix(false);
+    interest.setInterestLifetime(STATUS_REPORT_LIFETIME);
+
+    status::StatusBuffer buffer;
+    size_t length = status::encode(report, buffer);
+    interest.setApplicationParameters(ndn::make_span(buffer.data(), length));
+    m_signer.sign(interest, m_centralLink);
+
+    m_lastReportedColor = report.phase;
+    m_lastReportedPriority = report.priority;
+    m_lastReportTime = steadyNow();
+    m_predictedColor = report.phase;
+    m_predictedEnd = nowTicks() + static_cast<Ticks>(report.remainingMs);
+    m_reportPending = false;
+
+    m_face.expressInterest(interest,
+        [this](const ndn::Interest&, const ndn::Data&) {},
+        [this](const ndn::Interest& i, const ndn::lp::Nack& nack) {
+            std::stringstream ss;
+            ss << "NACK na notificação de estado " << i.getName().toUri() << ". Motivo: " << nack.getReason();
+            log(LogLevel::ERROR, ss.str());
+            m_reportPending = true;
+        },
+        [this](const ndn::Interest& i) {
+            log(LogLevel::ERROR, "Timeout na notificação de estado " + i.getName().toUri());
+            m_reportPending = true;
+        });
+    log(LogLevel::DEBUG, "Notificando estado: " + name.toUri());
 }
 
 ndn::Interest SmartTrafficLight::createInterest(const ndn::Name& name, bool mustBeFresh, bool canBePrefix, ndn::time::milliseconds lifetime) {
@@ -210,10 +571,7 @@ ndn::Interest SmartTrafficLight::createInterest(const ndn::Name& name, bool must
 }
 
 void SmartTrafficLight::sendInterest(const ndn::Interest& interest) {
-  {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    lastInterestTimestamp_= std::chrono::steady_clock::now();
-  }
+  lastInterestTimestamp_= steadyNow();
   m_face.expressInterest(interest,
                         std::bind(&SmartTrafficLight::onData, this, std::placeholders::_1, std::placeholders::_2),
                         std::bind(&SmartTrafficLight::onNack, this, std::placeholders::_1, std::placeholders::_2),
@@ -223,155 +581,248 @@ void SmartTrafficLight::sendInterest(const ndn::Interest& interest) {
 
 
 void SmartTrafficLight::onData(const ndn::Interest& interest, const ndn::Data& data) {
-    auto now = std::chrono::steady_clock::now();
-    const auto content = std::string(reinterpret_cast<const char*>(data.getContent().value()), data.getContent().value_size());
-    const auto DUPLICATION_WINDOW = std::chrono::seconds(4);
+    // Só a resposta ao Interest pendente tem o t1 conhecido.
+    const Ticks arrival = nowTicks();
+    const auto& last = interest.getName().get(-1);
+    const Ticks sentAt = (last.isSequenceNumber() && last.toSequenceNumber() == m_commandInterestSeq)
+                         ? m_commandInterestSentAt : 0;
+    runConsumer();
+    m_verifier.verify(data, m_centralLink,
+        [this, data, sentAt, arrival] { acceptCommands(data, sentAt, arrival); },
+        [this, name = data.getName()](const std::string& reason) {
+            log(LogLevel::ERROR, "Lote de comandos rejeitado (" + reason + "): " + name.toUri());
+        });
+}
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    if (!content.empty() && content == m_lastCommandContent && (now - m_lastCommandTimestamp) < DUPLICATION_WINDOW) {
-        return; 
-    }
-    
-    
-    if (!content.empty()) {
-        m_lastCommandContent = content;
-        m_lastCommandTimestamp = now;
-    }
+void SmartTrafficLight::acceptCommands(const ndn::Data& data, Ticks sentAt, Ticks arrival) {
+    const auto& content = data.getContent();
 
     if (m_timeoutCounter > 0) {
         log(LogLevel::DEBUG, "Contador de timeout zerado após comunicação bem-sucedida.");
         m_timeoutCounter = 0;
     }
 
-    log(LogLevel::DEBUG, "Recebeu Data de: " + data.getName().toUri());
-    std::vector<Command> commands = parseContent(content);
-    for (const auto& cmd : commands) {
-        if(!applyCommand(cmd))
-            break;
+    if (content.value_size() == 0) {
+        return;
     }
-}
-
-std::vector<Command> SmartTrafficLight::parseContent(const std::string& rawCommand) {
-    std::vector<Command> commands;
-    std::istringstream ss(rawCommand);
-    std::string commandStr;
 
-    // Ignora o primeiro caractere se for um delimitador
-    if (!ss.str().empty() && ss.str()[0] == ';') {
-        ss.ignore(1);
+    auto batch = command::decode(std::span<const uint8_t>(content.value(), content.value_size()));
+    if (!batch) {
+        log(LogLevel::ERROR, "Lote de comandos malformado em " + data.getName().toUri());
+        return;
+    }
+    if (batch->sentAt != 0) {
+        if (sentAt != 0) {
+            m_centralClock.addSample(sentAt, batch->receivedAt, batch->sentAt, arrival);
+            std::stringstream ss;
+            ss << "Relógio central: offset " << m_centralClock.offsetAt(arrival) << " ms, erro <= "
+               << m_centralClock.errorBoundMs(arrival) << " ms, skew " << m_centralClock.skewPpm() << " ppm";
+            log(LogLevel::DEBUG, ss.str());
+        }
+        m_lastCentralSentAt = batch->sentAt;
+        m_lastCentralArrival = arrival;
     }
+    if (batch->empty()) {
+        return;
+    }
+    if (batch->sequence <= m_lastCommandSeq) {
+        log(LogLevel::DEBUG, "Lote de comandos duplicado ignorado (seq " + std::to_string(batch->sequence) + ").");
+        return;
+    }
+    m_lastCommandSeq = batch->sequence;
 
-    while (std::getline(ss, commandStr, ';')) {
-        if (commandStr.empty()) continue;
-        auto sep = commandStr.find(':');
-        if (sep == std::string::npos)
-            continue;
+    log(LogLevel::DEBUG, "Recebeu Data de: " + data.getName().toUri() + " " + command::toString(*batch));
+    // O relógio central é desta thread: os instantes saem daqui já locais.
+    for (uint8_t i = 0; i < batch->count; ++i) {
+        if (batch->items[i].op == CommandOp::SET_PHASE_END) {
+            batch->items[i].value = correctCentralTime(batch->items[i].value);
+        }
+    }
+    for (uint8_t i = 0; i < batch->plan.count; ++i) {
+        batch->plan.entries[i].end = correctCentralTime(batch->plan.entries[i].end);
+    }
+    enqueueCommands(*batch);
+    // Os comandos mudam fase e durações fora do modelo comum: o próximo estado
+    // notificado volta a ancorar a previsão do orquestrador.
+    if (m_protocol.statusMode == StatusMode::PREDICT) {
+        m_reportPending = true;
+    }
+}
 
-        Command cmd;
-        cmd.type = commandStr.substr(0, sep);
-        cmd.value = commandStr.substr(sep + 1);
-        commands.push_back(cmd);
+// Entrega o lote à thread de ciclo, que o aplica ao acordar; a thread de I/O
+// não espera pelo ciclo nem o ciclo por ela.
+void SmartTrafficLight::enqueueCommands(const CommandBatch& batch) {
+    if (!m_commandQueue.push(batch)) {
+        log(LogLevel::ERROR, "Fila de comandos cheia; lote " + std::to_string(batch.sequence) + " descartado.");
+        return;
+    }
+    if (m_simulated) {
+        schedulePhaseStep(nowTicks());
+        return;
+    }
+    if (m_realTime) {
+        return;     // a thread de ciclo consulta a fila a cada fatia de sono
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commandsPending = true;
     }
+    m_phaseCv.notify_one();
+}
 
-    return commands;
+void SmartTrafficLight::drainCommands() {
+    CommandBatch batch;
+    bool applied = false;
+    while (m_commandQueue.pop(batch)) {
+        for (const auto& cmd : batch) {
+            if(!applyCommand(cmd))
+                break;
+        }
+        if (!batch.plan.empty()) {
+            applyPlan(batch.plan);
+        }
+        applied = true;
+    }
+    if (applied) {
+        publishState();
+    }
 }
 
 bool SmartTrafficLight::applyCommand(const Command& cmd) {
-  if (cmd.type.empty()) return false;
-  if (cmd.type == "set_state") {
-      Color new_color = parseColor(cmd.value);
+  switch (cmd.op) {
+    case CommandOp::SET_STATE: {
+      if (cmd.value < 0 || cmd.value > static_cast<int32_t>(Color::UNKNOWN)) return false;
+      Color new_color = static_cast<Color>(cmd.value);
+      if (new_color == Color::ALERT) {
+        m_plan.clear();
+      }
       if (new_color != current_color) {
-        current_color = new_color;
-        log(LogLevel::DEBUG, "Cor alterada para " + cmd.value);
+        // Saindo do ALERTA a fase começa agora; entre fases do ciclo o fim é mantido.
+        if (phase::cycles(new_color) && !phase::cycles(current_color)) {
+          enterPhase(new_color, nowTicks());
+        } else {
+          current_color = new_color;
+        }
+        if (logs(LogLevel::DEBUG)) {
+          log(LogLevel::DEBUG, "Cor alterada para " + ToString(new_color));
+        }
       }
-  }else if (cmd.type == "set_time") {
-      int newTime;
-      if (cmd.value == "DEFAULT") {
-          newTime = getDefaultColorTime(current_color);
-      } else {
-          newTime = std::stoi(cmd.value);
+      break;
+    }
+    case CommandOp::SET_TIME:
+    case CommandOp::SET_TIME_DEFAULT: {
+      // Duração da cor atual; o operando de SET_TIME é em segundos.
+      if (!phase::cycles(current_color)) {
+        break;
       }
-      if (current_color == Color::ALERT){
-          time_left = newTime;
+      const size_t slot = static_cast<size_t>(current_color);
+      m_durations.ms[slot] = (cmd.op == CommandOp::SET_TIME_DEFAULT) ? m_defaultDurations.ms[slot]
+                                                                      : static_cast<int>(cmd.value) * 1000;
+      break;
+    }
+    case CommandOp::SET_DEFAULT_DURATION:
+      m_durations = m_defaultDurations;
+      if (logs(LogLevel::INFO)) {
+        log(LogLevel::INFO, "Durações de ciclo reconfiguradas para o padrão inicial.");
       }
-      updateColorVectorTime(current_color, newTime);
-  }else if (cmd.type == "set_default_duration"){
-      updateColorVectorTime(Color::GREEN, getDefaultColorTime(Color::GREEN));
-      updateColorVectorTime(Color::YELLOW, getDefaultColorTime(Color::YELLOW));
-      updateColorVectorTime(Color::RED, getDefaultColorTime(Color::RED));
-      log(LogLevel::INFO, "Durações de ciclo reconfiguradas para o padrão inicial.");
-  }
-  else if (cmd.type == "set_green_duration"){
-      int newTime = std::stoi(cmd.value)/1000;
-      updateColorVectorTime(Color::GREEN, newTime);
-      log(LogLevel::DEBUG, "Tempo verde alterado para " + std::to_string(newTime));
-  }
-  else if (cmd.type == "set_red_duration"){
-      int newTime = std::stoi(cmd.value)/1000;
-      updateColorVectorTime(Color::RED, newTime);
-      log(LogLevel::DEBUG, "Tempo vermelho alterado para " + std::to_string(newTime));
-  }
-  else if (cmd.type == "increase_green_duration"){
-      size_t index = static_cast<size_t>(Color::GREEN);
-      int increment = std::stoi(cmd.value)/1000;
-      colors_vector[index].second += increment;
-      log(LogLevel::DEBUG, "Duração do VERDE aumentada em " + std::to_string(increment) + "s. Nova duração: " + std::to_string(colors_vector[index].second) + "s.");
-  }
-  else if (cmd.type == "decrease_green_duration"){
-      size_t index = static_cast<size_t>(Color::GREEN);
-      int decrement = std::stoi(cmd.value)/1000;
-      if (colors_vector[index].second > decrement + 5) {
-          colors_vector[index].second -= decrement;
-          log(LogLevel::DEBUG, "Duração do VERDE diminuída em " + std::to_string(decrement) + "s. Nova duração: " + std::to_string(colors_vector[index].second) + "s.");
+      break;
+    case CommandOp::SET_GREEN_DURATION:
+    case CommandOp::SET_RED_DURATION: {
+      const Color color = (cmd.op == CommandOp::SET_GREEN_DURATION) ? Color::GREEN : Color::RED;
+      m_durations.ms[static_cast<size_t>(color)] = static_cast<int>(cmd.value);
+      if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Duração do " + ToString(color) + " alterada para " + std::to_string(cmd.value) + " ms.");
       }
-  }
-  else if (cmd.type == "increase_red_duration"){
-      size_t index = static_cast<size_t>(Color::RED);
-      int increment = std::stoi(cmd.value)/1000;
-      colors_vector[index].second += increment;
-      log(LogLevel::DEBUG, "Duração do VERMELHO aumentada em " + std::to_string(increment) + "s. Nova duração: " + std::to_string(colors_vector[index].second) + "s.");
-  }
-  else if (cmd.type == "decrease_red_duration"){
-      size_t index = static_cast<size_t>(Color::RED);
-      int decrement = std::stoi(cmd.value)/1000;
-      if (colors_vector[index].second > decrement + 5) {
-          colors_vector[index].second -= decrement;
-          log(LogLevel::DEBUG, "Duração do VERMELHO diminuída em " + std::to_string(decrement) + "s. Nova duração: " + std::to_string(colors_vector[index].second) + "s.");
+      break;
+    }
+    case CommandOp::INCREASE_GREEN_DURATION:
+    case CommandOp::INCREASE_RED_DURATION: {
+      const Color color = (cmd.op == CommandOp::INCREASE_GREEN_DURATION) ? Color::GREEN : Color::RED;
+      int& duration = m_durations.ms[static_cast<size_t>(color)];
+      duration += static_cast<int>(cmd.value);
+      if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Duração do " + ToString(color) + " aumentada em " + std::to_string(cmd.value) +
+                             " ms. Nova duração: " + std::to_string(duration) + " ms.");
       }
-  }
-  else if (cmd.type == "set_current_time"){
-      int newTime = std::stoi(cmd.value); 
-      time_left = newTime / 1000; 
-      log(LogLevel::DEBUG, "Tempo alterado para " + std::to_string(time_left));
-      auto now = std::chrono::steady_clock::now();
-  }
-  else if (cmd.type == "increase_time") {
-      int increment = std::stoi(cmd.value);
-      time_left += increment/1000;
-      log(LogLevel::DEBUG, "Tempo aumentado em " + std::to_string(increment) + "s.");
-  }
-  else if (cmd.type == "decrease_time") {
-      int decrement = std::stoi(cmd.value);
-      time_left -= decrement/1000; 
-      log(LogLevel::DEBUG, "Tempo diminuido em " + std::to_string(decrement) + "s.");
+      break;
+    }
+    case CommandOp::DECREASE_GREEN_DURATION:
+    case CommandOp::DECREASE_RED_DURATION: {
+      const Color color = (cmd.op == CommandOp::DECREASE_GREEN_DURATION) ? Color::GREEN : Color::RED;
+      int& duration = m_durations.ms[static_cast<size_t>(color)];
+      if (duration > cmd.value + MIN_PHASE_DURATION_MS) {
+          duration -= static_cast<int>(cmd.value);
+          if (logs(LogLevel::DEBUG)) {
+            log(LogLevel::DEBUG, "Duração do " + ToString(color) + " diminuída em " + std::to_string(cmd.value) +
+                                 " ms. Nova duração: " + std::to_string(duration) + " ms.");
+          }
+      }
+      break;
+    }
+    case CommandOp::SET_CURRENT_TIME:
+      adjustTime(nowTicks() + cmd.value);
+      break;
+    case CommandOp::INCREASE_TIME:
+      m_phaseEnd += cmd.value;
+      if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Tempo aumentado em " + std::to_string(cmd.value) + "ms.");
+      }
+      break;
+    case CommandOp::DECREASE_TIME:
+      m_phaseEnd -= cmd.value;
+      if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Tempo diminuido em " + std::to_string(cmd.value) + "ms.");
+      }
+      break;
+    case CommandOp::SET_PHASE_END:
+      adjustTime(cmd.value);
+      break;
+    default:
+      return false;
   }
   return true;
 }
 
-void SmartTrafficLight::updateColorVectorTime(Color color, int newTime) {
-    size_t index = static_cast<size_t>(color);
-    if (index < colors_vector.size()) {
-        colors_vector[index].second = newTime;
+// O plano, com os fins já no relógio local, substitui o anterior e vale já: a
+// fase atual passa a ser a do plano que contém o instante presente.
+void SmartTrafficLight::applyPlan(const phase::Plan& plan) {
+    m_plan = plan;
+    enterPlannedPhase(nowTicks() - phase::Plan::SLACK_MS);
+    if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Plano com " + std::to_string(plan.count) + " fases; fase atual " +
+                             ToString(current_color) + ", " + std::to_string(remainingMs(nowTicks())) + " ms.");
+    }
+}
+
+// Entra na fase do plano que segue uma fase terminada em `phaseEnd`; false se o
+// plano não a cobre.
+bool SmartTrafficLight::enterPlannedPhase(Ticks phaseEnd) {
+    const phase::PlanEntry* entry = m_plan.after(phaseEnd);
+    if (!entry) {
+        return false;
+    }
+    current_color = entry->color;
+    m_phaseEnd = entry->end;
+    m_phaseTicks = 0;
+    return true;
+}
+
+// Instante do relógio do orquestrador convertido para o relógio local. Sem
+// amostra válida, supõe atraso nulo desde o envio da última resposta.
+Ticks SmartTrafficLight::correctCentralTime(Ticks centralTime) {
+    if (m_centralClock.synchronized()) {
+        return m_centralClock.toLocal(centralTime, nowTicks());
     }
+    return m_lastCentralArrival + (centralTime - m_lastCentralSentAt);
 }
 
-int SmartTrafficLight::getDefaultColorTime(Color color) const {
-    size_t index = static_cast<size_t>(color);
-    if (index < default_colors_vector.size()) {
-        return default_colors_vector[index].second;
+// A fase atual termina em `phaseEnd` (relógio local); um fim já passado troca a
+// fase assim que a thread de ciclo acordar.
+void SmartTrafficLight::adjustTime(Ticks phaseEnd) {
+    m_phaseEnd = phaseEnd;
+    if (logs(LogLevel::DEBUG)) {
+        log(LogLevel::DEBUG, "Fim da fase em " + std::to_string(remainingMs(nowTicks())) + " ms.");
     }
-    return 10;
 }
 
 void SmartTrafficLight::onNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) {
@@ -379,30 +830,38 @@ void SmartTrafficLight::onNack(const ndn::Interest& interest, const ndn::lp::Nac
   ss << "NACK para " << interest.getName().toUri() << ". Motivo: " << nack.getReason();
   log(LogLevel::ERROR, ss.str());
 
-  std::lock_guard<std::mutex> lock(m_mutex);
-  current_color = Color::ALERT;
   log(LogLevel::INFO, "Entrando em modo de ALERTA devido a NACK na comunicação.");
+  enterAlert();
+  m_scheduler.schedule(NACK_RETRY_DELAY, [this] { runConsumer(); });
 }
 
 void SmartTrafficLight::onTimeout(const ndn::Interest& interest) {
   log(LogLevel::ERROR, "Timeout para " + interest.getName().toUri());
+  runConsumer();
 
-  std::lock_guard<std::mutex> lock(m_mutex);
   m_timeoutCounter++;
   log(LogLevel::DEBUG, "Contador de timeout: " + std::to_string(m_timeoutCounter));
 
   if (m_timeoutCounter >= TIMEOUT_THRESHOLD) {
-    if (current_color != Color::ALERT) {
-      current_color = Color::ALERT;
+    if (m_state.read().color != Color::ALERT) {
       log(LogLevel::INFO, "Entrando em modo de ALERTA após " + std::to_string(TIMEOUT_THRESHOLD) + " timeouts consecutivos.");
+      enterAlert();
     }
   }
 }
 
+// O ALERTA local passa pela mesma fila dos comandos do orquestrador.
+void SmartTrafficLight::enterAlert() {
+  CommandBatch batch;
+  batch.push(CommandOp::SET_STATE, Color::ALERT);
+  enqueueCommands(batch);
+}
+
 void SmartTrafficLight::onRegisterFailed(const ndn::Name& nome, const std::string& reason) {
   log(LogLevel::ERROR, "Falha CRÍTICA ao registrar prefixo: " + nome.toUri() + ". Motivo: " + reason);
   log(LogLevel::ERROR, "Não é possível continuar. Encerrando a aplicação.");
 
-  m_stopFlag = true; 
+  m_stopFlag = true;
+  m_phaseCv.notify_all();
   m_face.shutdown();
 }
\ No newline at end of file
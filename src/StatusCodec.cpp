@@ -0,0 +1,248 @@
+#include "../include/StatusCodec.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <sstream>
+
+namespace status {
+
+namespace {
+
+template <typename T>
+uint8_t* writeField(uint8_t* pos, uint8_t type, T value) {
+  *pos++ = type;
+  *pos++ = static_cast<uint8_t>(sizeof(T));
+  for (size_t i = sizeof(T); i > 0; --i) {
+    *pos++ = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * (i - 1)));
+  }
+  return pos;
+}
+
+template <typename T>
+bool readField(const uint8_t*& pos, uint8_t type, T& value) {
+  if (pos[0] != type || pos[1] != sizeof(T)) {
+    return false;
+  }
+  uint64_t v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    v = (v << 8) | pos[2 + i];
+  }
+  value = static_cast<T>(v);
+  pos += 2 + sizeof(T);
+  return true;
+}
+
+} // namespace
+
+size_t encode(const StatusReport& report, StatusBuffer& out) {
+  uint8_t* pos = out.data();
+  *pos++ = tlv::StatusPayload;
+  *pos++ = static_cast<uint8_t>(STATUS_VALUE_SIZE);
+  pos = writeField<uint8_t>(pos, tlv::Version, STATUS_VERSION);
+  pos = writeField<uint8_t>(pos, tlv::Phase, static_cast<uint8_t>(report.phase));
+  pos = writeField<uint32_t>(pos, tlv::RemainingMs, report.remainingMs);
+  pos = writeField<uint32_t>(pos, tlv::Priority, std::bit_cast<uint32_t>(report.priority));
+  pos = writeField<uint16_t>(pos, tlv::QueueLength, report.queueLength);
+  pos = writeField<uint64_t>(pos, tlv::Sequence, report.sequence);
+  pos = writeField<uint64_t>(pos, tlv::ClockOffset, static_cast<uint64_t>(report.clockOffsetMs));
+  pos = writeField<uint16_t>(pos, tlv::ClockError, report.clockErrorMs);
+  pos = writeField<uint64_t>(pos, tlv::PhaseEnd, static_cast<uint64_t>(report.phaseEnd));
+  return static_cast<size_t>(pos - out.data());
+}
+
+bool isBinary(std::span<const uint8_t> wire) {
+  return !wire.empty() && wire[0] == tlv::StatusPayload;
+}
+
+std::optional<StatusReport> decode(std::span<const uint8_t> wire) {
+  // Versões futuras podem ser maiores; os campos da v1 continuam no início.
+  if (wire.size() < 2 + STATUS_V1_VALUE_SIZE || wire[0] != tlv::StatusPayload ||
+      wire[1] < STATUS_V1_VALUE_SIZE || wire.size() < size_t(2) + wire[1]) {
+    return std::nullopt;
+  }
+
+  const uint8_t* pos = wire.data() + 2;
+  uint8_t version = 0;
+  uint8_t phase = 0;
+  uint32_t priorityBits = 0;
+  StatusReport report;
+  if (!readField(pos, tlv::Version, version) || version < 1 ||
+      !readField(pos, tlv::Phase, phase) || phase > static_cast<uint8_t>(Color::UNKNOWN) ||
+      !readField(pos, tlv::RemainingMs, report.remainingMs) ||
+      !readField(pos, tlv::Priority, priorityBits) ||
+      !readField(pos, tlv::QueueLength, report.queueLength) ||
+      !readField(pos, tlv::Sequence, report.sequence)) {
+    return std::nullopt;
+  }
+  uint64_t offsetBits = 0;
+  if (version >= 2 && wire[1] >= STATUS_V2_VALUE_SIZE) {
+    if (!readField(pos, tlv::ClockOffset, offsetBits) || !readField(pos, tlv::ClockError, report.clockErrorMs)) {
+      return std::nullopt;
+    }
+    report.clockOffsetMs = static_cast<int64_t>(offsetBits);
+  }
+  uint64_t phaseEndBits = 0;
+  if (version >= 3 && wire[1] >= STATUS_VALUE_SIZE) {
+    if (!readField(pos, tlv::PhaseEnd, phaseEndBits)) {
+      return std::nullopt;
+    }
+    report.phaseEnd = static_cast<int64_t>(phaseEndBits);
+  }
+  report.phase = static_cast<Color>(phase);
+  report.priority = std::bit_cast<float>(priorityBits);
+  return report;
+}
+
+std::string encodeText(const StatusReport& report) {
+  std::ostringstream oss;
+  oss << ToString(report.phase) << "|" << report.remainingMs << "|" << report.priority;
+  return oss.str();
+}
+
+std::optional<StatusReport> decodeText(std::string_view text) {
+  auto first = text.find('|');
+  auto second = (first == std::string_view::npos) ? first : text.find('|', first + 1);
+  if (second == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  StatusReport report;
+  report.phase = parseColor(std::string(text.substr(0, first)));
+
+  const char* msBegin = text.data() + first + 1;
+  int remainingMs = 0;
+  if (std::from_chars(msBegin, text.data() + second, remainingMs).ec != std::errc()) {
+    return std::nullopt;
+  }
+  report.remainingMs = remainingMs > 0 ? static_cast<uint32_t>(remainingMs) : 0;
+
+  try {
+    report.priority = std::stof(std::string(text.substr(second + 1)));
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+  return report;
+}
+
+ReplyKey replyKey(const StatusReport& report, int64_t phaseEnd) {
+  // Arredonda para baixo também os negativos, para um quantum ter uma chave só.
+  const int64_t offset = report.clockOffsetMs;
+  const int64_t offsetQuantum = offset >= 0 ? offset / REPLY_CLOCK_QUANTUM_MS
+                                            : -((-offset + REPLY_CLOCK_QUANTUM_MS - 1) / REPLY_CLOCK_QUANTUM_MS);
+  ReplyKey key{};
+  uint8_t* pos = key.data();
+  auto put = [&pos](auto value) {
+    std::memcpy(pos, &value, sizeof(value));
+    pos += sizeof(value);
+  };
+  put(static_cast<uint8_t>(report.phase));
+  put(phaseEnd);
+  put(std::bit_cast<uint32_t>(report.priority));
+  put(report.queueLength);
+  put(static_cast<uint8_t>(report.clockErrorMs != CLOCK_UNSYNCED));
+  put(offsetQuantum);
+  return key;
+}
+
+bool appendAggregateEntry(std::vector<uint8_t>& segment, std::string_view suffix,
+                          const StatusReport& report, size_t maxSize) {
+  const size_t valueSize = 2 + suffix.size() + STATUS_WIRE_SIZE;
+  if (suffix.size() > MAX_LIGHT_SUFFIX_SIZE || segment.size() + 2 + valueSize > maxSize) {
+    return false;
+  }
+  segment.push_back(tlv::AggregateEntry);
+  segment.push_back(static_cast<uint8_t>(valueSize));
+  segment.push_back(tlv::LightSuffix);
+  segment.push_back(static_cast<uint8_t>(suffix.size()));
+  segment.insert(segment.end(), suffix.begin(), suffix.end());
+
+  StatusBuffer buffer;
+  size_t length = encode(report, buffer);
+  segment.insert(segment.end(), buffer.begin(), buffer.begin() + length);
+  return true;
+}
+
+bool decodeAggregate(std::span<const uint8_t> wire,
+                     std::vector<std::pair<std::string_view, StatusReport>>& entries) {
+  entries.clear();
+  size_t pos = 0;
+  while (pos < wire.size()) {
+    if (wire.size() - pos < 2 || wire[pos] != tlv::AggregateEntry ||
+        wire.size() - pos - 2 < wire[pos + 1]) {
+      return false;
+    }
+    auto entry = wire.subspan(pos + 2, wire[pos + 1]);
+    pos += 2 + wire[pos + 1];
+
+    if (entry.size() < 2 || entry[0] != tlv::LightSuffix || entry.size() - 2 < entry[1]) {
+      return false;
+    }
+    std::string_view suffix(reinterpret_cast<const char*>(entry.data() + 2), entry[1]);
+    auto report = decode(entry.subspan(2 + entry[1]));
+    if (!report) {
+      return false;
+    }
+    entries.emplace_back(suffix, *report);
+  }
+  return true;
+}
+
+void appendRegionSummary(std::vector<uint8_t>& segment, const RegionSummary& summary) {
+  uint8_t buffer[REGION_SUMMARY_WIRE_SIZE];
+  uint8_t* pos = buffer;
+  *pos++ = tlv::RegionSummary;
+  *pos++ = static_cast<uint8_t>(REGION_SUMMARY_WIRE_SIZE - 2);
+  pos = writeField<uint32_t>(pos, tlv::LightCount, summary.lightCount);
+  pos = writeField<uint32_t>(pos, tlv::AveragePriority, std::bit_cast<uint32_t>(summary.averagePriority));
+  segment.insert(segment.end(), buffer, pos);
+}
+
+bool decodeRegionSummary(std::span<const uint8_t> wire, RegionSummary& summary,
+                         std::vector<std::pair<std::string_view, StatusReport>>& entries) {
+  if (wire.size() < REGION_SUMMARY_WIRE_SIZE || wire[0] != tlv::RegionSummary ||
+      wire[1] != REGION_SUMMARY_WIRE_SIZE - 2) {
+    return false;
+  }
+  const uint8_t* pos = wire.data() + 2;
+  uint32_t priorityBits = 0;
+  if (!readField(pos, tlv::LightCount, summary.lightCount) ||
+      !readField(pos, tlv::AveragePriority, priorityBits)) {
+    return false;
+  }
+  summary.averagePriority = std::bit_cast<float>(priorityBits);
+  return decodeAggregate(wire.subspan(REGION_SUMMARY_WIRE_SIZE), entries);
+}
+
+size_t encodeTiming(const TimingReport& report, TimingBuffer& out) {
+  uint8_t* pos = out.data();
+  *pos++ = tlv::TimingPayload;
+  *pos++ = static_cast<uint8_t>(TIMING_VALUE_SIZE);
+  pos = writeField<uint8_t>(pos, tlv::RealTime, report.realTime ? 1 : 0);
+  pos = writeField<uint64_t>(pos, tlv::MaxLatenessUs, report.maxLatenessUs);
+  for (uint32_t count : report.buckets) {
+    pos = writeField<uint32_t>(pos, tlv::LatenessBucket, count);
+  }
+  return static_cast<size_t>(pos - out.data());
+}
+
+std::optional<TimingReport> decodeTiming(std::span<const uint8_t> wire) {
+  if (wire.size() < TIMING_WIRE_SIZE || wire[0] != tlv::TimingPayload || wire[1] != TIMING_VALUE_SIZE) {
+    return std::nullopt;
+  }
+  const uint8_t* pos = wire.data() + 2;
+  TimingReport report;
+  uint8_t realTime = 0;
+  if (!readField(pos, tlv::RealTime, realTime) || !readField(pos, tlv::MaxLatenessUs, report.maxLatenessUs)) {
+    return std::nullopt;
+  }
+  report.realTime = realTime != 0;
+  for (uint32_t& count : report.buckets) {
+    if (!readField(pos, tlv::LatenessBucket, count)) {
+      return std::nullopt;
+    }
+  }
+  return report;
+}
+
+} // namespace status
@@ -31,7 +31,7 @@ void YamlParser::parse(const YAML::Node& config) {
 
         TrafficLightState light;
         light.name = name;
-        light.state = state;
+        light.state = parseColor(state);
         light.cycle = cycleTime;
         light.columns = columns;
         light.lines = lines;
@@ -46,7 +46,7 @@ void YamlParser::parse(const YAML::Node& config) {
             duration = TA;
         }
 
-        light.endTime = std::chrono::steady_clock::now() + std::chrono::seconds(duration);
+        light.endTime = nowTicks() + duration * 1000;
 
         trafficLights.push_back({name, light});
     }
@@ -103,6 +103,165 @@ void YamlParser::parse(const YAML::Node& config) {
             syncGroups.push_back(sync);
         }
     }
+
+    if (config["aggregators"]) {
+        for (const auto& node : config["aggregators"]) {
+            AggregatorConfig aggregator;
+            aggregator.region = node["region"].as<std::string>();
+
+            const std::string prefix = aggregator.region + "/";
+            bool coversLight = std::any_of(trafficLights.begin(), trafficLights.end(), [&](const auto& light) {
+                return light.first.compare(0, prefix.size(), prefix) == 0;
+            });
+            if (!coversLight) {
+                throw std::runtime_error(
+                    "Erro de validação: A região do agregador '" + aggregator.region +
+                    "' não contém nenhum semáforo."
+                );
+            }
+
+            aggregators.push_back(aggregator);
+        }
+    }
+
+    if (config["regions"]) {
+        for (const auto& node : config["regions"]) {
+            RegionConfig region;
+            region.prefix = node["prefix"].as<std::string>();
+            if (std::none_of(trafficLights.begin(), trafficLights.end(),
+                             [&](const auto& light) { return region.covers(light.first); })) {
+                throw std::runtime_error(
+                    "Erro de validação: A região '" + region.prefix + "' não contém nenhum semáforo."
+                );
+            }
+            for (const auto& other : regions) {
+                if (other.prefix == region.prefix || other.covers(region.prefix) || region.covers(other.prefix)) {
+                    throw std::runtime_error(
+                        "Erro de validação: As regiões '" + other.prefix + "' e '" + region.prefix + "' se sobrepõem."
+                    );
+                }
+            }
+            regions.push_back(region);
+        }
+
+        // Um cruzamento é controlado por um único orquestrador.
+        for (const auto& [crossName, cross] : intersections) {
+            for (const auto& lightName : cross.trafficLightNames) {
+                if (getRegionIndexOf(lightName) != getRegionIndexOf(cross.trafficLightNames.front())) {
+                    throw std::runtime_error(
+                        "Erro de validação: O cruzamento '" + crossName + "' tem semáforos em regiões diferentes."
+                    );
+                }
+            }
+        }
+    }
+
+    if (config["protocol"]) {
+        const auto& node = config["protocol"];
+        if (node["status_encoding"]) {
+            std::string encoding = node["status_encoding"].as<std::string>();
+            if (encoding != "binary" && encoding != "text") {
+                throw std::runtime_error(
+                    "Erro de validação: 'protocol.status_encoding' deve ser 'binary' ou 'text', mas é '" + encoding + "'."
+                );
+            }
+            protocol.textStatus = (encoding == "text");
+        }
+        if (node["status_mode"]) {
+            std::string mode = node["status_mode"].as<std::string>();
+            if (mode != "poll" && mode != "push" && mode != "predict") {
+                throw std::runtime_error(
+                    "Erro de validação: 'protocol.status_mode' deve ser 'poll', 'push' ou 'predict', mas é '" + mode + "'."
+                );
+            }
+            protocol.statusMode = (mode == "push")    ? StatusMode::PUSH
+                                : (mode == "predict") ? StatusMode::PREDICT
+                                                      : StatusMode::POLL;
+        }
+        if (node["heartbeat_ms"]) {
+            protocol.heartbeatMs = node["heartbeat_ms"].as<int>();
+            if (protocol.heartbeatMs < 1000) {
+                throw std::runtime_error("Erro de validação: 'protocol.heartbeat_ms' deve ser pelo menos 1000.");
+            }
+        }
+        if (node["signing"]) {
+            std::string signing = node["signing"].as<std::string>();
+            if (signing == "asymmetric") {
+                protocol.signing = SigningMode::ASYMMETRIC;
+            } else if (signing == "hmac") {
+                protocol.signing = SigningMode::HMAC;
+            } else if (signing == "digest") {
+                protocol.signing = SigningMode::DIGEST;
+            } else {
+                throw std::runtime_error(
+                    "Erro de validação: 'protocol.signing' deve ser 'asymmetric', 'hmac' ou 'digest', mas é '" + signing + "'."
+                );
+            }
+        }
+        if (node["hmac_secret_file"]) {
+            protocol.hmacSecretFile = node["hmac_secret_file"].as<std::string>();
+        }
+        if (node["trust_schema"]) {
+            protocol.trustSchema = node["trust_schema"].as<std::string>();
+        }
+        if (node["priority_delta"]) {
+            protocol.priorityReportDelta = node["priority_delta"].as<float>();
+            if (protocol.priorityReportDelta <= 0.0f) {
+                throw std::runtime_error("Erro de validação: 'protocol.priority_delta' deve ser positivo.");
+            }
+        }
+        if (node["prediction_tolerance_ms"]) {
+            protocol.predictionToleranceMs = node["prediction_tolerance_ms"].as<int>();
+            if (protocol.predictionToleranceMs < 250) {
+                // Abaixo disso o erro da sincronia de relógios vira notificação.
+                throw std::runtime_error("Erro de validação: 'protocol.prediction_tolerance_ms' deve ser pelo menos 250.");
+            }
+        }
+    }
+
+    if (config["orchestrator"]) {
+        const auto& node = config["orchestrator"];
+        if (node["engine"]) {
+            std::string engine = node["engine"].as<std::string>();
+            if (engine != "event" && engine != "tick") {
+                throw std::runtime_error(
+                    "Erro de validação: 'orchestrator.engine' deve ser 'event' ou 'tick', mas é '" + engine + "'."
+                );
+            }
+            orchestrator.engine = (engine == "tick") ? EngineMode::TICK : EngineMode::EVENT;
+        }
+        if (node["workers"]) {
+            orchestrator.workers = node["workers"].as<int>();
+            if (orchestrator.workers < 0) {
+                throw std::runtime_error("Erro de validação: 'orchestrator.workers' não pode ser negativo.");
+            }
+        }
+        if (node["control"]) {
+            parseControl(node["control"], orchestrator.control);
+        }
+    }
+}
+
+void YamlParser::parseControl(const YAML::Node& node, ControlParams& params) {
+    auto readInt = [&node](const char* key, int& value, int minimum) {
+        if (!node[key]) return;
+        value = node[key].as<int>();
+        if (value < minimum) {
+            throw std::runtime_error("Erro de validação: 'orchestrator.control." + std::string(key) +
+                                     "' deve ser pelo menos " + std::to_string(minimum) + ".");
+        }
+    };
+    // O semáforo não troca de fase em menos de um tick de tráfego (1 s).
+    readInt("green_base_ms", params.greenBaseTimeMs, 1000);
+    readInt("recovery_red_ms", params.recoveryRedTimeMs, 1000);
+    readInt("adjustment_ms", params.adjustmentMs, 0);
+    readInt("max_adjustments", params.maxAdjustments, 0);
+    if (node["low_priority_wave_factor"]) {
+        params.lowPriorityWaveFactor = node["low_priority_wave_factor"].as<double>();
+        if (params.lowPriorityWaveFactor <= 0.0 || params.lowPriorityWaveFactor > 1.0) {
+            throw std::runtime_error("Erro de validação: 'orchestrator.control.low_priority_wave_factor' deve estar em (0, 1].");
+        }
+    }
 }
 
 
@@ -123,6 +282,31 @@ const std::vector<SyncGroup>& YamlParser::getSyncGroups() const {
     return syncGroups;
 }
 
+const std::vector<AggregatorConfig>& YamlParser::getAggregators() const {
+    return aggregators;
+}
+
+const std::vector<RegionConfig>& YamlParser::getRegions() const {
+    return regions;
+}
+
+int YamlParser::getRegionIndexOf(const std::string& lightName) const {
+    for (size_t i = 0; i < regions.size(); ++i) {
+        if (regions[i].covers(lightName)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const ProtocolOptions& YamlParser::getProtocolOptions() const {
+    return protocol;
+}
+
+const OrchestratorOptions& YamlParser::getOrchestratorOptions() const {
+    return orchestrator;
+}
+
 std::optional<TrafficLightState> YamlParser::getTrafficLightByIndex(int index) const {
     if (index < 0 || index >= static_cast<int>(trafficLights.size())) {
         return std::nullopt;
@@ -0,0 +1,215 @@
+#include "../include/LinkSigner.hpp"
+#include "../include/StatusCodec.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// Cache de respostas de estado do semáforo: o que entra na chave
+// (status::replyKey), quando SignedDataCache::find reaproveita um Data e a fração
+// das consultas de um semáforo simulado que ele atende. Sai com erro na primeira
+// verificação que falhar. Assina só com DigestSha256, num KeyChain em memória.
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FALHOU: %s\n", what);
+        failures++;
+    }
+}
+
+using Clock = SignedDataCache::Clock;
+
+status::StatusReport syncedReport() {
+    status::StatusReport report;
+    report.phase = Color::GREEN;
+    report.remainingMs = 12000;
+    report.priority = 3.5f;
+    report.queueLength = 7;
+    report.sequence = 41;
+    report.clockOffsetMs = 12;
+    report.clockErrorMs = 3;
+    return report;
+}
+
+std::shared_ptr<ndn::Data> signedData(ndn::KeyChain& keyChain, const ndn::Name& name, uint64_t sequence) {
+    status::StatusReport report = syncedReport();
+    report.sequence = sequence;
+    status::StatusBuffer buffer;
+    const size_t length = status::encode(report, buffer);
+    auto data = std::make_shared<ndn::Data>(name);
+    data->setContent(ndn::make_span(buffer.data(), length));
+    data->setFreshnessPeriod(ndn::time::seconds(1));
+    keyChain.sign(*data, ndn::security::signingWithSha256());
+    return data;
+}
+
+void testReplyKey() {
+    const int64_t phaseEnd = 90'000;
+    const status::StatusReport base = syncedReport();
+    const status::ReplyKey key = status::replyKey(base, phaseEnd);
+
+    // Campos que mudam a cada consulta não mudam a chave.
+    status::StatusReport report = base;
+    report.remainingMs = 11'750;
+    report.clockErrorMs = 9;
+    report.sequence = 42;
+    check(status::replyKey(report, phaseEnd) == key, "tempo restante, erro e sequência ficam fora da chave");
+
+    report = base;
+    report.clockOffsetMs = 14;
+    check(status::replyKey(report, phaseEnd) == key, "offset no mesmo quantum dá a mesma chave");
+    report.clockOffsetMs = 15;
+    check(status::replyKey(report, phaseEnd) != key, "offset em outro quantum muda a chave");
+
+    // Negativos arredondam para baixo: -1..-5 num quantum, -6 no seguinte.
+    report.clockOffsetMs = -1;
+    const status::ReplyKey negative = status::replyKey(report, phaseEnd);
+    report.clockOffsetMs = -5;
+    check(status::replyKey(report, phaseEnd) == negative, "-1 e -5 ms no mesmo quantum");
+    report.clockOffsetMs = -6;
+    check(status::replyKey(report, phaseEnd) != negative, "-6 ms em outro quantum");
+    report.clockOffsetMs = 0;
+    check(status::replyKey(report, phaseEnd) != negative, "0 e -1 ms em quanta diferentes");
+
+    report = base;
+    report.phase = Color::YELLOW;
+    check(status::replyKey(report, phaseEnd) != key, "fase entra na chave");
+    check(status::replyKey(base, phaseEnd + 1) != key, "fim da fase entra na chave");
+    report = base;
+    report.priority = 4.0f;
+    check(status::replyKey(report, phaseEnd) != key, "prioridade entra na chave");
+    report = base;
+    report.queueLength = 8;
+    check(status::replyKey(report, phaseEnd) != key, "fila entra na chave");
+    report = base;
+    report.clockErrorMs = status::CLOCK_UNSYNCED;
+    check(status::replyKey(report, phaseEnd) != key, "perder a sincronia muda a chave");
+}
+
+void testCacheFind(ndn::KeyChain& keyChain) {
+    const ndn::Name name("/ssa/r-test/s-test/1");
+    const ndn::Name other("/ssa/r-test/s-test/2");
+    const Clock::time_point t0{std::chrono::hours(1)};
+    const status::ReplyKey key = status::replyKey(syncedReport(), 90'000);
+    status::ReplyKey otherKey = key;
+    otherKey.back() ^= 1;
+
+    SignedDataCache cache(2);
+    check(!cache.find(name, key, t0), "cache vazio não atende");
+    auto data = signedData(keyChain, name, 1);
+    cache.insert(data, key, t0);
+    check(cache.find(name, key, t0 + std::chrono::milliseconds(999)) == data, "mesma chave dentro do frescor atende");
+    check(!cache.find(name, key, t0 + std::chrono::seconds(1)), "fim do frescor não atende");
+    check(!cache.find(name, otherKey, t0), "outra chave não atende");
+    check(!cache.find(other, key, t0), "outro nome não atende");
+
+    // Mesmo nome substitui a entrada, com a chave nova.
+    auto newer = signedData(keyChain, name, 2);
+    cache.insert(newer, otherKey, t0 + std::chrono::milliseconds(500));
+    check(cache.find(name, otherKey, t0 + std::chrono::milliseconds(600)) == newer, "entrada substituída atende a chave nova");
+    check(!cache.find(name, key, t0 + std::chrono::milliseconds(600)), "entrada substituída esquece a chave antiga");
+
+    // Cheio, descarta a entrada que expira primeiro.
+    cache.insert(signedData(keyChain, other, 1), key, t0 + std::chrono::milliseconds(700));
+    const ndn::Name third("/ssa/r-test/s-test/3");
+    cache.insert(signedData(keyChain, third, 1), key, t0 + std::chrono::milliseconds(800));
+    check(!cache.find(name, otherKey, t0 + std::chrono::milliseconds(900)), "cheio, sai a entrada que expira primeiro");
+    check(cache.find(other, key, t0 + std::chrono::milliseconds(900)) != nullptr, "cheio, fica a entrada mais nova");
+
+    check(cache.hits() == 3 && cache.misses() == 6, "contadores de acertos e faltas");
+}
+
+// Dez minutos de um semáforo de ciclo 60 s, em tempo simulado: fila que muda a
+// cada segundo de tráfego e consultas do orquestrador no ritmo do poll espaçado
+// (250 ms perto do fim da fase, 2 s no meio de uma fase longa, 1 s no resto) e do
+// agregador a cada 1 s. Cada consulta passa pela chave do semáforo, como em
+// SmartTrafficLight::onInterest. Retorna a fração atendida pelo cache.
+constexpr double MIN_REPLY_HIT_RATE = 0.3;
+
+double replyHitRate(ndn::KeyChain& keyChain) {
+    const int64_t durations[] = {27000, 3000, 30000};   // verde, amarelo, vermelho
+    const Color colors[] = {Color::GREEN, Color::YELLOW, Color::RED};
+    const ndn::Name name("/ssa/r-test/s-test/1");
+    const Clock::time_point epoch{};
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(1, 10);
+    SignedDataCache cache;
+    size_t phase = 0;
+    int64_t phaseEnd = durations[0], nextTick = 1000, orchestrator = 0, aggregator = 500;
+    int queue = 5, cycleVehicles = 0;
+    uint64_t sequence = 0;
+    for (;;) {
+        const int64_t t = std::min({phaseEnd, nextTick, orchestrator, aggregator});
+        if (t >= 600'000) {
+            break;
+        }
+        if (t == phaseEnd) {
+            phase = (phase + 1) % 3;
+            phaseEnd += durations[phase];
+            if (colors[phase] == Color::GREEN) cycleVehicles = 0;
+            continue;
+        }
+        if (t == nextTick) {
+            if (dist(rng) < 5 && queue < 30) {
+                queue++;
+                cycleVehicles++;
+            }
+            if (colors[phase] == Color::GREEN && dist(rng) <= 5) queue = std::max(queue - 2, 0);
+            nextTick += 1000;
+            continue;
+        }
+
+        status::StatusReport report;
+        report.phase = colors[phase];
+        report.remainingMs = static_cast<uint32_t>(phaseEnd - t);
+        report.priority = cycleVehicles * 0.5f + queue / 30.0f * 5;
+        report.queueLength = static_cast<uint16_t>(queue);
+        report.clockOffsetMs = 3;
+        report.clockErrorMs = 2;
+        report.phaseEnd = phaseEnd + report.clockOffsetMs;
+        const status::ReplyKey key = status::replyKey(report, phaseEnd);
+        const auto now = epoch + std::chrono::milliseconds(t);
+        if (!cache.find(name, key, now)) {
+            report.sequence = ++sequence;
+            status::StatusBuffer buffer;
+            const size_t length = status::encode(report, buffer);
+            auto data = std::make_shared<ndn::Data>(name);
+            data->setContent(ndn::make_span(buffer.data(), length));
+            data->setFreshnessPeriod(ndn::time::seconds(1));
+            keyChain.sign(*data, ndn::security::signingWithSha256());
+            cache.insert(data, key, now);
+        }
+
+        if (t == orchestrator) {
+            const int64_t remaining = phaseEnd - t;
+            orchestrator += remaining < 2000 ? 250 : remaining > 6000 ? 2000 : 1000;
+        } else {
+            aggregator += 1000;
+        }
+    }
+    return static_cast<double>(cache.hits()) / static_cast<double>(cache.hits() + cache.misses());
+}
+
+} // namespace
+
+int main() {
+    ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+
+    testReplyKey();
+    testCacheFind(keyChain);
+
+    const double hitRate = replyHitRate(keyChain);
+    std::printf("Cache de estado atendeu %.1f%% das consultas (mínimo %.0f%%).\n",
+                hitRate * 100, MIN_REPLY_HIT_RATE * 100);
+    check(hitRate >= MIN_REPLY_HIT_RATE, "fração das consultas atendida pelo cache");
+
+    return failures == 0 ? 0 : 1;
+}